@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/vertex_array.hpp>
+
+namespace gfx::core
+{
+	// 64 bit draw sort key, fields from the most significant bit down:
+	//
+	//   opaque:      pass:4 | layer:4 | 0 | shader:10 | material:12 | vertex array:9 | depth:24
+	//   translucent: pass:4 | layer:4 | 1 | far to near depth:24 | shader:10 | material:12 | vertex array:9
+	//
+	// Opaque draws are grouped by state and go front to back inside a group, translucent draws go back to front.
+	// Shader, material and vertex array ids are truncated to their field, depth is normalized to [0, 1].
+	class SortKey
+	{
+	public:
+		static constexpr uint32_t PASS_BITS = 4;
+		static constexpr uint32_t LAYER_BITS = 4;
+		static constexpr uint32_t SHADER_BITS = 10;
+		static constexpr uint32_t MATERIAL_BITS = 12;
+		static constexpr uint32_t VERTEX_ARRAY_BITS = 9;
+		static constexpr uint32_t DEPTH_BITS = 24;
+
+		static uint64_t opaque(uint32_t pass, uint32_t layer, uint32_t shader, uint32_t material, uint32_t vertex_array, float depth) noexcept;
+		static uint64_t translucent(uint32_t pass, uint32_t layer, uint32_t shader, uint32_t material, uint32_t vertex_array, float depth) noexcept;
+
+		static uint32_t pass(uint64_t key) noexcept;
+		static uint32_t layer(uint64_t key) noexcept;
+		static bool isTranslucent(uint64_t key) noexcept;
+
+		static uint32_t quantizeDepth(float depth) noexcept;
+	};
+
+	// Compact indexed draw, replayed through the GL wrappers by CommandBucket::submit().
+	struct DrawCommand
+	{
+		// Applies per draw uniforms from data pushed with CommandBucket::pushData()
+		using ApplyFunc = void (*)(const gl::ShaderProgram& program, const void* data);
+
+		const gl::ShaderProgram* program = nullptr;
+		const gl::VertexArray* vertex_array = nullptr;
+		GLenum mode = GL_TRIANGLES;
+		GLenum index_type = GL_UNSIGNED_INT;
+		uint32_t count = 0;
+		int32_t base_vertex = 0;
+		// In bytes into the element buffer of the vertex array
+		uint64_t index_offset = 0;
+		ApplyFunc apply = nullptr;
+		uint32_t data = 0;
+	};
+
+	// Draw commands recorded in any order, radix sorted by key and submitted in one loop.
+	//
+	// Submission binds only what changes between consecutive commands, enables blending and disables depth
+	// writes for translucent keys, and leaves depth writes enabled so the next clear reaches the depth buffer.
+	class CommandBucket
+	{
+	public:
+		struct Stats
+		{
+			size_t draws = 0;
+			size_t program_changes = 0;
+			size_t vertex_array_changes = 0;
+			size_t translucent_draws = 0;
+		};
+
+		explicit CommandBucket(size_t reserve = 1024);
+		CommandBucket(const CommandBucket&) = delete;
+		CommandBucket(CommandBucket&&) = default;
+
+		CommandBucket& operator=(const CommandBucket&) = delete;
+		CommandBucket& operator=(CommandBucket&&) = default;
+
+		// Recording
+		DrawCommand& add(uint64_t key);
+
+		template<typename T>
+		uint32_t pushData(const T& data)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "draw data must be trivially copyable");
+			static_assert(alignof(T) <= DATA_ALIGNMENT, "draw data is over aligned");
+
+			const auto offset = (uint32_t)m_data.size();
+			m_data.resize(offset + (sizeof(T) + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT);
+			std::memcpy(m_data.data() + offset, &data, sizeof(T));
+
+			return offset;
+		}
+
+		void clear() noexcept;
+
+		// Submission
+		void sort();
+		void submit();
+
+		// Getters
+		size_t size() const noexcept;
+		const Stats& stats() const noexcept;
+
+	private:
+		struct alignas(16) DataChunk
+		{
+			unsigned char bytes[16];
+		};
+
+		static constexpr size_t DATA_ALIGNMENT = sizeof(DataChunk);
+
+		struct Entry
+		{
+			uint64_t key;
+			uint32_t command;
+		};
+
+		std::vector<DrawCommand> m_commands;
+		std::vector<Entry> m_entries;
+		std::vector<Entry> m_scratch;
+		std::vector<DataChunk> m_data;
+		bool m_sorted = true;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <renderer/core/indirect_batch.hpp>
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/gl/vertex_array.hpp>
+
+namespace gfx::core
+{
+	// Frustum and occlusion culling of static objects in a compute pass.
+	//
+	// Objects are uploaded once with setObjects(). Every frame cull() tests their bounding spheres against the
+	// view frustum and against the depth pyramid built from the previous frame's depth by buildDepthPyramid(),
+	// and appends the survivors to an indirect command buffer and a draw data buffer with the layout of
+	// `Draw` in `shaders/indirect.vert`. draw() issues them with glMultiDrawElementsIndirectCount, so the CPU
+	// never reads visibility. Occlusion against the previous frame can let objects that just became visible pop
+	// in one frame late.
+	class GpuCulling
+	{
+	public:
+		// std430 layout of `Object` in `shaders/cull.comp`
+		struct Object
+		{
+			glm::mat4 model;
+			// xyz: center in model space, w: radius
+			glm::vec4 bounds;
+			glm::vec4 params;
+			uint32_t count;
+			uint32_t first_index;
+			int32_t base_vertex;
+			uint32_t padding = 0;
+		};
+
+		explicit GpuCulling(size_t max_objects);
+		GpuCulling(const GpuCulling&) = delete;
+		GpuCulling(GpuCulling&&) = delete;
+
+		GpuCulling& operator=(const GpuCulling&) = delete;
+		GpuCulling& operator=(GpuCulling&&) = delete;
+
+		~GpuCulling() = default;
+
+		// Objects
+		void setObjects(const std::vector<Object>& objects);
+
+		// Culling, the pyramid is built from a depth texture rendered with the last culled view projection
+		void cull(const glm::mat4& view_projection);
+		void draw(const gl::ShaderProgram& program, const gl::VertexArray& vertex_array, unsigned int storage_binding) const noexcept;
+		void buildDepthPyramid(const gl::Texture& depth, int width, int height);
+
+		void setOcclusionCulling(bool enabled) noexcept;
+
+		// Readback of the survivors of the last cull(), stalls until it finished
+		uint32_t readVisibleCount() const noexcept;
+		std::vector<IndirectBatch::DrawElementsIndirectCommand> readCommands() const;
+
+		// Getters
+		size_t objectCount() const noexcept;
+		size_t maxObjects() const noexcept;
+		bool occlusionCulling() const noexcept;
+		const gl::Texture& depthPyramid() const noexcept;
+
+	private:
+		struct DispatchCommand
+		{
+			uint32_t groups_x;
+			uint32_t groups_y;
+			uint32_t groups_z;
+			uint32_t object_count;
+		};
+
+		size_t m_maxObjects;
+		size_t m_objectCount = 0;
+
+		// Occlusion culling is a variant of the cull shader instead of a branch on a uniform
+		gl::ShaderProgram m_cullProgram;
+		gl::ShaderProgram m_occlusionCullProgram;
+		gl::ShaderProgram m_pyramidProgram;
+		gl::Uniform<glm::vec4> m_frustumPlanesUniform;
+		gl::Uniform<glm::vec4> m_occlusionFrustumPlanesUniform;
+		gl::Uniform<glm::mat4> m_previousViewProjectionUniform;
+		gl::Uniform<int> m_sourceLevelUniform;
+
+		gl::Buffer m_objects;
+		gl::Buffer m_dispatch;
+		gl::Buffer m_commands;
+		gl::Buffer m_draws;
+		gl::Buffer m_visibleCount;
+
+		gl::Texture m_pyramid;
+		int m_pyramidWidth = 0;
+		int m_pyramidHeight = 0;
+		int m_pyramidLevels = 0;
+		bool m_pyramidValid = false;
+
+		glm::mat4 m_viewProjection = glm::mat4(1.0f);
+		glm::mat4 m_pyramidViewProjection = glm::mat4(1.0f);
+		bool m_occlusionCulling = true;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include <renderer/core/upload_thread.hpp>
+#include <renderer/utility/file_watcher.hpp>
+
+namespace gfx::core
+{
+	// Reloads the loose resource files of the source tree while the application runs.
+	//
+	// The watcher reports written files from its own thread and update() hands them to the registered handlers
+	// once per frame on the render thread. Shaders are preprocessed as a whole set on the upload thread, with
+	// the slots of the embedded build reserved first so names keep the slots of the generated headers, and
+	// shader handlers get the processed sources. Handlers re-import their files through the upload thread as well, so new objects
+	// replace the live ones in UploadThread::poll() between frames. Anything that fails to load is reported
+	// through error() and the previous version stays in use.
+	class HotReload
+	{
+	public:
+		// Processed sources by resource name, e.g. "shaders/pbr.frag"
+		using ShaderSources = tsl::robin_map<std::string, std::string>;
+		using ShaderHandler = std::function<void(const ShaderSources&)>;
+		using FileHandler = std::function<void(const std::filesystem::path&)>;
+
+		// Source of the errors of preprocessing and compiling shaders
+		static constexpr const char* SHADER_SOURCE = "shaders";
+
+		// `resources` is the directory the embedded resources were built from
+		HotReload(std::filesystem::path resources, UploadThread& uploads);
+		HotReload(const HotReload&) = delete;
+		HotReload(HotReload&&) = delete;
+
+		HotReload& operator=(const HotReload&) = delete;
+		HotReload& operator=(HotReload&&) = delete;
+
+		void onShaders(ShaderHandler handler);
+
+		// `resource` is relative to the resource directory, e.g. "models/cow.obj"
+		void onFile(const std::string& resource, FileHandler handler);
+
+		// Render thread, once per frame
+		void update();
+
+		// Handlers report their failures per source, e.g. SHADER_SOURCE or a model path. An empty error clears
+		// the previous one of that source only.
+		void report(const std::string& source, std::string error);
+
+		// Getters, the error lists every source that failed, one per line
+		bool enabled() const noexcept;
+		const std::string& error() const noexcept;
+
+	private:
+		void processShaders();
+
+		util::FileWatcher m_watcher;
+		std::filesystem::path m_resources;
+		UploadThread* m_uploads;
+
+		std::vector<ShaderHandler> m_shaderHandlers;
+		tsl::robin_map<std::string, FileHandler> m_fileHandlers;
+
+		// Shaders changed again while a previous set was processed
+		bool m_processing = false;
+		bool m_shadersChanged = false;
+
+		// Errors by source in the order they first failed, joined into m_error
+		std::vector<std::pair<std::string, std::string>> m_errors;
+		std::string m_error;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <renderer/gl/types.hpp>
+
+namespace gfx::core
+{
+	struct Image
+	{
+		// stb_image allocates with malloc, converted images follow the same convention.
+		struct PixelDeleter
+		{
+			void operator()(unsigned char* pixels) const noexcept;
+		};
+
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+
+		// eUnsignedByte, eUnsignedShort for 16-bit sources or eFloat for HDR sources
+		gl::Type type = gl::Type::eUnsignedByte;
+		std::unique_ptr<unsigned char[], PixelDeleter> pixels;
+
+		// Keeps a decode memory reservation alive for as long as the pixels are, see ImageDecoder.
+		std::shared_ptr<void> reservation;
+
+		size_t componentSize() const noexcept;
+		size_t size() const noexcept;
+		bool empty() const noexcept;
+	};
+
+#ifdef RENDERER_RC_ENABLED
+	Image imageFromResource(const std::string& path, int desired_channels = 0);
+#endif
+
+	Image imageFromMemory(const unsigned char* data, size_t size, int desired_channels = 0);
+
+	// Decoded footprint of an encoded image, read from its header only. Returns 0 if the header is invalid.
+	size_t imageDecodedSize(const unsigned char* data, size_t size, int desired_channels = 0) noexcept;
+}
\ No newline at end of file
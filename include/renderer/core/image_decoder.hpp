@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <renderer/core/image.hpp>
+#include <renderer/utility/thread_pool.hpp>
+
+namespace gfx::core
+{
+	// Decodes images on a thread pool while bounding the memory held by decoded images.
+	//
+	// Each decode reserves its decoded size, read from the image header, before it is handed to a worker.
+	// The reservation travels with the resulting Image and is returned when the image is destroyed, so
+	// consumers that are slow to upload throttle further decoding. Requests are admitted in order, and an
+	// image larger than the whole budget is still decoded once nothing else is in flight.
+	class ImageDecoder
+	{
+	public:
+		// Invoked on a worker thread, with either a decoded image or the decoding error.
+		using Callback = std::function<void(Image image, std::exception_ptr error)>;
+
+		ImageDecoder(util::ThreadPool& pool, size_t memory_budget);
+		ImageDecoder(const ImageDecoder&) = delete;
+		ImageDecoder(ImageDecoder&&) = delete;
+
+		ImageDecoder& operator=(const ImageDecoder&) = delete;
+		ImageDecoder& operator=(ImageDecoder&&) = delete;
+
+		// Requests that have not started are dropped, their futures report a broken promise.
+		~ImageDecoder();
+
+		// Borrowed encoded data must stay alive until the decode completes.
+		std::future<Image> decode(const unsigned char* data, size_t size, int desired_channels = 0);
+		std::future<Image> decode(std::vector<unsigned char> data, int desired_channels = 0);
+		void decode(const unsigned char* data, size_t size, Callback callback, int desired_channels = 0);
+		void decode(std::vector<unsigned char> data, Callback callback, int desired_channels = 0);
+
+#ifdef RENDERER_RC_ENABLED
+		std::future<Image> decodeResource(const std::string& path, int desired_channels = 0);
+		void decodeResource(const std::string& path, Callback callback, int desired_channels = 0);
+#endif
+
+		// Getters
+		size_t memoryBudget() const noexcept;
+		size_t memoryInFlight() const;
+		size_t queuedCount() const;
+
+	private:
+		struct Job
+		{
+			const unsigned char* data;
+			size_t size;
+			std::vector<unsigned char> owned;
+			int desired_channels;
+			size_t reservation;
+			Callback callback;
+		};
+
+		struct State : std::enable_shared_from_this<State>
+		{
+			mutable std::mutex mutex;
+			util::ThreadPool* pool;
+			size_t budget;
+			size_t in_flight = 0;
+			std::deque<Job> queued;
+
+			void dispatch();
+			void release(size_t bytes);
+			void run(Job& job);
+		};
+
+		static Callback promiseCallback(std::shared_ptr<std::promise<Image>> promise);
+		void enqueue(Job job);
+
+		std::shared_ptr<State> m_state;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include <renderer/gl/ring_buffer.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/vertex_array.hpp>
+
+namespace gfx::core
+{
+	// Indexed triangle draws grouped by program and vertex array, each group issued as one
+	// glMultiDrawElementsIndirect.
+	//
+	// Every draw carries a fixed size block of per draw data. At submission the commands and data of a group are
+	// written into the ring buffer, and the data is bound as the shader storage block at `storage_binding`, so
+	// the shader reads its draw with `draws[gl_DrawID]`. The draw data size must match the std430 array stride
+	// of that block. Draws keep the order they were added in within a group.
+	class IndirectBatch
+	{
+	public:
+		struct DrawElementsIndirectCommand
+		{
+			uint32_t count;
+			uint32_t instance_count;
+			uint32_t first_index;
+			int32_t base_vertex;
+			uint32_t base_instance;
+		};
+
+		struct Stats
+		{
+			size_t draws = 0;
+			size_t batches = 0;
+		};
+
+		explicit IndirectBatch(size_t draw_data_size);
+		IndirectBatch(const IndirectBatch&) = delete;
+		IndirectBatch(IndirectBatch&&) = default;
+
+		IndirectBatch& operator=(const IndirectBatch&) = delete;
+		IndirectBatch& operator=(IndirectBatch&&) = default;
+
+		// Recording, `first_index` counts unsigned int indices
+		void add(const gl::ShaderProgram& program, const gl::VertexArray& vertex_array, uint32_t count, uint32_t first_index, int32_t base_vertex, const void* draw_data);
+
+		template<typename T>
+		void add(const gl::ShaderProgram& program, const gl::VertexArray& vertex_array, uint32_t count, uint32_t first_index, int32_t base_vertex, const T& draw_data)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "draw data must be trivially copyable");
+			add(program, vertex_array, count, first_index, base_vertex, (const void*)&draw_data);
+		}
+
+		void clear() noexcept;
+
+		// Submission, throws when the ring buffer region of the frame is exhausted
+		void submit(gl::RingBuffer& ring, unsigned int storage_binding);
+
+		// Getters
+		size_t drawDataSize() const noexcept;
+		size_t size() const noexcept;
+		const Stats& stats() const noexcept;
+
+	private:
+		struct Group
+		{
+			const gl::ShaderProgram* program;
+			const gl::VertexArray* vertex_array;
+			std::vector<DrawElementsIndirectCommand> commands;
+			std::vector<unsigned char> data;
+		};
+
+		size_t m_drawDataSize;
+		std::vector<Group> m_groups;
+		tsl::robin_map<uint64_t, size_t> m_groupIndices;
+		size_t m_size = 0;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <renderer/gl/ring_buffer.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/vertex_array.hpp>
+#include <renderer/shaders/indirect_vert.hpp>
+
+namespace gfx::core
+{
+	// Per instance vertex data, the model matrix takes four attributes and the parameters one, at the
+	// locations the instancing variant of shaders/indirect.vert declares
+	struct Instance
+	{
+		static constexpr unsigned int MODEL_ATTRIBUTE = shaders::indirect_vert::attributes::InstanceModel.location;
+		static constexpr unsigned int PARAMS_ATTRIBUTE = shaders::indirect_vert::attributes::InstanceParams.location;
+		static constexpr unsigned int ATTRIBUTE_COUNT = 5;
+
+		static_assert(shaders::indirect_vert::attributes::InstanceModel.count + shaders::indirect_vert::attributes::InstanceParams.count == ATTRIBUTE_COUNT);
+
+		glm::mat4 model;
+		glm::vec4 params;
+
+		// Formats the attributes on `binding_index` and advances that binding once per instance
+		static void enableAttributes(gl::VertexArray& vertex_array, unsigned int binding_index) noexcept;
+	};
+
+	// Meshes drawn with an array of instances each, one glDrawElementsInstancedBaseVertexBaseInstance per mesh.
+	//
+	// At submission the instances of every mesh are written back to back into the ring buffer, which is bound
+	// once as the instance vertex buffer, and each draw selects its range with its base instance. The vertex
+	// array must have its instance attributes enabled with Instance::enableAttributes().
+	class InstanceBatch
+	{
+	public:
+		struct Stats
+		{
+			size_t draws = 0;
+			size_t instances = 0;
+		};
+
+		InstanceBatch(gl::VertexArray& vertex_array, unsigned int binding_index);
+		InstanceBatch(const InstanceBatch&) = delete;
+		InstanceBatch(InstanceBatch&&) = default;
+
+		InstanceBatch& operator=(const InstanceBatch&) = delete;
+		InstanceBatch& operator=(InstanceBatch&&) = delete;
+
+		// Recording, `first_index` counts unsigned int indices
+		void add(uint32_t count, uint32_t first_index, int32_t base_vertex, const Instance* instances, size_t instance_count);
+		void add(uint32_t count, uint32_t first_index, int32_t base_vertex, const std::vector<Instance>& instances);
+		void clear() noexcept;
+
+		// Submission, throws when the ring buffer region of the frame is exhausted
+		void submit(gl::RingBuffer& ring, const gl::ShaderProgram& program);
+
+		// Getters
+		size_t size() const noexcept;
+		const Stats& stats() const noexcept;
+
+	private:
+		struct Mesh
+		{
+			uint32_t count;
+			uint32_t first_index;
+			int32_t base_vertex;
+			uint32_t base_instance;
+			uint32_t instance_count;
+		};
+
+		gl::VertexArray& m_vertexArray;
+		unsigned int m_bindingIndex;
+
+		std::vector<Mesh> m_meshes;
+		std::vector<Instance> m_instances;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/gl/types.hpp>
+
+namespace gfx::core
+{
+	// Texture slots of every material in one shader storage buffer, indexed by material ID.
+	//
+	// With ARB_bindless_texture every slot holds a resident texture handle, so switching materials only changes
+	// the MaterialID uniform and no texture units are bound per draw. Without it textures are copied into the
+	// layers of a texture array and the slots hold layer indices, which requires every texture to match the
+	// array size and format. `shaders/material.frag` samples both layouts.
+	//
+	// With bindless handles textures must outlive the materials referencing them and must be set again after
+	// they are reallocated. Array layers are snapshots taken by setTexture(), one per slot, so later changes to
+	// a texture only show once it is set again.
+	class MaterialTable
+	{
+	public:
+		using MaterialId = uint32_t;
+
+		struct Settings
+		{
+			int textures_per_material = 4;
+
+			// Use bindless handles when the extension is available
+			bool bindless = true;
+
+			// Texture array layout used without bindless handles
+			int array_width = 1024;
+			int array_height = 1024;
+			int array_layers = 64;
+			gl::DataFormat array_format = gl::DataFormat::eRGBA8;
+		};
+
+		MaterialTable(const Settings& settings);
+		MaterialTable(const MaterialTable&) = delete;
+		MaterialTable(MaterialTable&&) = delete;
+
+		MaterialTable& operator=(const MaterialTable&) = delete;
+		MaterialTable& operator=(MaterialTable&&) = delete;
+
+		~MaterialTable() noexcept;
+
+		// Materials, setTexture() throws std::out_of_range for a material that is not in use or a slot out of
+		// range, release() and clearTexture() ignore them
+		MaterialId create();
+		void release(MaterialId material) noexcept;
+		void setTexture(MaterialId material, int slot, const gl::Texture& texture);
+		void clearTexture(MaterialId material, int slot) noexcept;
+
+		// Uploads the slots changed since the last flush, call before drawing
+		void flush();
+
+		// Bindings
+		void bind(unsigned int storage_binding, int array_unit) const noexcept;
+		void applyUniforms(const gl::ShaderProgram& program, int array_unit) const noexcept;
+
+		// Getters
+		bool bindless() const noexcept;
+		size_t materialCount() const noexcept;
+		const gl::Buffer& buffer() const noexcept;
+
+	private:
+		bool valid(MaterialId material, int slot) const noexcept;
+		size_t slotIndex(MaterialId material, int slot) const noexcept;
+		void markDirty(size_t index) noexcept;
+
+		Settings m_settings;
+		bool m_bindless;
+
+		// Two words per slot, a texture handle or the array layer + 1, zero for an empty slot
+		std::vector<uint32_t> m_entries;
+
+		// Residency or layer key per slot, the handle or the array layer + 1
+		std::vector<uint64_t> m_keys;
+		std::vector<bool> m_used;
+		std::vector<MaterialId> m_freeMaterials;
+
+		tsl::robin_map<uint64_t, size_t> m_residentHandles;
+		std::vector<int> m_freeLayers;
+		gl::Texture m_array;
+
+		gl::Buffer m_buffer;
+		size_t m_capacity = 0;
+		size_t m_dirtyBegin = SIZE_MAX;
+		size_t m_dirtyEnd = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+
+#include <tsl/robin_map.h>
+
+#include <renderer/gl/shader_pipeline.hpp>
+#include <renderer/gl/shader_program.hpp>
+
+namespace gfx::core
+{
+	// Program pipelines keyed by the separable program of each stage.
+	//
+	// Combining the same stage programs again returns the existing pipeline, so switching between variants
+	// never creates GL objects after the first frame that used a combination. Pipelines keep raw pointers to
+	// their programs, forget() a program before destroying it so no pipeline outlives it and a recycled
+	// program name cannot match a stale key.
+	class PipelineCache
+	{
+	public:
+		PipelineCache() = default;
+		PipelineCache(const PipelineCache&) = delete;
+		PipelineCache(PipelineCache&&) = default;
+
+		PipelineCache& operator=(const PipelineCache&) = delete;
+		PipelineCache& operator=(PipelineCache&&) = default;
+
+		// Null programs are skipped, a later program replaces the stages it shares with an earlier one.
+		// The reference is stable until the pipeline is forgotten.
+		const gl::ShaderPipeline& pipeline(std::initializer_list<const gl::ShaderProgram*> programs);
+
+		void forget(const gl::ShaderProgram& program);
+		void clear() noexcept;
+
+		// Getters
+		size_t size() const noexcept;
+
+	private:
+		using Key = std::array<unsigned int, gl::ShaderPipeline::STAGE_COUNT>;
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const noexcept;
+		};
+
+		tsl::robin_map<Key, std::unique_ptr<gl::ShaderPipeline>, KeyHash> m_pipelines;
+	};
+}
\ No newline at end of file
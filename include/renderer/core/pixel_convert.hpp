@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace gfx::core
+{
+	// Pixel conversion kernels used to bring decoded images into the format the driver uploads natively.
+	//
+	// Counts are in pixels unless stated otherwise. SSE2/SSSE3/F16C paths are selected at runtime on x86,
+	// other targets use the scalar paths. Unless noted, source and destination must not overlap.
+
+	// Expansion of 1 to 4 channel images to RGBA, grey channels are replicated and missing alpha is opaque.
+	void expandToRGBA8(const uint8_t* src, int channels, uint8_t* dst, size_t count) noexcept;
+	void expandToRGBA16(const uint16_t* src, int channels, uint16_t* dst, size_t count) noexcept;
+	void expandToRGBAF(const float* src, int channels, float* dst, size_t count) noexcept;
+
+	// dst[i] = src[order[i]] per pixel, src and dst may be the same buffer.
+	void swizzleRGBA8(const uint8_t* src, uint8_t* dst, size_t count, const std::array<uint8_t, 4>& order) noexcept;
+
+	// In place alpha premultiplication, the sRGB variant multiplies in linear space.
+	void premultiplyRGBA8(uint8_t* pixels, size_t count) noexcept;
+	void premultiplySRGBA8(uint8_t* pixels, size_t count) noexcept;
+	void premultiplyRGBA16(uint16_t* pixels, size_t count) noexcept;
+	void premultiplyRGBAF(float* pixels, size_t count) noexcept;
+
+	// sRGB transfer function, the last channel of 2 and 4 channel pixels is alpha and stays linear.
+	void srgb8ToLinearF(const uint8_t* src, float* dst, size_t count, int channels) noexcept;
+	void linearFToSRGB8(const float* src, uint8_t* dst, size_t count, int channels) noexcept;
+
+	// IEEE half conversion with round to nearest even, count is in components.
+	void floatToHalf(const float* src, uint16_t* dst, size_t count) noexcept;
+}
\ No newline at end of file
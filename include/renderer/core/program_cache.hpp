@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <renderer/gl/shader.hpp>
+#include <renderer/gl/shader_program.hpp>
+
+namespace gfx::core
+{
+	// Links programs from source and keeps their binaries on disk, so later runs skip compilation.
+	//
+	// Entries are keyed by a hash of the sources and the driver vendor, renderer and version, so an edited
+	// shader or an updated driver misses instead of loading a stale binary. A binary the driver rejects anyway
+	// is compiled from source and replaced. Entries of another driver or cache version are deleted when the
+	// cache opens, and the least recently used ones go once the directory grows past its size limit. Failing
+	// to read or write the cache is never an error.
+	class ProgramCache
+	{
+	public:
+		struct Source
+		{
+			gl::Shader::Target target;
+			std::string code;
+		};
+
+		struct Stats
+		{
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t rejected = 0;
+		};
+
+		static constexpr size_t DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+		// Requires a current context, the cache is disabled when the driver has no binary formats
+		explicit ProgramCache(std::filesystem::path directory, size_t max_size = DEFAULT_MAX_SIZE);
+		ProgramCache(const ProgramCache&) = delete;
+		ProgramCache(ProgramCache&&) = default;
+
+		ProgramCache& operator=(const ProgramCache&) = delete;
+		ProgramCache& operator=(ProgramCache&&) = default;
+
+		// Compile and link errors throw like they do without the cache. Separable programs are entries of their
+		// own, so the same sources can be cached both ways.
+		gl::ShaderProgram link(const std::vector<Source>& sources, bool separable = false);
+
+		// The halves of link() for programs linked elsewhere, store() needs eBinaryRetrievable set before linking
+		std::optional<gl::ShaderProgram> find(const std::vector<Source>& sources, bool separable = false);
+		void store(const std::vector<Source>& sources, const gl::ShaderProgram& program, bool separable = false) const;
+
+		// Getters
+		bool enabled() const noexcept;
+		const Stats& stats() const noexcept;
+		const std::filesystem::path& directory() const noexcept;
+
+	private:
+		uint64_t key(const std::vector<Source>& sources, bool separable) const noexcept;
+		std::filesystem::path entryPath(uint64_t key) const;
+		std::optional<gl::ShaderProgram::Binary> readEntry(uint64_t key) const;
+		void writeEntry(uint64_t key, const gl::ShaderProgram::Binary& binary) const;
+
+		// Deletes stale entries and the least recently used ones beyond the size limit
+		void trim() const;
+
+		std::filesystem::path m_directory;
+		std::string m_driver;
+		uint64_t m_driverHash = 0;
+		size_t m_maxSize;
+		bool m_enabled = false;
+		Stats m_stats;
+
+		// Bytes in the directory as of the last trim() and the entries written since
+		mutable size_t m_size = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <renderer/core/program_cache.hpp>
+#include <renderer/gl/shader.hpp>
+#include <renderer/gl/shader_program.hpp>
+
+namespace gfx::core
+{
+	// Compiles and links programs without waiting on the driver.
+	//
+	// submit() hands every shader of a program to the driver at once and returns a handle. With
+	// KHR_parallel_shader_compile the driver compiles on its own threads and poll() advances programs whose
+	// completion status says they are done, so no status or log query ever blocks the frame. Logs are only read
+	// for failures. Without the extension the work happens when poll() first checks the program. Until a
+	// program is ready, program() returns null and the caller draws with a generic fallback.
+	class ShaderCompiler
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+		enum class Status
+		{
+			eCompiling,
+			eLinking,
+			eReady,
+			eFailed,
+			eReleased
+		};
+
+		struct Stats
+		{
+			size_t pending = 0;
+			size_t ready = 0;
+			size_t failed = 0;
+		};
+
+		// Programs found in `cache` are ready right away and linked ones are stored in it
+		explicit ShaderCompiler(ProgramCache* cache = nullptr);
+		ShaderCompiler(const ShaderCompiler&) = delete;
+		ShaderCompiler(ShaderCompiler&&) = default;
+
+		ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+		ShaderCompiler& operator=(ShaderCompiler&&) = default;
+
+		// Separable programs can be combined with others in a gl::ShaderPipeline
+		Handle submit(std::vector<ProgramCache::Source> sources, bool separable = false);
+
+		// Advances pending programs without blocking, call once per frame
+		void poll();
+
+		// Blocks until every submitted program is ready or failed
+		void finish();
+
+		// Destroys a program, e.g. one replaced by a reload. Pending programs are destroyed once they finish.
+		// The handle must not be used afterwards, it is given to a later submit().
+		void release(Handle handle);
+
+		// Getters, the program address is stable once it is ready
+		Status status(Handle handle) const noexcept;
+		const gl::ShaderProgram* program(Handle handle) const noexcept;
+		const std::string& error(Handle handle) const noexcept;
+		const Stats& stats() const noexcept;
+		bool parallel() const noexcept;
+
+	private:
+		struct Job
+		{
+			std::vector<ProgramCache::Source> sources;
+			std::vector<gl::Shader> shaders;
+			gl::ShaderProgram program;
+			Status status = Status::eCompiling;
+			bool separable = false;
+			bool released = false;
+			std::string error;
+		};
+
+		// Returns true once the job is ready or failed
+		bool advance(Job& job, bool wait);
+		void fail(Job& job, std::string error);
+		void destroy(Handle handle) noexcept;
+
+		ProgramCache* m_cache;
+		std::vector<std::unique_ptr<Job>> m_jobs;
+		std::vector<Handle> m_freeHandles;
+		std::vector<Handle> m_pending;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace gfx::core
+{
+	// Compile time feature flags of a shader variant, each set flag defines FEATURE_<NAME> in every stage.
+	// Shaders select code with #ifdef instead of branching on uniforms, so a variant only runs what it needs.
+	enum class ShaderFeatures : uint32_t
+	{
+		eNone = 0,
+		eInstancing = 1 << 0,
+		eAlphaTest = 1 << 1,
+		eNormalMapping = 1 << 2,
+		eSkinning = 1 << 3,
+		eOcclusionCulling = 1 << 4
+	};
+
+	inline constexpr uint32_t SHADER_FEATURE_COUNT = 5;
+
+	// Lower case name used in manifests, e.g. "alpha_test", null for anything but a single flag
+	const char* featureName(ShaderFeatures feature) noexcept;
+	std::optional<ShaderFeatures> featureFromName(std::string_view name) noexcept;
+
+	// Inserts the defines right after #version, followed by a #line directive so compiler messages keep the
+	// line numbers of the source
+	std::string injectFeatures(std::string_view source, ShaderFeatures features);
+
+	inline ShaderFeatures operator|(ShaderFeatures lhs, ShaderFeatures rhs)
+	{
+		return (ShaderFeatures)((uint32_t)lhs | (uint32_t)rhs);
+	}
+
+	inline ShaderFeatures operator|=(ShaderFeatures& lhs, ShaderFeatures rhs)
+	{
+		lhs = (ShaderFeatures)((uint32_t)lhs | (uint32_t)rhs);
+		return lhs;
+	}
+
+	inline ShaderFeatures operator&(ShaderFeatures lhs, ShaderFeatures rhs)
+	{
+		return (ShaderFeatures)((uint32_t)lhs & (uint32_t)rhs);
+	}
+
+	inline ShaderFeatures operator&=(ShaderFeatures& lhs, ShaderFeatures rhs)
+	{
+		lhs = (ShaderFeatures)((uint32_t)lhs & (uint32_t)rhs);
+		return lhs;
+	}
+}
\ No newline at end of file
@@ -3,14 +3,17 @@
 #include <iostream>
 #include <string>
 
+#include <renderer/core/shader_features.hpp>
 #include <renderer/gl/shader.hpp>
 
 namespace gfx::core
 {
+	// Features select the variant, see injectFeatures()
 #ifdef RENDERER_RC_ENABLED
-	gfx::gl::Shader shaderFromResource(gfx::gl::Shader::Target target, const std::string& filepath);
+	gfx::gl::Shader shaderFromResource(gfx::gl::Shader::Target target, const std::string& filepath, ShaderFeatures features = ShaderFeatures::eNone);
+	std::string sourceFromResource(const std::string& filepath, ShaderFeatures features = ShaderFeatures::eNone);
 #endif
 
-	gfx::gl::Shader shaderFromFile(gfx::gl::Shader::Target target, const std::string& filepath);
-	gfx::gl::Shader shaderFromStream(gfx::gl::Shader::Target target, std::istream& is);
+	gfx::gl::Shader shaderFromFile(gfx::gl::Shader::Target target, const std::string& filepath, ShaderFeatures features = ShaderFeatures::eNone);
+	gfx::gl::Shader shaderFromStream(gfx::gl::Shader::Target target, std::istream& is, ShaderFeatures features = ShaderFeatures::eNone);
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include <renderer/core/program_cache.hpp>
+#include <renderer/core/shader_compiler.hpp>
+#include <renderer/core/shader_features.hpp>
+#include <renderer/gl/shader_program.hpp>
+
+namespace gfx::core
+{
+	// Feature permutations of registered programs, compiled on first use and cached by a 64 bit key of the
+	// program id and its feature mask.
+	//
+	// Variants go through the ShaderCompiler, so requesting a new one never blocks and program() stays null
+	// until it is ready. Features a program does not support are masked out of the key, so they share a
+	// variant instead of compiling duplicates. prewarm() submits the variants listed in a manifest up front.
+	class ShaderVariants
+	{
+	public:
+		using Id = uint32_t;
+
+		explicit ShaderVariants(ShaderCompiler& compiler) noexcept;
+		ShaderVariants(const ShaderVariants&) = delete;
+		ShaderVariants(ShaderVariants&&) = default;
+
+		ShaderVariants& operator=(const ShaderVariants&) = delete;
+		ShaderVariants& operator=(ShaderVariants&&) = delete;
+
+		// Names are used by manifests, `sources` are the stages without any feature defines. Variants of separable
+		// programs, e.g. a single stage, are combined with other stages through a PipelineCache.
+		Id add(std::string name, std::vector<ProgramCache::Source> sources, ShaderFeatures supported, bool separable = false);
+
+		// Submits the variant if it is new, program() is null until it compiled
+		ShaderCompiler::Handle request(Id id, ShaderFeatures features);
+		const gl::ShaderProgram* program(Id id, ShaderFeatures features);
+
+		// Replaces the sources and recompiles every variant requested so far. The previous variants stay in use
+		// until update() finds the new ones ready, failed ones keep the previous version.
+		void reload(Id id, std::vector<ProgramCache::Source> sources);
+
+		// Swaps in reloaded variants, call once per frame after ShaderCompiler::poll() and before drawing.
+		// Returns the errors of variants that failed their first compile and of reloads that failed.
+		std::vector<std::string> update();
+
+		// One variant per line, "<program> [feature...]" with the names of featureName(), # starts a comment.
+		// Throws std::invalid_argument for unknown programs or features, returns the number of variants.
+		size_t prewarm(std::istream& manifest);
+
+		// Getters
+		size_t variantCount() const noexcept;
+
+	private:
+		struct Program
+		{
+			std::string name;
+			std::vector<ProgramCache::Source> sources;
+			ShaderFeatures supported;
+			bool separable;
+		};
+
+		struct Reload
+		{
+			uint64_t key;
+			ShaderCompiler::Handle handle;
+
+			// Superseded by a newer reload, released without replacing the variant
+			bool stale;
+		};
+
+		ShaderCompiler::Handle submit(const Program& program, ShaderFeatures features);
+		std::string describe(uint64_t key) const;
+
+		ShaderCompiler* m_compiler;
+		std::vector<Program> m_programs;
+		tsl::robin_map<uint64_t, ShaderCompiler::Handle> m_variants;
+		std::vector<Reload> m_reloads;
+
+		// Variants submitted by request() and not yet ready or failed
+		std::vector<uint64_t> m_compiling;
+	};
+}
\ No newline at end of file
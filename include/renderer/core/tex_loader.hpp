@@ -2,11 +2,24 @@
 
 #include <string>
 
+#include <renderer/core/image.hpp>
 #include <renderer/gl/texture.hpp>
 
 namespace gfx::core
 {
+	struct TextureImportOptions
+	{
+		// Color data is sRGB encoded, 1 and 2 channel images are expanded to RGBA since there is no sRGB red format.
+		// Only applies to 8 bit images, 16 bit and float images have no sRGB formats and are uploaded as linear.
+		bool srgb = false;
+
+		// Premultiply color by alpha before upload, 2 channel images are treated as grey and alpha.
+		bool premultiply_alpha = false;
+	};
+
 #ifdef RENDERER_RC_ENABLED
-	gfx::gl::Texture texture2DFromResource(const std::string& path);
+	gfx::gl::Texture texture2DFromResource(const std::string& path, const TextureImportOptions& options = {});
 #endif
+
+	gfx::gl::Texture texture2DFromImage(const Image& image, const TextureImportOptions& options = {});
 }
\ No newline at end of file
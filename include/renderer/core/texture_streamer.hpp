@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <renderer/core/image.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/gl/types.hpp>
+#include <renderer/utility/thread_pool.hpp>
+
+namespace gfx::core
+{
+	// Streams the mip levels of 2D textures in and out under a global VRAM budget.
+	//
+	// Every frame the views are registered with addView() and every drawn object reports the texture it uses
+	// with requestUsage(), which estimates the finest level needed from the projected size of its bounding
+	// sphere and its UV density. update() then fits the wanted levels into the budget, degrading the textures
+	// with the least screen coverage first, loads missing levels coarse to fine on the thread pool and drops
+	// levels that are no longer needed when memory is short.
+	//
+	// Storage is immutable, so the texture is reallocated at the size of its finest needed level and the
+	// resident levels are copied over. eBaseLevel hides levels that are allocated but not uploaded yet and
+	// eMinLOD fades a new level in over a few frames. The texture object changes when it is reallocated, bind
+	// it through the streamer each frame instead of keeping its name.
+	class TextureStreamer
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+		// Returns the pixels of a mip level in the source upload format, an empty image on failure.
+		// Called from worker threads, and on the calling thread by add() for the always resident tail.
+		using MipLoader = std::function<Image(int level)>;
+
+		struct Source
+		{
+			int width = 0;
+			int height = 0;
+
+			// Uncompressed formats only, texel_size is the size of one texel of the upload format in bytes
+			gl::DataFormat internal_format = gl::DataFormat::eRGBA8;
+			gl::DataFormat format = gl::DataFormat::eRGBA;
+			gl::Type type = gl::Type::eUnsignedByte;
+			size_t texel_size = 4;
+
+			MipLoader loader;
+		};
+
+		struct Settings
+		{
+			size_t vram_budget = 256 * 1024 * 1024;
+
+			// Levels up to this size are loaded by add() and never dropped
+			int tail_size = 64;
+
+			// Added to the estimated level, positive values trade sharpness for memory
+			float mip_bias = 0.0f;
+
+			int max_uploads_per_frame = 4;
+			size_t max_pending_loads = 16;
+			int fade_frames = 8;
+		};
+
+		struct Stats
+		{
+			size_t textures = 0;
+			size_t resident_bytes = 0;
+			size_t wanted_bytes = 0;
+			size_t pending_loads = 0;
+			size_t uploads = 0;
+			size_t reallocations = 0;
+			size_t dropped_levels = 0;
+		};
+
+		TextureStreamer(const Settings& settings, util::ThreadPool& pool);
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer(TextureStreamer&&) = delete;
+
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+		~TextureStreamer() = default;
+
+		// Textures
+		Handle add(Source source);
+		void remove(Handle handle) noexcept;
+
+		// Usage, reset by update()
+		void addView(const glm::vec3& position, const glm::mat4& projection, int viewport_height) noexcept;
+		void requestUsage(Handle handle, const glm::vec3& center, float radius, float uv_density) noexcept;
+
+		// Residency, call once per frame on the context thread after the usage was reported
+		void update();
+
+		// Bindings
+		void bind(Handle handle, int unit) const noexcept;
+
+		// Getters
+		const gl::Texture& texture(Handle handle) const noexcept;
+		int levelCount(Handle handle) const noexcept;
+		int residentLevel(Handle handle) const noexcept;
+		int wantedLevel(Handle handle) const noexcept;
+		const Settings& settings() const noexcept;
+		const Stats& stats() const noexcept;
+
+	private:
+		struct View
+		{
+			glm::vec3 position;
+
+			// Pixels per world unit, at unit distance for perspective projections
+			float scale;
+			bool perspective;
+		};
+
+		struct Entry
+		{
+			Source source;
+			gl::Texture texture{ gl::Texture::Target::eTexture2D };
+			uint32_t generation = 0;
+			bool used = false;
+
+			int levels = 0;
+			int tail = 0;
+
+			// Finest allocated level, finest uploaded level and the level being loaded
+			int allocated = 0;
+			int resident = 0;
+			int loading = -1;
+
+			// Finest level wanted this frame, the budgeted target and the screen coverage in pixels
+			int wanted = 0;
+			int target = 0;
+			float coverage = 0.0f;
+			uint64_t last_used = 0;
+
+			float fade = 0.0f;
+		};
+
+		struct LoadedMip
+		{
+			Handle handle;
+			uint32_t generation;
+			int level;
+			Image image;
+		};
+
+		struct LoadQueue
+		{
+			std::mutex mutex;
+			std::vector<LoadedMip> completed;
+		};
+
+		size_t levelBytes(const Entry& entry, int level) const noexcept;
+		size_t chainBytes(const Entry& entry, int level) const noexcept;
+
+		void fitBudget();
+		void reallocate(Entry& entry, int allocated);
+		void uploadLevel(Entry& entry, int level, const Image& image) noexcept;
+		void applyLevelClamp(Entry& entry) noexcept;
+		void requestLoad(Handle handle);
+
+		Settings m_settings;
+		util::ThreadPool& m_pool;
+
+		std::vector<Entry> m_entries;
+		std::vector<Handle> m_freeHandles;
+		std::vector<View> m_views;
+		std::shared_ptr<LoadQueue> m_loadQueue;
+		size_t m_pending = 0;
+
+		uint64_t m_frame = 1;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <renderer/gl/fence.hpp>
+#include <renderer/utility/spsc_queue.hpp>
+
+struct GLFWwindow;
+
+namespace gfx::core
+{
+	// Creates and fills GL objects on a dedicated thread with a hidden context shared with the render context.
+	//
+	// Tasks run in submission order and may create buffers and textures and upload into them, vertex arrays
+	// and framebuffers are not shared between contexts and must stay on the render thread. After each task a
+	// fence is inserted and the completion is handed back through a lock-free queue, poll() runs the done
+	// callbacks on the render thread once their fence has signaled, so the objects are complete when they are
+	// first used. Tasks can be posted from any thread, poll() must always be called from the same one.
+	class UploadThread
+	{
+	public:
+		// Must be called on the thread that created `shared`, since GLFW creates windows there
+		explicit UploadThread(GLFWwindow* shared, size_t max_completions = 64);
+		UploadThread(const UploadThread&) = delete;
+		UploadThread(UploadThread&&) = delete;
+
+		UploadThread& operator=(const UploadThread&) = delete;
+		UploadThread& operator=(UploadThread&&) = delete;
+
+		// Pending tasks are dropped, objects they already created are destroyed through the deletion queue
+		~UploadThread();
+
+		// `work` runs on the upload thread, `done` on the polling thread. If `work` throws, `done` is skipped
+		// and the exception is rethrown from poll().
+		void post(std::function<void()> work, std::function<void()> done);
+
+		// Hands the result of `create` to `done`, e.g. a filled buffer or texture
+		template<typename Create, typename Done>
+		void upload(Create&& create, Done&& done)
+		{
+			using Result = std::invoke_result_t<Create>;
+
+			auto result = std::make_shared<std::optional<Result>>();
+			post(
+				[result, create = std::forward<Create>(create)]() mutable { result->emplace(create()); },
+				[result, done = std::forward<Done>(done)]() mutable { done(std::move(**result)); }
+			);
+		}
+
+		// Runs the done callbacks of finished tasks, returns how many completed.
+		size_t poll();
+
+		// Tasks posted and not yet completed by poll()
+		size_t pendingCount() const;
+
+	private:
+		struct Task
+		{
+			std::function<void()> work;
+			std::function<void()> done;
+		};
+
+		struct Completion
+		{
+			gl::Fence fence;
+			std::function<void()> done;
+			std::exception_ptr error;
+		};
+
+		void workerLoop();
+
+		GLFWwindow* m_window = nullptr;
+		std::thread m_worker;
+
+		// Any thread may post, so tasks go through a mutex, completions have a single producer and consumer
+		std::deque<Task> m_tasks;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		bool m_stopping = false;
+		size_t m_pending = 0;
+
+		util::SpscQueue<Completion> m_completions;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/fence.hpp>
+#include <renderer/gl/framebuffer.hpp>
+#include <renderer/gl/renderbuffer.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/utility/thread_pool.hpp>
+
+namespace gfx::core
+{
+	// Sparse virtual texture backed by a fixed size page cache.
+	//
+	// Scene geometry is rendered with `shaders/vt_feedback.frag` between beginFeedback() and endFeedback()
+	// into a low resolution target. The requested pages are read back a few frames later without stalling,
+	// loaded by the TileLoader on the thread pool and uploaded into free (or least recently used) cache slots
+	// by update(). The page table maps every virtual page to the finest resident page covering it, and is
+	// sampled by `shaders/vt.frag`.
+	class VirtualTexture
+	{
+	public:
+		struct PageId
+		{
+			uint32_t mip;
+			uint32_t x;
+			uint32_t y;
+
+			bool operator==(const PageId& other) const = default;
+		};
+
+		// Writes an RGBA8 tile of tile_size * tile_size texels, the page content surrounded by `border` texels
+		// of its neighbours. Called from worker threads.
+		using TileLoader = std::function<bool(const PageId& page, int tile_size, int border, unsigned char* pixels)>;
+
+		struct Settings
+		{
+			// Virtual size in texels, must be page_size times a power of two on each axis.
+			int width = 0;
+			int height = 0;
+			int page_size = 128;
+			int border = 4;
+
+			size_t vram_budget = 64 * 1024 * 1024;
+
+			int feedback_width = 160;
+			int feedback_height = 90;
+			float feedback_scale = 8.0f;
+
+			int max_uploads_per_frame = 8;
+			size_t max_pending_loads = 64;
+		};
+
+		struct Stats
+		{
+			size_t resident_pages = 0;
+			size_t capacity = 0;
+			size_t pending_loads = 0;
+			size_t requests = 0;
+			size_t uploads = 0;
+			size_t evictions = 0;
+		};
+
+		VirtualTexture(const Settings& settings, TileLoader loader, util::ThreadPool& pool);
+		VirtualTexture(const VirtualTexture&) = delete;
+		VirtualTexture(VirtualTexture&&) = delete;
+
+		VirtualTexture& operator=(const VirtualTexture&) = delete;
+		VirtualTexture& operator=(VirtualTexture&&) = delete;
+
+		~VirtualTexture() = default;
+
+		// Feedback
+		void beginFeedback() noexcept;
+		void endFeedback() noexcept;
+		void resizeFeedback(int width, int height, float scale);
+
+		// Residency, call once per frame on the context thread
+		void update();
+
+		// Bindings
+		void bind(int cache_unit, int page_table_unit) const noexcept;
+		void applyUniforms(const gl::ShaderProgram& program, int cache_unit, int page_table_unit) const noexcept;
+
+		// Getters
+		const gl::Texture& cache() const noexcept;
+		const gl::Texture& pageTable() const noexcept;
+		int mipCount() const noexcept;
+		int slotSize() const noexcept;
+		const Stats& stats() const noexcept;
+
+	private:
+		struct Slot
+		{
+			PageId page{};
+			uint64_t last_used = 0;
+			bool pinned = false;
+		};
+
+		struct LoadedTile
+		{
+			PageId page;
+			std::vector<unsigned char> pixels;
+			bool valid;
+		};
+
+		struct LoadQueue
+		{
+			std::mutex mutex;
+			std::vector<LoadedTile> completed;
+		};
+
+		struct Readback
+		{
+			gl::Buffer buffer;
+			gl::Fence fence;
+			bool pending = false;
+		};
+
+		uint32_t pagesX(uint32_t mip) const noexcept;
+		uint32_t pagesY(uint32_t mip) const noexcept;
+
+		void processRequests(const std::vector<uint32_t>& requests);
+		void requestLoad(const PageId& page);
+		bool acquireSlot(uint32_t& slot);
+		void uploadTile(uint32_t slot, const unsigned char* pixels) noexcept;
+		void mapPage(const PageId& page, uint32_t slot);
+		void unmapPage(const PageId& page);
+		template<typename F>
+		void forEachTableEntry(const PageId& page, F&& func);
+		void flushPageTable() noexcept;
+
+		Settings m_settings;
+		TileLoader m_loader;
+		util::ThreadPool& m_pool;
+
+		uint32_t m_pagesX, m_pagesY;
+		uint32_t m_mipCount;
+		int m_slotSize;
+		int m_slotsX, m_slotsY;
+
+		gl::Texture m_cache;
+		gl::Texture m_pageTable;
+		std::vector<std::vector<uint32_t>> m_tableLevels;
+		std::vector<std::pair<uint32_t, uint32_t>> m_dirtyRows;
+
+		std::vector<Slot> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+		tsl::robin_map<uint64_t, uint32_t> m_resident;
+		tsl::robin_set<uint64_t> m_pending;
+		std::shared_ptr<LoadQueue> m_loadQueue;
+
+		gl::Framebuffer m_feedback;
+		gl::Texture m_feedbackColor;
+		gl::Renderbuffer m_feedbackDepth;
+		std::array<Readback, 3> m_readbacks;
+		size_t m_readbackHead = 0;
+		std::array<int, 4> m_savedViewport{};
+		std::vector<uint32_t> m_requests;
+
+		uint64_t m_frame = 1;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace gfx::gl
+{
+	enum class BlockLayout
+	{
+		eStd140,
+		eStd430
+	};
+
+	// Base alignment of the C++ types that match their GLSL counterpart byte for byte. Types without a
+	// specialization (glm::mat3, bool, doubles) have a different size or stride in GLSL and can't be members.
+	template<typename T>
+	struct BlockMember;
+
+	template<> struct BlockMember<float> { static constexpr size_t alignment = 4; };
+	template<> struct BlockMember<int32_t> { static constexpr size_t alignment = 4; };
+	template<> struct BlockMember<uint32_t> { static constexpr size_t alignment = 4; };
+	template<> struct BlockMember<glm::vec2> { static constexpr size_t alignment = 8; };
+	template<> struct BlockMember<glm::ivec2> { static constexpr size_t alignment = 8; };
+	template<> struct BlockMember<glm::uvec2> { static constexpr size_t alignment = 8; };
+	template<> struct BlockMember<glm::vec3> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::ivec3> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::uvec3> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::vec4> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::ivec4> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::uvec4> { static constexpr size_t alignment = 16; };
+	template<> struct BlockMember<glm::mat4> { static constexpr size_t alignment = 16; };
+
+	// Arrays are laid out with their element size as stride, which std140 rounds up to a vec4
+	template<typename T, size_t N>
+	struct BlockMember<std::array<T, N>>
+	{
+		static constexpr size_t alignment = BlockMember<T>::alignment;
+	};
+
+	template<BlockLayout Layout, typename T>
+	constexpr size_t arrayStride() noexcept
+	{
+		const auto alignment = BlockMember<T>::alignment;
+		const auto stride = (sizeof(T) + alignment - 1) / alignment * alignment;
+		return Layout == BlockLayout::eStd140 ? (stride + 15) / 16 * 16 : stride;
+	}
+
+	namespace detail
+	{
+		template<BlockLayout Layout, typename T>
+		struct MemberCheck
+		{
+			static constexpr size_t alignment = BlockMember<T>::alignment;
+			static constexpr bool stride_matches = true;
+		};
+
+		template<BlockLayout Layout, typename T, size_t N>
+		struct MemberCheck<Layout, std::array<T, N>>
+		{
+			static constexpr size_t alignment = Layout == BlockLayout::eStd140 ? std::max<size_t>(BlockMember<T>::alignment, 16) : BlockMember<T>::alignment;
+			static constexpr bool stride_matches = arrayStride<Layout, T>() == sizeof(T);
+		};
+	}
+
+	// True when a member of type T at `offset` is where GLSL puts it, check every member of a block with
+	//     static_assert(gl::blockMember<gl::BlockLayout::eStd140, decltype(Block::member)>(offsetof(Block, member)));
+	// C++ never aligns these types more strictly than GLSL, so aligned offsets can't be too far apart.
+	template<BlockLayout Layout, typename T>
+	constexpr bool blockMember(size_t offset) noexcept
+	{
+		using Check = detail::MemberCheck<Layout, T>;
+		return offset % Check::alignment == 0 && Check::stride_matches;
+	}
+
+	// True when the size of a block, given the types of its members, is a multiple of its alignment, so it can
+	// be used as an array element and GLSL reads nothing past its end.
+	template<BlockLayout Layout, typename Block, typename... Members>
+	constexpr bool blockSize() noexcept
+	{
+		const auto alignment = std::max({ (size_t)4, detail::MemberCheck<Layout, Members>::alignment... });
+		const auto struct_alignment = Layout == BlockLayout::eStd140 ? std::max<size_t>(alignment, 16) : alignment;
+		return sizeof(Block) % struct_alignment == 0;
+	}
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <vector>
 
 #include <glad/glad.h>
@@ -18,6 +20,7 @@ namespace gfx::gl
 			eDispatchIndirect = GL_DISPATCH_INDIRECT_BUFFER,
 			eDrawIndirect = GL_DRAW_INDIRECT_BUFFER,
 			eElementArray = GL_ELEMENT_ARRAY_BUFFER,
+			eParameter = GL_PARAMETER_BUFFER,
 			ePixelPack = GL_PIXEL_PACK_BUFFER,
 			ePixelUnpack = GL_PIXEL_UNPACK_BUFFER,
 			eQuery = GL_QUERY_BUFFER,
@@ -46,9 +49,22 @@ namespace gfx::gl
 			eMapWriteBit = GL_MAP_WRITE_BIT,
 			eDynamicStorageBit = GL_DYNAMIC_STORAGE_BIT,
 			eMapPersistentBit = GL_MAP_PERSISTENT_BIT,
+			eMapCoherentBit = GL_MAP_COHERENT_BIT,
 			eClientStorageBit = GL_CLIENT_STORAGE_BIT
 		};
 
+		enum class MapFlags : GLenum
+		{
+			eMapReadBit = GL_MAP_READ_BIT,
+			eMapWriteBit = GL_MAP_WRITE_BIT,
+			eMapPersistentBit = GL_MAP_PERSISTENT_BIT,
+			eMapCoherentBit = GL_MAP_COHERENT_BIT,
+			eMapInvalidateRangeBit = GL_MAP_INVALIDATE_RANGE_BIT,
+			eMapInvalidateBufferBit = GL_MAP_INVALIDATE_BUFFER_BIT,
+			eMapFlushExplicitBit = GL_MAP_FLUSH_EXPLICIT_BIT,
+			eMapUnsynchronizedBit = GL_MAP_UNSYNCHRONIZED_BIT
+		};
+
 		Buffer() noexcept;
 		Buffer(const Buffer& other) = delete;
 		Buffer(Buffer&& other) noexcept;
@@ -79,7 +95,7 @@ namespace gfx::gl
 		template<typename T, size_t N>
 		void bufferData(const T(&data)[N], Usage usage) noexcept
 		{
-			bufferData(N, data.data(), usage);
+			bufferData(N, data, usage);
 		}
 
 		void bufferData(size_t size, const void* data, Usage usage) noexcept;
@@ -110,13 +126,29 @@ namespace gfx::gl
 
 		void bufferStorage(size_t size, const void* data, StorageFlags flags) noexcept;
 
+		// Updates
+		void bufferSubData(size_t offset, size_t size, const void* data) noexcept;
+
+		// Copy
+		void copySubData(Buffer& dst, size_t read_offset, size_t write_offset, size_t size) const noexcept;
+
+		// Readback
+		void getSubData(size_t offset, size_t size, void* data) const noexcept;
+
+		// Mapping
+		void* mapRange(size_t offset, size_t size, MapFlags access) noexcept;
+		void flushMappedRange(size_t offset, size_t size) noexcept;
+		bool unmap() noexcept;
+
 		void bind(Target type) const noexcept;
 		void unbind(Target type) const noexcept;
+		void bindBase(Target type, unsigned int index) const noexcept;
+		void bindRange(Target type, unsigned int index, size_t offset, size_t size) const noexcept;
 
 		unsigned int id() const noexcept;
 
 	private:
-		unsigned int m_id;
+		unsigned int m_id = 0;
 	};
 
 	inline Buffer::StorageFlags operator|(Buffer::StorageFlags lhs, Buffer::StorageFlags rhs)
@@ -129,4 +161,14 @@ namespace gfx::gl
 	{
 		return (Buffer::StorageFlags)((GLenum)lhs & (GLenum)rhs);
 	}
+
+	inline Buffer::MapFlags operator|(Buffer::MapFlags lhs, Buffer::MapFlags rhs)
+	{
+		return (Buffer::MapFlags)((GLenum)lhs | (GLenum)rhs);
+	}
+
+	inline Buffer::MapFlags operator&(Buffer::MapFlags lhs, Buffer::MapFlags rhs)
+	{
+		return (Buffer::MapFlags)((GLenum)lhs & (GLenum)rhs);
+	}
 }
\ No newline at end of file
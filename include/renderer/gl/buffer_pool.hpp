@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/utility/tlsf.hpp>
+
+namespace gfx::gl
+{
+	// Suballocates ranges of a few large immutable buffers, so many meshes share one buffer binding and are
+	// drawn with base vertex and first index offsets.
+	//
+	// Ranges are addressed by stable handles, compact() may move them to lower offsets or earlier pages, so
+	// query buffer() and offset() when recording draws instead of keeping them.
+	class BufferPool
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+		struct Stats
+		{
+			size_t pages = 0;
+			size_t capacity = 0;
+			size_t used = 0;
+			size_t largest_free = 0;
+			size_t allocations = 0;
+			size_t free_blocks = 0;
+
+			// 1 - largest free block / free bytes, 0 when all free space is contiguous
+			float fragmentation = 0.0f;
+		};
+
+		BufferPool(size_t page_size, Buffer::StorageFlags flags = Buffer::StorageFlags::eDynamicStorageBit);
+		BufferPool(const BufferPool&) = delete;
+		BufferPool(BufferPool&&) = default;
+
+		BufferPool& operator=(const BufferPool&) = delete;
+		BufferPool& operator=(BufferPool&&) = default;
+
+		~BufferPool() = default;
+
+		// Allocation, ranges larger than a page get a dedicated page
+		Handle allocate(size_t size, size_t alignment = 16);
+		void free(Handle handle) noexcept;
+
+		// Updates, requires eDynamicStorageBit
+		void upload(Handle handle, size_t offset, size_t size, const void* data) noexcept;
+
+		template<typename T>
+		void upload(Handle handle, const std::vector<T>& data) noexcept
+		{
+			upload(handle, 0, sizeof(T) * data.size(), data.data());
+		}
+
+		// Copies from another buffer on the GPU, does not require eDynamicStorageBit
+		void copy(Handle handle, size_t offset, const Buffer& src, size_t src_offset, size_t size) noexcept;
+
+		// Moves up to max_bytes of ranges towards the start of the pool and releases emptied pages,
+		// returns the number of bytes moved. The copies are ordered on the GPU like any other command.
+		size_t compact(size_t max_bytes);
+
+		// Getters
+		const Buffer& buffer(Handle handle) const noexcept;
+		size_t offset(Handle handle) const noexcept;
+		size_t size(Handle handle) const noexcept;
+		uint32_t page(Handle handle) const noexcept;
+		size_t pageCount() const noexcept;
+		const Buffer& pageBuffer(size_t page) const noexcept;
+		Stats stats() const noexcept;
+
+	private:
+		struct Page
+		{
+			Buffer buffer;
+			util::TlsfAllocator allocator;
+		};
+
+		struct Range
+		{
+			uint32_t page = 0;
+			uint32_t block = util::TlsfAllocator::INVALID_BLOCK;
+			size_t size = 0;
+			size_t alignment = 1;
+		};
+
+		void addPage(size_t capacity);
+		bool relocate(Handle handle);
+		void releaseEmptyPages() noexcept;
+
+		size_t m_pageSize;
+		Buffer::StorageFlags m_flags;
+
+		std::vector<Page> m_pages;
+		std::vector<Range> m_ranges;
+		std::vector<Handle> m_freeHandles;
+	};
+}
\ No newline at end of file
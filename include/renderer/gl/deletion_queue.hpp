@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <renderer/gl/fence.hpp>
+
+namespace gfx::gl
+{
+	// Deferred deletion of GL names, posted from any thread and deleted on the context thread.
+	//
+	// Names posted during a frame are fenced by endFrame() and deleted together, one glDelete* per type, once
+	// that fence signals, so destroying an object never waits on the GPU still reading it. The wrappers post
+	// their name from their destructor. Vertex arrays, framebuffers and queries are not shared between contexts
+	// and must belong to the context that calls endFrame().
+	class DeletionQueue
+	{
+	public:
+		enum class Type
+		{
+			eBuffer,
+			eTexture,
+			eVertexArray,
+			eFramebuffer,
+			eRenderbuffer,
+			eShader,
+			eShaderProgram,
+			eProgramPipeline,
+			eQuery
+		};
+
+		static constexpr size_t TYPE_COUNT = 9;
+
+		struct Stats
+		{
+			size_t pending = 0;
+			size_t deleted = 0;
+		};
+
+		static DeletionQueue& instance() noexcept;
+
+		DeletionQueue() = default;
+		DeletionQueue(const DeletionQueue&) = delete;
+		DeletionQueue(DeletionQueue&&) = delete;
+
+		DeletionQueue& operator=(const DeletionQueue&) = delete;
+		DeletionQueue& operator=(DeletionQueue&&) = delete;
+
+		// Any thread, the zero name is ignored
+		void post(Type type, unsigned int name);
+
+		// Context thread, endFrame() once per frame after its commands are submitted and flush() before the
+		// context is destroyed
+		void endFrame();
+		void flush();
+
+		// Getters, counts of the last endFrame()
+		const Stats& stats() const noexcept;
+
+	private:
+		using Names = std::array<std::vector<unsigned int>, TYPE_COUNT>;
+
+		struct Batch
+		{
+			Fence fence;
+			Names names;
+		};
+
+		void retire(Names& names) noexcept;
+
+		std::mutex m_mutex;
+		Names m_posted;
+
+		std::deque<Batch> m_batches;
+		std::vector<Names> m_spare;
+		Stats m_stats;
+	};
+}
\ No newline at end of file
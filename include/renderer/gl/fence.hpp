@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+namespace gfx::gl
+{
+	class Fence
+	{
+	public:
+		enum class Status : GLenum
+		{
+			eAlreadySignaled = GL_ALREADY_SIGNALED,
+			eTimeoutExpired = GL_TIMEOUT_EXPIRED,
+			eConditionSatisfied = GL_CONDITION_SATISFIED,
+			eWaitFailed = GL_WAIT_FAILED
+		};
+
+		Fence() noexcept;
+		Fence(const Fence& other) = delete;
+		Fence(Fence&& other) noexcept;
+
+		Fence& operator=(const Fence& other) = delete;
+		Fence& operator=(Fence&& other) noexcept;
+
+		~Fence() noexcept;
+
+		// Insert a new fence into the command stream, replacing any previous one.
+		void insert() noexcept;
+		void reset() noexcept;
+
+		// Non-blocking poll, an empty fence is always signaled.
+		bool signaled() const noexcept;
+
+		// Client side wait, flushes the command stream so the fence is guaranteed to signal.
+		Status wait(uint64_t timeout_ns) const noexcept;
+
+		// Server side wait, blocks the GL command stream rather than the calling thread.
+		void serverWait() const noexcept;
+
+		bool valid() const noexcept;
+		GLsync id() const noexcept;
+
+	private:
+		GLsync m_sync = nullptr;
+	};
+}
\ No newline at end of file
@@ -61,11 +61,20 @@ namespace gfx::gl
 		void attach(const Renderbuffer& buffer, Attachment attachment) noexcept;
 		void attach(const Texture& texture, Attachment attachment, int level) noexcept;
 
+		// Clearing
+		void clearColor(int draw_buffer, const float* value) noexcept;
+		void clearColor(int draw_buffer, const int* value) noexcept;
+		void clearColor(int draw_buffer, const unsigned int* value) noexcept;
+		void clearDepth(float depth) noexcept;
+
+		// Copy, a null destination is the default framebuffer
+		void blit(const Framebuffer* dst, int src_x0, int src_y0, int src_x1, int src_y1, int dst_x0, int dst_y0, int dst_x1, int dst_y1, GLbitfield mask, GLenum filter) const noexcept;
+
 		// Getters
 		Status status(Target  target = Target::eFramebuffer) const noexcept;
 		unsigned int id() const noexcept;
 
 	private:
-		unsigned int m_id;
+		unsigned int m_id = 0;
 	};
 } // namespace renderer::backend::gl
\ No newline at end of file
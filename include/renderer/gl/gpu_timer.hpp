@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <renderer/gl/query.hpp>
+#include <renderer/utility/profiler.hpp>
+
+namespace gfx::gl
+{
+	// GPU durations of named zones, measured with timestamp queries kept in a ring of frames.
+	//
+	// Every zone writes a timestamp where it begins and ends in the command stream, so zones nest like the CPU
+	// profiler zones they are named after. A frame is read back once all of its queries are available, usually
+	// a few frames later, and a frame is not recorded while every slot of the ring still waits for its results,
+	// so reading never stalls the pipeline. Resolved zones are moved to the CPU clock and handed to the profiler,
+	// which shows them on their own track. Zones are only recorded while the profiler is enabled.
+	class GpuTimer
+	{
+	public:
+		static constexpr size_t FRAME_COUNT = 4;
+		static constexpr size_t NO_ZONE = SIZE_MAX;
+
+		// Nanoseconds on the clock of util::Profiler::now()
+		struct Zone
+		{
+			const char* name = nullptr;
+			uint64_t begin = 0;
+			uint64_t end = 0;
+			uint32_t depth = 0;
+		};
+
+		struct Frame
+		{
+			uint64_t begin = 0;
+			uint64_t end = 0;
+			std::vector<Zone> zones;
+		};
+
+		static GpuTimer& instance() noexcept;
+
+		GpuTimer() = default;
+		GpuTimer(const GpuTimer&) = delete;
+		GpuTimer(GpuTimer&&) = delete;
+
+		GpuTimer& operator=(const GpuTimer&) = delete;
+		GpuTimer& operator=(GpuTimer&&) = delete;
+
+		// Context thread, once per frame around all of its commands. beginFrame() resolves the finished frames.
+		void beginFrame();
+		void endFrame() noexcept;
+
+		// Context thread, zones end in the frame they began. Names must outlive the timer, e.g. string literals
+		size_t begin(const char* name) noexcept;
+		void end(size_t zone) noexcept;
+
+		// Deletes the queries, before the context is destroyed
+		void release() noexcept;
+
+		// Getters, the last frame is empty until a frame was resolved
+		const Frame& lastFrame() const noexcept;
+		size_t skippedFrames() const noexcept;
+
+	private:
+		struct Record
+		{
+			const char* name;
+			size_t begin;
+			size_t end;
+			uint32_t depth;
+		};
+
+		struct Slot
+		{
+			std::vector<Query> queries;
+			std::vector<Record> records;
+			size_t used = 0;
+			size_t frameBegin = 0;
+			size_t frameEnd = 0;
+			int64_t clockOffset = 0;
+			bool pending = false;
+		};
+
+		size_t timestamp() noexcept;
+		bool resolve(Slot& slot);
+
+		// Frames are written at m_current and resolved from m_oldest on
+		std::array<Slot, FRAME_COUNT> m_slots;
+		size_t m_oldest = 0;
+		size_t m_current = 0;
+		bool m_recording = false;
+		uint32_t m_depth = 0;
+
+		Frame m_lastFrame;
+		size_t m_skipped = 0;
+	};
+
+	// Records the lifetime of the scope as a GPU zone
+	class GpuScope
+	{
+	public:
+		explicit GpuScope(const char* name) noexcept :
+			m_zone(GpuTimer::instance().begin(name))
+		{
+		}
+
+		GpuScope(const GpuScope&) = delete;
+		GpuScope(GpuScope&&) = delete;
+
+		GpuScope& operator=(const GpuScope&) = delete;
+		GpuScope& operator=(GpuScope&&) = delete;
+
+		~GpuScope() noexcept
+		{
+			GpuTimer::instance().end(m_zone);
+		}
+
+	private:
+		size_t m_zone;
+	};
+}
+
+// A CPU and a GPU zone of the same name
+#ifdef RENDERER_PROFILE
+#define RENDERER_PROFILE_GPU_SCOPE(name) \
+	RENDERER_PROFILE_SCOPE(name); \
+	::gfx::gl::GpuScope RENDERER_PROFILE_CONCAT(gpu_scope_, __LINE__)(name)
+#else
+#define RENDERER_PROFILE_GPU_SCOPE(name) ((void)0)
+#endif
\ No newline at end of file
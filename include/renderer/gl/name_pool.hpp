@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+#include <tsl/robin_map.h>
+
+namespace gfx::gl
+{
+	// Fresh GL names created in batches, one glCreate* per BATCH_SIZE objects instead of one per object.
+	//
+	// glCreate* names come back initialized to the default state of their type, so an unused pooled name is
+	// indistinguishable from a new one. Deleted names cannot be reused, immutable storage would carry over, so
+	// the pool only ever holds names that were never handed out. There is one pool per thread, matching the
+	// one current context per thread rule, and release() must run before that context is destroyed.
+	class NamePool
+	{
+	public:
+		static constexpr size_t BATCH_SIZE = 32;
+
+		static NamePool& current() noexcept;
+
+		NamePool() = default;
+		NamePool(const NamePool&) = delete;
+		NamePool(NamePool&&) = delete;
+
+		NamePool& operator=(const NamePool&) = delete;
+		NamePool& operator=(NamePool&&) = delete;
+
+		// Creation
+		unsigned int createBuffer();
+		unsigned int createTexture(GLenum target);
+		unsigned int createVertexArray();
+		unsigned int createFramebuffer();
+		unsigned int createRenderbuffer();
+
+		// Deletes the pooled names
+		void release() noexcept;
+
+	private:
+		template<typename Create>
+		static unsigned int take(std::vector<unsigned int>& pool, Create&& create);
+
+		std::vector<unsigned int> m_buffers;
+		tsl::robin_map<GLenum, std::vector<unsigned int>> m_textures;
+		std::vector<unsigned int> m_vertexArrays;
+		std::vector<unsigned int> m_framebuffers;
+		std::vector<unsigned int> m_renderbuffers;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+namespace gfx::gl
+{
+	// Asynchronous query object, results arrive some frames after the commands that produce them.
+	//
+	// Timestamps are written with counter() when the GPU reaches that point of the command stream, every other
+	// target measures the commands between begin() and end(). Only one query per target can be active at a
+	// time, so elapsed time queries cannot nest while timestamps can.
+	class Query
+	{
+	public:
+		enum class Target : GLenum
+		{
+			eTimestamp = GL_TIMESTAMP,
+			eTimeElapsed = GL_TIME_ELAPSED,
+			eSamplesPassed = GL_SAMPLES_PASSED,
+			eAnySamplesPassed = GL_ANY_SAMPLES_PASSED,
+			ePrimitivesGenerated = GL_PRIMITIVES_GENERATED
+		};
+
+		explicit Query(Target target) noexcept;
+		Query(const Query& other) = delete;
+		Query(Query&& other) noexcept;
+
+		Query& operator=(const Query& other) = delete;
+		Query& operator=(Query&& other) noexcept;
+
+		~Query() noexcept;
+
+		// Measuring
+		void begin() noexcept;
+		void end() noexcept;
+		void counter() noexcept;
+
+		// Non-blocking poll, the result is only read without a stall once it is available
+		bool available() const noexcept;
+		uint64_t result() const noexcept;
+
+		// Getters
+		Target target() const noexcept;
+		unsigned int id() const noexcept;
+
+	private:
+		unsigned int m_id = 0;
+		Target m_target = Target::eTimestamp;
+	};
+}
\ No newline at end of file
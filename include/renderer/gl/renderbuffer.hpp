@@ -16,10 +16,10 @@ namespace gfx::gl
 
 		Renderbuffer() noexcept;
 		Renderbuffer(const Renderbuffer& other) = delete;
-		Renderbuffer(Renderbuffer&& other);
+		Renderbuffer(Renderbuffer&& other) noexcept;
 
 		Renderbuffer& operator=(const Renderbuffer& other) = delete;
-		Renderbuffer& operator=(Renderbuffer&& other);
+		Renderbuffer& operator=(Renderbuffer&& other) noexcept;
 
 		~Renderbuffer();
 		
@@ -34,6 +34,6 @@ namespace gfx::gl
 		unsigned int id() const noexcept;
 
 	private:
-		unsigned int m_id;
+		unsigned int m_id = 0;
 	};
 }
\ No newline at end of file
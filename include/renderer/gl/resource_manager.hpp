@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/fence.hpp>
+#include <renderer/gl/framebuffer.hpp>
+#include <renderer/gl/query.hpp>
+#include <renderer/gl/renderbuffer.hpp>
+#include <renderer/gl/shader.hpp>
+#include <renderer/gl/shader_pipeline.hpp>
+#include <renderer/gl/shader_program.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/gl/vertex_array.hpp>
+#include <renderer/utility/slot_map.hpp>
+
+namespace gfx::gl
+{
+	using BufferHandle = util::Handle<Buffer>;
+	using TextureHandle = util::Handle<Texture>;
+	using VertexArrayHandle = util::Handle<VertexArray>;
+	using FramebufferHandle = util::Handle<Framebuffer>;
+	using RenderbufferHandle = util::Handle<Renderbuffer>;
+	using ShaderHandle = util::Handle<Shader>;
+	using ShaderProgramHandle = util::Handle<ShaderProgram>;
+	using ShaderPipelineHandle = util::Handle<ShaderPipeline>;
+	using FenceHandle = util::Handle<Fence>;
+	using QueryHandle = util::Handle<Query>;
+
+	// Owner of GL objects of every wrapper type, handing out 32 bit generational handles.
+	//
+	// Scene data keeps handles instead of the objects themselves: lookups are O(1), handles to destroyed
+	// objects resolve to null instead of a recycled GL name, and each type is stored densely for iteration.
+	// Not thread safe, use it on the context thread.
+	class ResourceManager
+	{
+	public:
+		ResourceManager() = default;
+		ResourceManager(const ResourceManager&) = delete;
+		ResourceManager(ResourceManager&&) = default;
+
+		ResourceManager& operator=(const ResourceManager&) = delete;
+		ResourceManager& operator=(ResourceManager&&) = default;
+
+		// Creation, arguments are forwarded to the wrapper constructor
+		template<typename T, typename... Args>
+		util::Handle<T> create(Args&&... args)
+		{
+			return pool<T>().emplace(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		util::Handle<T> adopt(T&& object)
+		{
+			static_assert(!std::is_lvalue_reference_v<T>, "adopted objects must be moved in");
+			return pool<T>().insert(std::move(object));
+		}
+
+		// Destruction, returns false for stale handles
+		template<typename T>
+		bool destroy(util::Handle<T> handle)
+		{
+			return pool<T>().erase(handle);
+		}
+
+		// Lookup, null for stale handles
+		template<typename T>
+		T* get(util::Handle<T> handle) noexcept
+		{
+			return pool<T>().get(handle);
+		}
+
+		template<typename T>
+		const T* get(util::Handle<T> handle) const noexcept
+		{
+			return pool<T>().get(handle);
+		}
+
+		template<typename T>
+		bool valid(util::Handle<T> handle) const noexcept
+		{
+			return pool<T>().contains(handle);
+		}
+
+		// Dense storage of one type, for iteration over the live objects
+		template<typename T>
+		util::SlotMap<T>& pool() noexcept
+		{
+			return std::get<util::SlotMap<T>>(m_pools);
+		}
+
+		template<typename T>
+		const util::SlotMap<T>& pool() const noexcept
+		{
+			return std::get<util::SlotMap<T>>(m_pools);
+		}
+
+		void clear()
+		{
+			std::apply([](auto&... pools) { (pools.clear(), ...); }, m_pools);
+		}
+
+		size_t size() const noexcept
+		{
+			return std::apply([](const auto&... pools) { return (pools.size() + ...); }, m_pools);
+		}
+
+	private:
+		std::tuple<
+			util::SlotMap<Buffer>,
+			util::SlotMap<Texture>,
+			util::SlotMap<VertexArray>,
+			util::SlotMap<Framebuffer>,
+			util::SlotMap<Renderbuffer>,
+			util::SlotMap<Shader>,
+			util::SlotMap<ShaderProgram>,
+			util::SlotMap<ShaderPipeline>,
+			util::SlotMap<Fence>,
+			util::SlotMap<Query>
+		> m_pools;
+	};
+}
\ No newline at end of file
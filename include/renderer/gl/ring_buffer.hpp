@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/fence.hpp>
+
+namespace gfx::gl
+{
+	// Persistently and coherently mapped buffer split into one region per frame in flight.
+	//
+	// Writes go straight into the mapping without any driver copy. beginFrame() waits on the fence of the
+	// region it is about to reuse, which only blocks when the GPU is more than `frames - 1` frames behind,
+	// and endFrame() fences the region written this frame.
+	class RingBuffer
+	{
+	public:
+		struct Allocation
+		{
+			void* data = nullptr;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+
+		RingBuffer(size_t frame_size, size_t frames = 3);
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer(RingBuffer&&) = delete;
+
+		RingBuffer& operator=(const RingBuffer&) = delete;
+		RingBuffer& operator=(RingBuffer&&) = delete;
+
+		~RingBuffer() = default;
+
+		// Frames
+		void beginFrame() noexcept;
+		void endFrame() noexcept;
+
+		// Allocation, throws when the region of the current frame is exhausted
+		Allocation allocate(size_t size, size_t alignment);
+		Allocation allocateUniform(size_t size);
+		Allocation allocateStorage(size_t size);
+
+		template<typename T>
+		Allocation push(const T& value, size_t alignment = alignof(T))
+		{
+			auto allocation = allocate(sizeof(T), alignment);
+			std::memcpy(allocation.data, &value, sizeof(T));
+			return allocation;
+		}
+
+		template<typename T>
+		Allocation push(const std::vector<T>& values, size_t alignment = alignof(T))
+		{
+			auto allocation = allocate(sizeof(T) * values.size(), alignment);
+			std::memcpy(allocation.data, values.data(), allocation.size);
+			return allocation;
+		}
+
+		// A whole uniform or storage block in one copy, aligned for bindRange()
+		template<typename T>
+		Allocation pushUniform(const T& value)
+		{
+			auto allocation = allocateUniform(sizeof(T));
+			std::memcpy(allocation.data, &value, sizeof(T));
+			return allocation;
+		}
+
+		template<typename T>
+		Allocation pushStorage(const T& value)
+		{
+			auto allocation = allocateStorage(sizeof(T));
+			std::memcpy(allocation.data, &value, sizeof(T));
+			return allocation;
+		}
+
+		// Bindings
+		void bindRange(Buffer::Target target, unsigned int index, const Allocation& allocation) const noexcept;
+
+		// Getters
+		const Buffer& buffer() const noexcept;
+		size_t frameSize() const noexcept;
+		size_t frameCount() const noexcept;
+		size_t used() const noexcept;
+		size_t uniformAlignment() const noexcept;
+		size_t storageAlignment() const noexcept;
+
+	private:
+		Buffer m_buffer;
+		std::vector<Fence> m_fences;
+		unsigned char* m_mapping = nullptr;
+
+		size_t m_frameSize;
+		size_t m_frame = 0;
+		size_t m_head = 0;
+
+		size_t m_uniformAlignment;
+		size_t m_storageAlignment;
+	};
+}
\ No newline at end of file
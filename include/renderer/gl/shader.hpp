@@ -32,15 +32,24 @@ namespace gfx::gl
 		Shader& operator=(const Shader&) = delete;
 		Shader& operator=(Shader&&) noexcept;
 
-		// State
+		// State, loadSource() compiles and checks the result like compile() followed by compiled()
 		void loadSource(const std::string& data);
 
+		// Asynchronous compilation, with parallel compilation the driver compiles in the background until the
+		// status is queried. completed() never blocks and is always true without the extension.
+		void compile(const std::string& data) noexcept;
+		bool completed() const noexcept;
+		bool compiled() const noexcept;
+		std::string infoLog() const;
+
+		static bool parallelCompileSupported() noexcept;
+
 		// Methods
 		Target target() const noexcept;
 		unsigned int id() const noexcept;
 
 	private:
-		Target m_target;
-		unsigned int m_id;
+		Target m_target = Target::eVertex;
+		unsigned int m_id = 0;
 	};
 }
\ No newline at end of file
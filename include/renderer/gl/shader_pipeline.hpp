@@ -1,60 +1,116 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 
 #include <glad/glad.h>
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-#include <glm/vec4.hpp>
-#include <glm/vec2.hpp>
 
 #include <renderer/gl/shader_program.hpp>
-
+#include <renderer/gl/uniform.hpp>
 
 namespace gfx::gl
 {
+	// Uniform of a pipeline, one handle per stage program that declares it
+	template<typename T>
+	struct PipelineUniform
+	{
+		std::array<Uniform<T>, 6> stages;
+
+		bool valid() const noexcept
+		{
+			for (const auto& stage : stages)
+			{
+				if (stage.valid())
+					return true;
+			}
+			return false;
+		}
+	};
+
+	// Program pipeline object combining separable programs, one per stage.
+	//
+	// Each stage is linked once on its own, so pairing V vertex with F fragment programs takes V + F links
+	// instead of V * F. The programs must be linked with ShaderProgram::Parameter::eSeparable and outlive the
+	// pipeline. Uniforms belong to the stage programs, uniform() finds the handle in every stage that declares
+	// the name and set() uploads to all of them.
 	class ShaderPipeline
 	{
 	public:
-		using  TargetFlags = ShaderProgram::TargetFlags;
+		using TargetFlags = ShaderProgram::TargetFlags;
+
+		static constexpr size_t STAGE_COUNT = 6;
 
 		ShaderPipeline() noexcept;
-		ShaderPipeline(const ShaderPipeline& other) = delete;
+		ShaderPipeline(const ShaderPipeline&) = delete;
 		ShaderPipeline(ShaderPipeline&& other) noexcept;
 
-		ShaderPipeline& operator=(const ShaderPipeline& other) = delete;
+		ShaderPipeline& operator=(const ShaderPipeline&) = delete;
 		ShaderPipeline& operator=(ShaderPipeline&& other) noexcept;
 
-		template<typename T>
-		bool setUniform(const std::string& name, const std::vector<T>& vs);
+		~ShaderPipeline() noexcept;
+
+		// Uses the program for all of its linked stages, or only `stages` of them
+		void useProgram(const ShaderProgram& program) noexcept;
+		void useProgram(const ShaderProgram& program, TargetFlags stages) noexcept;
+		void clearStages(TargetFlags stages) noexcept;
+
+		// Checks the stage interfaces against the current GL state, throws the info log when they do not match
+		void validate() const;
+		std::string infoLog() const;
 
+		// Throws if no stage declares the uniform or a declaration does not match T
 		template<typename T>
-		long long setUniform(const std::string& name, const T& v)
+		PipelineUniform<T> uniform(const std::string& uniform_name) const
 		{
-			unsigned int uniform_loc;
-			for (const auto prog : m_programs)
+			PipelineUniform<T> uniform;
+			for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
 			{
-				if 
+				const auto* program = m_programs[stage];
+				if (program == nullptr || firstStage(*program) != stage || !program->hasUniform(uniform_name))
+					continue;
+
+				uniform.stages[stage] = program->uniform<T>(uniform_name);
 			}
+
+			if (!uniform.valid())
+				throw std::runtime_error("No stage of the pipeline has a uniform with name '" + uniform_name + "'");
+
+			return uniform;
 		}
 
 		template<typename T>
-		long long setUniform(const std::string& name, const T& v)
+		void set(const PipelineUniform<T>& uniform, const T* values, uint32_t count) const noexcept
+		{
+			for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
+			{
+				if (uniform.stages[stage].valid() && m_programs[stage] != nullptr)
+					m_programs[stage]->set(uniform.stages[stage], values, count);
+			}
+		}
 
-		bool setUniform(const std::string& name, float v) const noexcept;
-		bool setUniform(const std::string& name, const glm::vec2& v) const noexcept;
-		bool setUniform(const std::string& name, const glm::vec3& v) const noexcept;
+		template<typename T>
+		void set(const PipelineUniform<T>& uniform, const T& value) const noexcept
+		{
+			set(uniform, &value, 1);
+		}
 
+		void bind() const noexcept;
+		void unbind() const noexcept;
 
-		bool attributeLocation(const std::string& attribute_name, unsigned int& binding_location) const noexcept;
-		bool uniformLocation(const std::string& uniform_name, unsigned int& binding_location) const noexcept;
+		// Getters, program() is null for stages without a program
+		const ShaderProgram* program(TargetFlags stage) const noexcept;
 		TargetFlags flags() const noexcept;
 		unsigned int id() const noexcept;
 
 	private:
-		std::array<ShaderProgram*, 5> m_programs;
-		unsigned int m_id;
-	};
-
+		// The same program can serve several stages, its uniforms are routed through the first one
+		size_t firstStage(const ShaderProgram& program) const noexcept;
 
+		std::array<const ShaderProgram*, STAGE_COUNT> m_programs{};
+		TargetFlags m_flags = (TargetFlags)0;
+		unsigned int m_id = 0;
+	};
 }
\ No newline at end of file
@@ -1,15 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
 #include <tsl/robin_map.h>
 
 #include <renderer/gl/shader.hpp>
+#include <renderer/gl/uniform.hpp>
 
 namespace gfx::gl
 {
-
+	// Linked program, the uniforms of its default block are reflected at link time.
+	//
+	// The program keeps a shadow copy of every uniform value, read back from the driver after linking, so set()
+	// skips uploads of values that did not change. The shadow is only accurate when all updates go through set(),
+	// raw glUniform calls on the program's locations leave it stale.
 	class ShaderProgram
 	{
 	public:
@@ -23,18 +32,34 @@ namespace gfx::gl
 			eCompute = GL_COMPUTE_SHADER_BIT
 		};
 
-		enum class Parameter
+		enum class Parameter : GLenum
+		{
+			eBinaryRetrievable = GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+			eSeparable = GL_PROGRAM_SEPARABLE
+		};
+
+		// Driver specific image of a linked program, only valid for the driver that produced it
+		struct Binary
 		{
-			eBinaryRetrievable,
-			eSeparable
+			GLenum format = 0;
+			TargetFlags flags = (TargetFlags)0;
+			std::vector<std::byte> data;
+		};
+
+		struct UniformInfo
+		{
+			int location = -1;
+			GLenum type = 0;
+			uint32_t count = 0;
+			uint32_t offset = 0;
 		};
 
 		ShaderProgram() noexcept;
 		ShaderProgram(const ShaderProgram&) = delete;
-		ShaderProgram(ShaderProgram&&) = default;
+		ShaderProgram(ShaderProgram&& other) noexcept;
 
 		ShaderProgram& operator=(const ShaderProgram&) = delete;
-		ShaderProgram& operator=(ShaderProgram&&) = default;
+		ShaderProgram& operator=(ShaderProgram&& other) noexcept;
 
 		~ShaderProgram() noexcept;
 
@@ -42,11 +67,69 @@ namespace gfx::gl
 		void detachShader(const Shader& shader) noexcept;
 		void link();
 
+		// Asynchronous linking, finishLink() always checks the status and throws the info log on failure.
+		// completed() never blocks and is always true without parallel compilation.
+		void startLink() noexcept;
+		bool completed() const noexcept;
+		void finishLink();
+		std::string infoLog() const;
+
 		void parameter(Parameter param, bool value) noexcept;
 
+		// Binaries, set eBinaryRetrievable before linking to retrieve one. loadBinary() replaces linking and
+		// returns false when the driver rejects the binary, e.g. after a driver update.
+		Binary binary() const;
+		bool loadBinary(const Binary& binary);
+
 
 		int getUniform(const std::string& uniform_name) const;
 		int getUniform(const char* uniform_name) const;
+		bool hasUniform(const std::string& uniform_name) const noexcept;
+
+		// Typed handle, throws if the uniform is not active or its type does not match T
+		template<typename T>
+		Uniform<T> uniform(const std::string& uniform_name) const
+		{
+			const auto& info = uniformInfo(uniform_name);
+			if (!UniformTraits<T>::accepts(info.type))
+				throw std::invalid_argument("Uniform '" + uniform_name + "' does not match the requested type");
+
+			return { info.location, info.count, info.offset };
+		}
+
+		// Same for a fixed location, e.g. from a generated shader header, without hashing a name
+		template<typename T>
+		Uniform<T> uniform(int location) const
+		{
+			const auto& info = uniformInfo(location);
+			if (!UniformTraits<T>::accepts(info.type))
+				throw std::invalid_argument("Uniform at location " + std::to_string(location) + " does not match the requested type");
+
+			return { info.location, info.count, info.offset };
+		}
+
+		// Uploads values that differ from the shadow copy, invalid handles are ignored. Like bind(), setting
+		// uniforms only changes GL state, so it works through const references.
+		template<typename T>
+		void set(Uniform<T> uniform, const T* values, uint32_t count) const noexcept
+		{
+			if (!uniform.valid())
+				return;
+
+			count = std::min(count, uniform.count);
+			auto* shadow = m_uniformValues.data() + uniform.offset;
+			if (std::memcmp(shadow, values, sizeof(T) * count) == 0)
+				return;
+
+			std::memcpy(shadow, values, sizeof(T) * count);
+			UniformTraits<T>::upload(m_id, uniform.location, (int)count, values);
+		}
+
+		template<typename T>
+		void set(Uniform<T> uniform, const T& value) const noexcept
+		{
+			set(uniform, &value, 1);
+		}
 
 		void bind() const noexcept;
 		void unbind() const noexcept;
@@ -55,14 +138,21 @@ namespace gfx::gl
 		std::vector<std::string> getUniformNames() const;
 		std::vector<std::string> getAttributeNames() const;
 
-		// Getters
+		// Getters, flags are the stages linked into the program
 		TargetFlags flags() const noexcept;
 		unsigned int id() const noexcept;
 
 	private:
-		tsl::robin_map<std::string, unsigned int> m_uniforms;
-		TargetFlags m_flags;
-		unsigned int m_id;
+		void readStages();
+		void reflectUniforms();
+		const UniformInfo& uniformInfo(const std::string& uniform_name) const;
+		const UniformInfo& uniformInfo(int location) const;
+
+		// Arrays are found by their name with and without the [0] subscript
+		tsl::robin_map<std::string, UniformInfo> m_uniforms;
+		mutable std::vector<std::byte> m_uniformValues;
+		TargetFlags m_flags = (TargetFlags)0;
+		unsigned int m_id = 0;
 	};
 
 
@@ -71,7 +161,7 @@ namespace gfx::gl
 		return (ShaderProgram::TargetFlags)((GLenum)lhs | (GLenum)rhs);
 	}
 
-	inline ShaderProgram::TargetFlags operator|=(ShaderProgram::TargetFlags lhs, ShaderProgram::TargetFlags rhs)
+	inline ShaderProgram::TargetFlags operator|=(ShaderProgram::TargetFlags& lhs, ShaderProgram::TargetFlags rhs)
 	{
 		lhs = (ShaderProgram::TargetFlags)((GLenum)lhs | (GLenum)rhs);
 		return lhs;
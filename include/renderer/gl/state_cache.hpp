@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+namespace gfx::gl
+{
+	// Shadow of the bindings and fixed function state of the current context, skipping calls that change nothing.
+	//
+	// There is one cache per thread, matching the one current context per thread rule. The wrappers bind through
+	// it, so code issuing raw GL calls that change the tracked state (ImGui backends, other contexts made current
+	// on the thread) must call invalidate() afterwards. The element array binding is vertex array state and is
+	// not tracked.
+	class StateCache
+	{
+	public:
+		static constexpr size_t MAX_UNITS = 32;
+		static constexpr size_t MAX_INDEXED_BINDINGS = 16;
+
+		struct Stats
+		{
+			size_t calls = 0;
+			size_t skipped = 0;
+		};
+
+		static StateCache& current() noexcept;
+
+		StateCache() noexcept;
+		StateCache(const StateCache&) = delete;
+		StateCache(StateCache&&) = delete;
+
+		StateCache& operator=(const StateCache&) = delete;
+		StateCache& operator=(StateCache&&) = delete;
+
+		// Objects
+		// A program in use overrides the bound pipeline, so pipelines are only used while program 0 is
+		void useProgram(unsigned int program) noexcept;
+		void bindProgramPipeline(unsigned int pipeline) noexcept;
+		void bindVertexArray(unsigned int vertex_array) noexcept;
+		void bindBuffer(GLenum target, unsigned int buffer) noexcept;
+		void bindBufferBase(GLenum target, unsigned int index, unsigned int buffer) noexcept;
+		void bindBufferRange(GLenum target, unsigned int index, unsigned int buffer, size_t offset, size_t size) noexcept;
+		void bindTextureUnit(unsigned int unit, unsigned int texture) noexcept;
+		void bindSampler(unsigned int unit, unsigned int sampler) noexcept;
+		void bindFramebuffer(GLenum target, unsigned int framebuffer) noexcept;
+
+		// Fixed function
+		void setEnabled(GLenum capability, bool enabled) noexcept;
+		void blendFunc(GLenum source, GLenum destination) noexcept;
+		void depthFunc(GLenum function) noexcept;
+		void depthMask(bool write) noexcept;
+		void cullFace(GLenum mode) noexcept;
+
+		// Invalidation, forgetting a deleted name keeps a recycled one from matching a stale binding
+		void invalidate() noexcept;
+		void forgetProgram(unsigned int program) noexcept;
+		void forgetProgramPipeline(unsigned int pipeline) noexcept;
+		void forgetVertexArray(unsigned int vertex_array) noexcept;
+		void forgetBuffer(unsigned int buffer) noexcept;
+		void forgetTexture(unsigned int texture) noexcept;
+		void forgetTextureUnits() noexcept;
+		void forgetSampler(unsigned int sampler) noexcept;
+		void forgetFramebuffer(unsigned int framebuffer) noexcept;
+
+		// Statistics, endFrame() publishes the counts of the frame that just ended
+		void endFrame() noexcept;
+		const Stats& frameStats() const noexcept;
+
+	private:
+		static constexpr unsigned int UNKNOWN = UINT32_MAX;
+
+		struct IndexedBinding
+		{
+			unsigned int buffer = UNKNOWN;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+
+		struct Capability
+		{
+			GLenum capability;
+			int state;
+		};
+
+		bool changed(bool changed) noexcept;
+		int bufferSlot(GLenum target) const noexcept;
+		int indexedSlot(GLenum target) const noexcept;
+
+		unsigned int m_program;
+		unsigned int m_programPipeline;
+		unsigned int m_vertexArray;
+		unsigned int m_readFramebuffer;
+		unsigned int m_drawFramebuffer;
+		std::array<unsigned int, 14> m_buffers;
+		std::array<std::array<IndexedBinding, MAX_INDEXED_BINDINGS>, 4> m_indexedBuffers;
+		std::array<unsigned int, MAX_UNITS> m_textures;
+		std::array<unsigned int, MAX_UNITS> m_samplers;
+
+		// -1 while unknown
+		std::array<Capability, 8> m_capabilities;
+		GLenum m_blendSource, m_blendDestination;
+		GLenum m_depthFunc;
+		int m_depthMask;
+		GLenum m_cullFace;
+
+		Stats m_frame;
+		Stats m_lastFrame;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <glad/glad.h>
 
 #include <renderer/gl/buffer.hpp>
@@ -25,6 +27,13 @@ namespace gfx::gl
 			eTexture2DMultisampleArray = GL_TEXTURE_2D_MULTISAMPLE_ARRAY
 		};
 
+		enum class Access : GLenum
+		{
+			eReadOnly = GL_READ_ONLY,
+			eWriteOnly = GL_WRITE_ONLY,
+			eReadWrite = GL_READ_WRITE
+		};
+
 		enum class Parameter : GLenum
 		{
 			eDepthStencilTextureMode = GL_DEPTH_STENCIL_TEXTURE_MODE,
@@ -55,11 +64,15 @@ namespace gfx::gl
 		Texture& operator=(const Texture& other) = delete;
 		Texture& operator=(Texture&& other) noexcept;
 
+		~Texture() noexcept;
+
 		// Bindings
 		void bind(Target target) const noexcept;
 		void unbind(Target target) const noexcept;
 		void bindUnit(int unit) const noexcept;
 		void unbindUnit(int unit) const noexcept;
+		void bindImage(unsigned int unit, int level, Access access, DataFormat format) const noexcept;
+		void bindImageLayer(unsigned int unit, int level, int layer, Access access, DataFormat format) const noexcept;
 
 		// Parameters
 		void parameter(Parameter pname, float param) noexcept;
@@ -90,6 +103,7 @@ namespace gfx::gl
 		void copySubImage1D(int level, int xoffset, int x, int y, ssize_t width) noexcept;
 		void copySubImage2D(int level, int xoffset, int yoffset, int x, int y, ssize_t width, ssize_t height) noexcept;
 		void copySubImage3D(int level, int xoffset, int yoffset, int zoffset, int x, int y, ssize_t width, ssize_t height) noexcept;
+		void copyImageSubData(Target target, int level, int x, int y, int z, Texture& dst, Target dst_target, int dst_level, int dst_x, int dst_y, int dst_z, ssize_t width, ssize_t height, ssize_t depth) const noexcept;
 
 		// Mipmap
 		void generateMipmap() noexcept;
@@ -97,11 +111,16 @@ namespace gfx::gl
 		// Texture Image
 		void getTextureImage(int level, DataFormat format, Type type, ssize_t buf_size, void* pixels) noexcept;
 
+		// Bindless, the texture parameters are immutable once a handle exists
+		uint64_t handle() const noexcept;
+		static void makeResident(uint64_t handle) noexcept;
+		static void makeNonResident(uint64_t handle) noexcept;
+
 		// Getters
 		unsigned int id() const noexcept;
 
 	private:
 
-		unsigned int m_id;
+		unsigned int m_id = 0;
 	};
 }
\ No newline at end of file
@@ -36,6 +36,7 @@ namespace gfx::gl
 	enum class Type : GLenum
 	{
 		eFloat = GL_FLOAT,
+		eHalfFloat = GL_HALF_FLOAT,
 		eDouble = GL_DOUBLE,
 		eUnsignedByte = GL_UNSIGNED_BYTE,
 		eByte = GL_BYTE,
@@ -64,6 +65,9 @@ namespace gfx::gl
 		eRG = GL_RG,
 		eRGB = GL_RGB,
 		eRGBA = GL_RGBA,
+		eBGR = GL_BGR,
+		eBGRA = GL_BGRA,
+		eRInteger = GL_RED_INTEGER,
 
 		// Sized formats
 		eR8 = GL_R8,
@@ -72,7 +76,8 @@ namespace gfx::gl
 		eR16SNorm = GL_R16_SNORM,
 		eRG8 = GL_RG8,
 		eRG8SNorm = GL_RG8_SNORM,
-		eRG16 = GL_RG16_SNORM,
+		eRG16 = GL_RG16,
+		eRG16SNorm = GL_RG16_SNORM,
 		eR3G3B2 = GL_R3_G3_B2,
 		eRGB4 = GL_RGB4,
 		eRGB5 = GL_RGB5,
@@ -94,7 +99,7 @@ namespace gfx::gl
 		eSRG8Alpha8 = GL_SRGB8_ALPHA8,
 		eR16F = GL_R16F,
 		eRG16F = GL_RG16F,
-		eRGB16F = GL_RG16F,
+		eRGB16F = GL_RGB16F,
 		eRGBA16F = GL_RGBA16F,
 		eR32F = GL_R32F,
 		eRG32F = GL_RG32F,
@@ -122,6 +127,11 @@ namespace gfx::gl
 		eRGB32UI = GL_RGB32UI,
 
 		// Depth formats
+		eDepthComponent16 = GL_DEPTH_COMPONENT16,
+		eDepthComponent24 = GL_DEPTH_COMPONENT24,
+		eDepthComponent32F = GL_DEPTH_COMPONENT32F,
+		eDepth24Stencil8 = GL_DEPTH24_STENCIL8,
+		eDepth32FStencil8 = GL_DEPTH32F_STENCIL8,
 		eStencilIndex1 = GL_STENCIL_INDEX1,
 		eStencilIndex4 = GL_STENCIL_INDEX4,
 		eStencilIndex8 = GL_STENCIL_INDEX8,
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace gfx::gl
+{
+	// Typed location of a uniform in the default block of one program, see ShaderProgram::uniform().
+	// Handles stay valid until the program is linked again.
+	template<typename T>
+	struct Uniform
+	{
+		int location = -1;
+		uint32_t count = 0;
+
+		// Byte offset of the value in the program's shadow copy
+		uint32_t offset = 0;
+
+		bool valid() const noexcept { return location >= 0; }
+	};
+
+	// Maps a C++ value type to the GLSL types it can be assigned to and the call that uploads it
+	template<typename T>
+	struct UniformTraits;
+
+	template<>
+	struct UniformTraits<float>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT; }
+		static void upload(unsigned int program, int location, int count, const float* values) noexcept { glProgramUniform1fv(program, location, count, values); }
+	};
+
+	template<>
+	struct UniformTraits<glm::vec2>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT_VEC2; }
+		static void upload(unsigned int program, int location, int count, const glm::vec2* values) noexcept { glProgramUniform2fv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::vec3>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT_VEC3; }
+		static void upload(unsigned int program, int location, int count, const glm::vec3* values) noexcept { glProgramUniform3fv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::vec4>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT_VEC4; }
+		static void upload(unsigned int program, int location, int count, const glm::vec4* values) noexcept { glProgramUniform4fv(program, location, count, &values->x); }
+	};
+
+	// Also samplers, images and booleans, which are set as integers
+	template<>
+	struct UniformTraits<int>
+	{
+		static bool accepts(GLenum type) noexcept;
+		static void upload(unsigned int program, int location, int count, const int* values) noexcept { glProgramUniform1iv(program, location, count, values); }
+	};
+
+	template<>
+	struct UniformTraits<glm::ivec2>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_INT_VEC2 || type == GL_BOOL_VEC2; }
+		static void upload(unsigned int program, int location, int count, const glm::ivec2* values) noexcept { glProgramUniform2iv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::ivec3>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_INT_VEC3 || type == GL_BOOL_VEC3; }
+		static void upload(unsigned int program, int location, int count, const glm::ivec3* values) noexcept { glProgramUniform3iv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::ivec4>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_INT_VEC4 || type == GL_BOOL_VEC4; }
+		static void upload(unsigned int program, int location, int count, const glm::ivec4* values) noexcept { glProgramUniform4iv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<unsigned int>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_UNSIGNED_INT; }
+		static void upload(unsigned int program, int location, int count, const unsigned int* values) noexcept { glProgramUniform1uiv(program, location, count, values); }
+	};
+
+	template<>
+	struct UniformTraits<glm::uvec2>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_UNSIGNED_INT_VEC2; }
+		static void upload(unsigned int program, int location, int count, const glm::uvec2* values) noexcept { glProgramUniform2uiv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::uvec3>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_UNSIGNED_INT_VEC3; }
+		static void upload(unsigned int program, int location, int count, const glm::uvec3* values) noexcept { glProgramUniform3uiv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::uvec4>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_UNSIGNED_INT_VEC4; }
+		static void upload(unsigned int program, int location, int count, const glm::uvec4* values) noexcept { glProgramUniform4uiv(program, location, count, &values->x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::mat3>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT_MAT3; }
+		static void upload(unsigned int program, int location, int count, const glm::mat3* values) noexcept { glProgramUniformMatrix3fv(program, location, count, GL_FALSE, &(*values)[0].x); }
+	};
+
+	template<>
+	struct UniformTraits<glm::mat4>
+	{
+		static bool accepts(GLenum type) noexcept { return type == GL_FLOAT_MAT4; }
+		static void upload(unsigned int program, int location, int count, const glm::mat4* values) noexcept { glProgramUniformMatrix4fv(program, location, count, GL_FALSE, &(*values)[0].x); }
+	};
+}
\ No newline at end of file
@@ -38,6 +38,7 @@ namespace gfx::gl
 
 		void bindVertexBuffer(const Buffer& buf, ptrdiff_t offset, ssize_t stride, unsigned int binding_index = 0) noexcept;
 		void bindElementBuffer(const Buffer& buf) noexcept;
+		void bindingDivisor(unsigned int binding_index, unsigned int divisor) noexcept;
 
 		void enableAttribute(unsigned int attrib_index) noexcept;
 		void disableAttribute(unsigned int attrib_index) noexcept;
@@ -110,6 +111,6 @@ namespace gfx::gl
 
 		unsigned int id() const noexcept;
 	private:
-		unsigned int m_id;
+		unsigned int m_id = 0;
 	};
 }
\ No newline at end of file
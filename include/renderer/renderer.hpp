@@ -1,9 +1,26 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
+#include <string>
+
 #include <renderer/core/camera.hpp>
+#include <renderer/core/command_bucket.hpp>
+#include <renderer/core/gpu_culling.hpp>
+#include <renderer/core/hot_reload.hpp>
+#include <renderer/core/indirect_batch.hpp>
+#include <renderer/core/instancing.hpp>
+#include <renderer/core/program_cache.hpp>
+#include <renderer/core/shader_compiler.hpp>
+#include <renderer/core/shader_variants.hpp>
+#include <renderer/core/upload_thread.hpp>
 #include <renderer/core/vertex.hpp>
 #include <renderer/gl/vertex_array.hpp>
 #include <renderer/gl/buffer.hpp>
+#include <renderer/gl/buffer_pool.hpp>
+#include <renderer/gl/framebuffer.hpp>
+#include <renderer/gl/resource_manager.hpp>
+#include <renderer/gl/ring_buffer.hpp>
 #include <renderer/gl/shader.hpp>
 #include <renderer/gl/shader_program.hpp>
 #include <renderer/gl/texture.hpp>
@@ -13,12 +30,13 @@ namespace gfx
 	class Renderer
 	{
 	public:
-		Renderer(int initial_width, int initial_height);
+		// The model is loaded on `uploads`, which has to be polled while the renderer is alive
+		Renderer(int initial_width, int initial_height, gfx::core::UploadThread& uploads);
 		Renderer(const Renderer&) = delete;
-		Renderer(Renderer&& other) = default;
+		Renderer(Renderer&& other) = delete;
 
 		Renderer& operator=(const Renderer&) = delete;
-		Renderer& operator=(Renderer&& other) = default;
+		Renderer& operator=(Renderer&& other) = delete;
 
 		void setViewport(int width, int height) noexcept;
 
@@ -32,18 +50,87 @@ namespace gfx
 		glm::vec3& lightColor() noexcept { return m_lightColor; }
 		float& lightPower() noexcept { return m_lightPower; }
 		float& modelAlpha() noexcept { return m_modelAlpha; }
+		int& objectCount() noexcept { return m_objectCount; }
+		float& objectSpacing() noexcept { return m_objectSpacing; }
+		bool& gpuCulling() noexcept { return m_gpuCulling; }
+		bool& instancing() noexcept { return m_instancing; }
+		bool& occlusionCulling() noexcept { return m_occlusionCulling; }
+
+		const gfx::core::CommandBucket::Stats& commandStats() const noexcept { return m_commands.stats(); }
+		const gfx::core::IndirectBatch::Stats& batchStats() const noexcept { return m_batch.stats(); }
+		const gfx::core::InstanceBatch::Stats& instanceStats() const noexcept { return m_instances.stats(); }
+		const gfx::core::ProgramCache::Stats& programCacheStats() const noexcept { return m_programs.stats(); }
+		const gfx::core::ShaderCompiler::Stats& compilerStats() const noexcept { return m_compiler.stats(); }
+		size_t shaderVariantCount() const noexcept { return m_variants.variantCount(); }
+
+		// Hot reload is only enabled in builds with RENDERER_HOT_RELOAD on platforms that can watch files
+		bool hotReloadEnabled() const noexcept { return m_hotReload && m_hotReload->enabled(); }
+		std::string hotReloadError() const { return m_hotReload ? m_hotReload->error() : std::string(); }
+
+		// Last shader variant that failed to compile, hot reload reports them itself while it is enabled
+		const std::string& shaderError() const noexcept { return m_shaderError; }
 
 	private:
+		struct LoadedModel;
+
+		static LoadedModel createModel(const std::vector<gfx::core::Vertex>& vertices, const std::vector<unsigned int>& indices);
+		void setModel(const LoadedModel& model);
+		void bindGeometry() noexcept;
+		void compactGeometry();
+		void reloadModel(const std::filesystem::path& path);
+		void reloadShaders(const gfx::core::HotReload::ShaderSources& sources);
+		void present() noexcept;
 
+		gfx::core::UploadThread* m_uploads;
+		gfx::gl::ResourceManager m_resources;
+		std::unique_ptr<gfx::core::HotReload> m_hotReload;
+		std::string m_shaderError;
 		gfx::core::PerspectiveCamera m_camera;
 		gfx::gl::VertexArray m_vao;
+		gfx::core::ProgramCache m_programs;
 		gfx::gl::ShaderProgram m_shader;
-		unsigned int m_vaoElements;
+		gfx::core::ShaderCompiler m_compiler;
+		gfx::core::ShaderVariants m_variants;
+		gfx::core::ShaderVariants::Id m_sceneProgram = 0;
+		gfx::gl::VertexArray m_instancedVao;
+		gfx::core::CommandBucket m_commands;
+		gfx::core::IndirectBatch m_batch;
+		gfx::core::GpuCulling m_culling;
+		gfx::core::InstanceBatch m_instances;
+		std::vector<gfx::core::Instance> m_instanceData;
+
+		// Scene target, its depth feeds the occlusion culling of the next frame. The textures are replaced on
+		// resize, so they are only reached through their handles.
+		gfx::gl::FramebufferHandle m_sceneFramebuffer;
+		gfx::gl::TextureHandle m_sceneColor;
+		gfx::gl::TextureHandle m_sceneDepth;
+		int m_viewportWidth = 0;
+		int m_viewportHeight = 0;
+
+		// Geometry, suballocated from shared vertex and index buffers
+		gfx::gl::BufferPool m_vertexPool;
+		gfx::gl::BufferPool m_indexPool;
+		gfx::gl::BufferPool::Handle m_vertices = gfx::gl::BufferPool::INVALID_HANDLE;
+		gfx::gl::BufferPool::Handle m_indices = gfx::gl::BufferPool::INVALID_HANDLE;
+		unsigned int m_vaoElements = 0;
+		glm::vec4 m_modelBounds;
+
+		// Per frame draw data and indirect commands
+		gfx::gl::RingBuffer m_frameData;
 
 		glm::vec3 m_lightPosition = glm::vec3(0.0f, 2.0f, 1.0f);
 		glm::vec3 m_lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
 		float m_lightPower = 0.50;
 
 		float m_modelAlpha = 1.0f;
+		int m_objectCount = 1;
+		float m_objectSpacing = 2.5f;
+		bool m_gpuCulling = false;
+		bool m_instancing = false;
+		bool m_occlusionCulling = true;
+
+		// Object layout last uploaded for culling
+		int m_culledObjectCount = 0;
+		float m_culledObjectSpacing = 0.0f;
 	};
 }
\ No newline at end of file
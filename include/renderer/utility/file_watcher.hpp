@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+namespace gfx::util
+{
+	// Reports files written in watched directories, through inotify on Linux and not at all elsewhere.
+	//
+	// A background thread reads the events and queues the paths of files that were closed after writing or
+	// moved into a directory, which covers editors that save through a temporary file. Directories are not
+	// watched recursively.
+	class FileWatcher
+	{
+	public:
+		FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher(FileWatcher&&) = delete;
+
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		FileWatcher& operator=(FileWatcher&&) = delete;
+
+		~FileWatcher();
+
+		// Returns false when the directory cannot be watched
+		bool watch(const std::filesystem::path& directory);
+
+		// Any thread, the files changed since the last call, each listed once
+		std::vector<std::filesystem::path> changes();
+
+		// Getters
+		bool supported() const noexcept;
+
+	private:
+		void watchLoop();
+
+		int m_inotify = -1;
+		int m_stop = -1;
+		std::thread m_thread;
+
+		std::mutex m_mutex;
+		tsl::robin_map<int, std::filesystem::path> m_directories;
+		std::vector<std::filesystem::path> m_changes;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <renderer/utility/spsc_queue.hpp>
+
+namespace gfx::util
+{
+	// CPU profiler for scoped zones, recorded on any thread and collected once per frame.
+	//
+	// Every thread records into its own lock-free ring, allocated and named by registerThread() before the
+	// thread records anything, so recording never allocates. Zones of unregistered threads count as dropped.
+	// endFrame() drains the rings on the collecting thread and keeps the events of the last frames, which are
+	// written as Chrome trace JSON (chrome://tracing, Perfetto). Events are dropped when a ring fills up before
+	// the next endFrame(). Disabled at runtime a zone costs a relaxed load, without RENDERER_PROFILE the
+	// RENDERER_PROFILE_SCOPE macro compiles to nothing.
+	class Profiler
+	{
+	public:
+		static constexpr size_t RING_CAPACITY = 16 * 1024;
+		static constexpr size_t MAX_FRAMES = 300;
+
+		// Track of the zones measured on the GPU
+		static constexpr uint32_t GPU_THREAD = UINT32_MAX;
+
+		// Names must outlive the profiler, e.g. string literals
+		struct Event
+		{
+			const char* name = nullptr;
+			uint64_t begin = 0;
+			uint64_t end = 0;
+			uint32_t thread = 0;
+		};
+
+		struct Frame
+		{
+			uint64_t begin = 0;
+			uint64_t end = 0;
+			std::vector<Event> events;
+		};
+
+		static Profiler& instance() noexcept;
+
+		Profiler() = default;
+		Profiler(const Profiler&) = delete;
+		Profiler(Profiler&&) = delete;
+
+		Profiler& operator=(const Profiler&) = delete;
+		Profiler& operator=(Profiler&&) = delete;
+
+		static bool enabled() noexcept { return s_enabled.load(std::memory_order_relaxed); }
+		static void setEnabled(bool enabled) noexcept { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+		// Nanoseconds of a steady clock
+		static uint64_t now() noexcept
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Any thread, registering again only renames the thread
+		void registerThread(std::string name);
+		void record(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+		// Collecting thread, GPU zones already moved to the clock of now(). They join the next frame that ends.
+		void recordGpu(const char* name, uint64_t begin, uint64_t end);
+
+		// Collecting thread, once per frame. Events recorded before the call belong to the frame that ends.
+		void endFrame();
+		void clear();
+
+		// Collecting thread, the frames kept so far
+		void writeChromeTrace(std::ostream& os) const;
+		bool writeChromeTrace(const std::filesystem::path& path) const;
+
+		// Getters, the last frame is empty until a frame ended while enabled
+		const Frame& lastFrame() const noexcept;
+		size_t droppedEvents() const noexcept;
+
+	private:
+		struct ThreadRing
+		{
+			explicit ThreadRing(uint32_t id) : events(RING_CAPACITY), id(id) {}
+
+			SpscQueue<Event> events;
+			std::atomic<size_t> dropped = 0;
+			std::string name;
+			uint32_t id;
+		};
+
+		struct ThreadSlot
+		{
+			Profiler* owner = nullptr;
+			ThreadRing* ring = nullptr;
+		};
+
+		// The calling thread's ring, only valid while the owner is this profiler
+		static ThreadSlot& threadSlot() noexcept;
+
+		static inline std::atomic<bool> s_enabled = false;
+
+		// Only taken to register a ring, rename a thread and drain the rings
+		mutable std::mutex m_mutex;
+		std::vector<std::unique_ptr<ThreadRing>> m_rings;
+		std::atomic<size_t> m_unregistered = 0;
+
+		std::vector<Event> m_gpuEvents;
+		std::deque<Frame> m_frames;
+		Frame m_lastFrame;
+		uint64_t m_frameBegin = 0;
+		size_t m_dropped = 0;
+	};
+
+	// Records the lifetime of the scope as a zone, unless the profiler was disabled when it began
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name) noexcept :
+			m_name(Profiler::enabled() ? name : nullptr),
+			m_begin(m_name ? Profiler::now() : 0)
+		{
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope(ProfileScope&&) = delete;
+
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		ProfileScope& operator=(ProfileScope&&) = delete;
+
+		~ProfileScope() noexcept
+		{
+			if (m_name)
+				Profiler::instance().record(m_name, m_begin, Profiler::now());
+		}
+
+	private:
+		const char* m_name;
+		uint64_t m_begin;
+	};
+}
+
+#define RENDERER_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RENDERER_PROFILE_CONCAT(a, b) RENDERER_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef RENDERER_PROFILE
+#define RENDERER_PROFILE_SCOPE(name) ::gfx::util::ProfileScope RENDERER_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define RENDERER_PROFILE_SCOPE(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gfx::util
+{
+	// 32 bit handle to an element of a SlotMap<T>, a slot index in the low bits and the slot generation in the
+	// high bits. The zero handle is never issued and stands for no element.
+	template<typename T>
+	struct Handle
+	{
+		static constexpr uint32_t INDEX_BITS = 20;
+		static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr uint32_t MAX_GENERATION = (1u << GENERATION_BITS) - 1;
+
+		uint32_t value = 0;
+
+		uint32_t index() const noexcept { return value & INDEX_MASK; }
+		uint32_t generation() const noexcept { return value >> INDEX_BITS; }
+
+		explicit operator bool() const noexcept { return value != 0; }
+		bool operator==(const Handle& other) const noexcept = default;
+
+		static Handle make(uint32_t index, uint32_t generation) noexcept
+		{
+			return { (generation << INDEX_BITS) | index };
+		}
+	};
+
+	// Dense storage addressed through generational handles.
+	//
+	// Elements are packed in insertion order with swap and pop removal, so iteration touches live elements
+	// only, while handles go through a slot table for O(1) lookup. Removing an element bumps the generation of
+	// its slot, which turns every outstanding handle to it stale. Slots whose generation is exhausted are
+	// retired instead of wrapping around.
+	template<typename T>
+	class SlotMap
+	{
+	public:
+		using handle_type = Handle<T>;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		SlotMap() = default;
+		SlotMap(const SlotMap&) = delete;
+		SlotMap(SlotMap&&) = default;
+
+		SlotMap& operator=(const SlotMap&) = delete;
+		SlotMap& operator=(SlotMap&&) = default;
+
+		// Insertion, throws when all slot indices are in use
+		template<typename... Args>
+		handle_type emplace(Args&&... args)
+		{
+			uint32_t index;
+			if (m_freeHead != NONE)
+			{
+				index = m_freeHead;
+				m_freeHead = m_slots[index].target;
+			}
+			else
+			{
+				if (m_slots.size() > handle_type::INDEX_MASK)
+					throw std::length_error("slot map is out of slot indices");
+
+				index = (uint32_t)m_slots.size();
+				m_slots.push_back({ NONE, 1 });
+			}
+
+			m_values.emplace_back(std::forward<Args>(args)...);
+			m_valueSlots.push_back(index);
+
+			auto& slot = m_slots[index];
+			slot.target = (uint32_t)(m_values.size() - 1);
+
+			return handle_type::make(index, slot.generation);
+		}
+
+		handle_type insert(T&& value)
+		{
+			return emplace(std::move(value));
+		}
+
+		// Removal, returns false for stale handles
+		bool erase(handle_type handle)
+		{
+			if (!contains(handle))
+				return false;
+
+			const auto index = handle.index();
+			auto& slot = m_slots[index];
+			const auto dense = slot.target;
+			const auto last = (uint32_t)(m_values.size() - 1);
+
+			if (dense != last)
+			{
+				m_values[dense] = std::move(m_values[last]);
+				m_valueSlots[dense] = m_valueSlots[last];
+				m_slots[m_valueSlots[dense]].target = dense;
+			}
+
+			m_values.pop_back();
+			m_valueSlots.pop_back();
+			release(index);
+
+			return true;
+		}
+
+		void clear()
+		{
+			for (const auto index : m_valueSlots)
+				release(index);
+
+			m_values.clear();
+			m_valueSlots.clear();
+		}
+
+		// Lookup, null for stale handles
+		bool contains(handle_type handle) const noexcept
+		{
+			const auto index = handle.index();
+			return index < m_slots.size() && m_slots[index].generation == handle.generation() && handle.generation() != RETIRED;
+		}
+
+		T* get(handle_type handle) noexcept
+		{
+			return contains(handle) ? &m_values[m_slots[handle.index()].target] : nullptr;
+		}
+
+		const T* get(handle_type handle) const noexcept
+		{
+			return contains(handle) ? &m_values[m_slots[handle.index()].target] : nullptr;
+		}
+
+		// Iteration over live elements, in no particular order
+		iterator begin() noexcept { return m_values.begin(); }
+		iterator end() noexcept { return m_values.end(); }
+		const_iterator begin() const noexcept { return m_values.begin(); }
+		const_iterator end() const noexcept { return m_values.end(); }
+
+		// Handle of the element at a position of the iteration order
+		handle_type handleAt(size_t position) const noexcept
+		{
+			const auto index = m_valueSlots[position];
+			return handle_type::make(index, m_slots[index].generation);
+		}
+
+		// Getters
+		size_t size() const noexcept { return m_values.size(); }
+		bool empty() const noexcept { return m_values.empty(); }
+
+	private:
+		static constexpr uint32_t NONE = UINT32_MAX;
+		static constexpr uint32_t RETIRED = 0;
+
+		struct Slot
+		{
+			// Position in the dense arrays while used, next free slot while free
+			uint32_t target;
+			uint32_t generation;
+		};
+
+		void release(uint32_t index) noexcept
+		{
+			auto& slot = m_slots[index];
+			if (slot.generation < handle_type::MAX_GENERATION)
+			{
+				slot.generation++;
+				slot.target = m_freeHead;
+				m_freeHead = index;
+			}
+			else
+			{
+				slot.target = NONE;
+				slot.generation = RETIRED;
+			}
+		}
+
+		std::vector<T> m_values;
+		std::vector<uint32_t> m_valueSlots;
+		std::vector<Slot> m_slots;
+		uint32_t m_freeHead = NONE;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gfx::util
+{
+	// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	//
+	// The head and tail indices live on separate cache lines and each side caches the other's index, so the
+	// shared atomics are only touched when the cached view says the queue looks full or empty.
+	template<typename T>
+	class SpscQueue
+	{
+	public:
+		explicit SpscQueue(size_t capacity) :
+			m_slots(capacity + 1)
+		{
+			if (capacity == 0)
+				throw std::invalid_argument("queue capacity must not be zero");
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue(SpscQueue&&) = delete;
+
+		SpscQueue& operator=(const SpscQueue&) = delete;
+		SpscQueue& operator=(SpscQueue&&) = delete;
+
+		// Producer, returns false and leaves `value` untouched when full
+		bool tryPush(T&& value)
+		{
+			const auto tail = m_tail.load(std::memory_order_relaxed);
+			const auto next = increment(tail);
+
+			if (next == m_cachedHead)
+			{
+				m_cachedHead = m_head.load(std::memory_order_acquire);
+				if (next == m_cachedHead)
+					return false;
+			}
+
+			m_slots[tail] = std::move(value);
+			m_tail.store(next, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer, front() is null when empty and stays valid until pop()
+		T* front() noexcept
+		{
+			const auto head = m_head.load(std::memory_order_relaxed);
+			if (head == m_cachedTail)
+			{
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if (head == m_cachedTail)
+					return nullptr;
+			}
+
+			return &*m_slots[head];
+		}
+
+		void pop() noexcept
+		{
+			const auto head = m_head.load(std::memory_order_relaxed);
+			m_slots[head].reset();
+			m_head.store(increment(head), std::memory_order_release);
+		}
+
+		std::optional<T> tryPop()
+		{
+			auto* value = front();
+			if (!value)
+				return std::nullopt;
+
+			std::optional<T> result(std::move(*value));
+			pop();
+			return result;
+		}
+
+		size_t capacity() const noexcept
+		{
+			return m_slots.size() - 1;
+		}
+
+	private:
+		size_t increment(size_t index) const noexcept
+		{
+			return index + 1 == m_slots.size() ? 0 : index + 1;
+		}
+
+		static constexpr size_t CACHE_LINE = 64;
+
+		std::vector<std::optional<T>> m_slots;
+
+		alignas(CACHE_LINE) std::atomic<size_t> m_head = 0;
+		size_t m_cachedTail = 0;
+
+		alignas(CACHE_LINE) std::atomic<size_t> m_tail = 0;
+		size_t m_cachedHead = 0;
+	};
+}
\ No newline at end of file
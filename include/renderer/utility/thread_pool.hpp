@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gfx::util
+{
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		~ThreadPool();
+
+		// Queue a task without a result, tasks are dequeued in submission order.
+		void post(std::function<void()> task);
+
+		template<typename F>
+		auto submit(F&& func) -> std::future<std::invoke_result_t<F>>
+		{
+			using Result = std::invoke_result_t<F>;
+
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+			auto future = task->get_future();
+			post([task]() { (*task)(); });
+			return future;
+		}
+
+		// Blocks until the queue is empty and every worker is idle.
+		void waitIdle();
+
+		size_t threadCount() const noexcept;
+		size_t pendingCount() const;
+
+	private:
+		void workerLoop();
+
+		std::vector<std::thread> m_workers;
+		std::deque<std::function<void()>> m_tasks;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		std::condition_variable m_idle;
+		size_t m_active = 0;
+		bool m_stopping = false;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gfx::util
+{
+	// Two level segregated fit allocator over an abstract range of offsets, such as a GPU buffer.
+	//
+	// Allocation and free are O(1): free blocks are kept in power of two classes split into 16 linear
+	// subclasses with a bitmap per level, and neighbouring free blocks are coalesced immediately. Block
+	// bookkeeping lives outside the managed range, so it can be memory the CPU cannot access.
+	class TlsfAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+
+		struct Stats
+		{
+			size_t capacity = 0;
+			size_t used = 0;
+			size_t largest_free = 0;
+			size_t allocations = 0;
+			size_t free_blocks = 0;
+		};
+
+		TlsfAllocator(size_t capacity);
+
+		// Smallest capacity an empty allocator needs to serve allocate(size, alignment), the free block search
+		// rounds requests up to the next subclass
+		static size_t requiredCapacity(size_t size, size_t alignment = 1) noexcept;
+
+		// Returns INVALID_BLOCK when no free block fits, alignment does not need to be a power of two.
+		uint32_t allocate(size_t size, size_t alignment = 1, uint32_t user_data = 0) noexcept;
+		void free(uint32_t block) noexcept;
+
+		// Blocks
+		size_t offset(uint32_t block) const noexcept;
+		size_t size(uint32_t block) const noexcept;
+		uint32_t userData(uint32_t block) const noexcept;
+		bool isFree(uint32_t block) const noexcept;
+
+		// Physical order, from the end of the range for compaction
+		uint32_t lastBlock() const noexcept;
+		uint32_t previousBlock(uint32_t block) const noexcept;
+
+		// Getters
+		size_t capacity() const noexcept;
+		size_t used() const noexcept;
+		Stats stats() const noexcept;
+
+	private:
+		static constexpr uint32_t SL_BITS = 4;
+		static constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+		static constexpr uint32_t FL_COUNT = 58;
+
+		struct Block
+		{
+			size_t offset = 0;
+			size_t size = 0;
+			uint32_t prev_physical = INVALID_BLOCK;
+			uint32_t next_physical = INVALID_BLOCK;
+			uint32_t prev_free = INVALID_BLOCK;
+			uint32_t next_free = INVALID_BLOCK;
+			uint32_t user_data = 0;
+			bool free = false;
+		};
+
+		uint32_t createBlock() noexcept;
+		void destroyBlock(uint32_t block) noexcept;
+		void insertFree(uint32_t block) noexcept;
+		void removeFree(uint32_t block) noexcept;
+		uint32_t splitFront(uint32_t block, size_t size) noexcept;
+		uint32_t findFree(size_t size) const noexcept;
+
+		std::vector<Block> m_blocks;
+		std::vector<uint32_t> m_unusedBlocks;
+
+		uint64_t m_flBitmap = 0;
+		std::array<uint32_t, FL_COUNT> m_slBitmaps{};
+		std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_heads;
+
+		uint32_t m_last;
+		size_t m_capacity;
+		size_t m_used = 0;
+		size_t m_allocations = 0;
+	};
+}
\ No newline at end of file
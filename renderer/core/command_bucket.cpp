@@ -0,0 +1,204 @@
+#include <renderer/core/command_bucket.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include <renderer/gl/gpu_timer.hpp>
+#include <renderer/gl/state_cache.hpp>
+
+namespace gfx::core
+{
+	namespace
+	{
+		constexpr uint32_t TRANSLUCENT_SHIFT = 64 - SortKey::PASS_BITS - SortKey::LAYER_BITS - 1;
+		constexpr uint32_t LAYER_SHIFT = TRANSLUCENT_SHIFT + 1;
+		constexpr uint32_t PASS_SHIFT = LAYER_SHIFT + SortKey::LAYER_BITS;
+
+		static_assert(TRANSLUCENT_SHIFT == SortKey::SHADER_BITS + SortKey::MATERIAL_BITS + SortKey::VERTEX_ARRAY_BITS + SortKey::DEPTH_BITS,
+			"sort key fields must fill 64 bits");
+
+		constexpr uint64_t field(uint32_t value, uint32_t bits, uint32_t shift) noexcept
+		{
+			return (uint64_t)(value & ((1u << bits) - 1)) << shift;
+		}
+	}
+
+	uint64_t SortKey::opaque(uint32_t pass, uint32_t layer, uint32_t shader, uint32_t material, uint32_t vertex_array, float depth) noexcept
+	{
+		uint32_t shift = TRANSLUCENT_SHIFT;
+
+		uint64_t key = field(pass, PASS_BITS, PASS_SHIFT) | field(layer, LAYER_BITS, LAYER_SHIFT);
+		key |= field(shader, SHADER_BITS, shift -= SHADER_BITS);
+		key |= field(material, MATERIAL_BITS, shift -= MATERIAL_BITS);
+		key |= field(vertex_array, VERTEX_ARRAY_BITS, shift -= VERTEX_ARRAY_BITS);
+		key |= field(quantizeDepth(depth), DEPTH_BITS, shift -= DEPTH_BITS);
+
+		return key;
+	}
+
+	uint64_t SortKey::translucent(uint32_t pass, uint32_t layer, uint32_t shader, uint32_t material, uint32_t vertex_array, float depth) noexcept
+	{
+		uint32_t shift = TRANSLUCENT_SHIFT;
+
+		uint64_t key = field(pass, PASS_BITS, PASS_SHIFT) | field(layer, LAYER_BITS, LAYER_SHIFT) | (1ull << TRANSLUCENT_SHIFT);
+		key |= field(~quantizeDepth(depth), DEPTH_BITS, shift -= DEPTH_BITS);
+		key |= field(shader, SHADER_BITS, shift -= SHADER_BITS);
+		key |= field(material, MATERIAL_BITS, shift -= MATERIAL_BITS);
+		key |= field(vertex_array, VERTEX_ARRAY_BITS, shift -= VERTEX_ARRAY_BITS);
+
+		return key;
+	}
+
+	uint32_t SortKey::pass(uint64_t key) noexcept
+	{
+		return (uint32_t)(key >> PASS_SHIFT);
+	}
+
+	uint32_t SortKey::layer(uint64_t key) noexcept
+	{
+		return (uint32_t)(key >> LAYER_SHIFT) & ((1u << LAYER_BITS) - 1);
+	}
+
+	bool SortKey::isTranslucent(uint64_t key) noexcept
+	{
+		return (key >> TRANSLUCENT_SHIFT) & 1;
+	}
+
+	uint32_t SortKey::quantizeDepth(float depth) noexcept
+	{
+		constexpr uint32_t max_depth = (1u << DEPTH_BITS) - 1;
+
+		// Also maps NaN to 0
+		if (!(depth > 0.0f))
+			return 0;
+		if (depth >= 1.0f)
+			return max_depth;
+
+		return (uint32_t)(depth * (float)max_depth);
+	}
+
+	CommandBucket::CommandBucket(size_t reserve)
+	{
+		m_commands.reserve(reserve);
+		m_entries.reserve(reserve);
+		m_scratch.reserve(reserve);
+	}
+
+	DrawCommand& CommandBucket::add(uint64_t key)
+	{
+		m_entries.push_back({ key, (uint32_t)m_commands.size() });
+		m_sorted = false;
+
+		return m_commands.emplace_back();
+	}
+
+	void CommandBucket::clear() noexcept
+	{
+		m_commands.clear();
+		m_entries.clear();
+		m_data.clear();
+		m_sorted = true;
+	}
+
+	void CommandBucket::sort()
+	{
+		if (m_sorted)
+			return;
+
+		// Least significant digit first, 8 bits per pass. Every histogram is built in a single read of the
+		// keys, and digits shared by all keys are skipped since that pass would not move anything.
+		constexpr size_t passes = sizeof(uint64_t);
+		std::array<std::array<uint32_t, 256>, passes> histograms{};
+
+		for (const auto& entry : m_entries)
+		{
+			for (size_t pass = 0; pass < passes; pass++)
+				histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+		}
+
+		m_scratch.resize(m_entries.size());
+
+		for (size_t pass = 0; pass < passes; pass++)
+		{
+			auto& histogram = histograms[pass];
+			const auto shift = pass * 8;
+
+			if (histogram[(m_entries.front().key >> shift) & 0xFF] == m_entries.size())
+				continue;
+
+			uint32_t offset = 0;
+			for (auto& count : histogram)
+			{
+				const auto bucket_size = count;
+				count = offset;
+				offset += bucket_size;
+			}
+
+			for (const auto& entry : m_entries)
+				m_scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+
+			std::swap(m_entries, m_scratch);
+		}
+
+		m_sorted = true;
+	}
+
+	void CommandBucket::submit()
+	{
+		RENDERER_PROFILE_GPU_SCOPE("CommandBucket::submit");
+		sort();
+
+		m_stats = {};
+		auto& state = gl::StateCache::current();
+
+		const gl::ShaderProgram* program = nullptr;
+		const gl::VertexArray* vertex_array = nullptr;
+		int translucent = -1;
+
+		for (const auto& entry : m_entries)
+		{
+			const auto& command = m_commands[entry.command];
+
+			if (const int entry_translucent = SortKey::isTranslucent(entry.key); entry_translucent != translucent)
+			{
+				state.setEnabled(GL_BLEND, entry_translucent);
+				state.depthMask(!entry_translucent);
+				translucent = entry_translucent;
+			}
+
+			if (command.program != program)
+			{
+				command.program->bind();
+				program = command.program;
+				m_stats.program_changes++;
+			}
+
+			if (command.vertex_array != vertex_array)
+			{
+				command.vertex_array->bind();
+				vertex_array = command.vertex_array;
+				m_stats.vertex_array_changes++;
+			}
+
+			if (command.apply)
+				command.apply(*command.program, m_data.data() + command.data);
+
+			glDrawElementsBaseVertex(command.mode, command.count, command.index_type, (const void*)command.index_offset, command.base_vertex);
+
+			m_stats.draws++;
+			m_stats.translucent_draws += translucent;
+		}
+
+		state.depthMask(true);
+	}
+
+	size_t CommandBucket::size() const noexcept
+	{
+		return m_commands.size();
+	}
+
+	const CommandBucket::Stats& CommandBucket::stats() const noexcept
+	{
+		return m_stats;
+	}
+}
\ No newline at end of file
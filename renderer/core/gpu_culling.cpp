@@ -0,0 +1,271 @@
+#include <renderer/core/gpu_culling.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <renderer/core/shader_loader.hpp>
+#include <renderer/gl/block_layout.hpp>
+#include <renderer/gl/gpu_timer.hpp>
+#include <renderer/gl/types.hpp>
+#include <renderer/shaders/cull_comp.hpp>
+#include <renderer/shaders/depth_pyramid_comp.hpp>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	namespace
+	{
+		constexpr uint32_t CULL_GROUP_SIZE = 64;
+		constexpr uint32_t PYRAMID_GROUP_SIZE = 8;
+
+		using DrawElementsIndirectCommand = IndirectBatch::DrawElementsIndirectCommand;
+
+		// Slots generated from the shaders at build time
+		namespace cull_shader = shaders::cull_comp;
+		namespace pyramid_shader = shaders::depth_pyramid_comp;
+
+		// Matches `Draw` in shaders/indirect.vert
+		struct Draw
+		{
+			glm::mat4 model;
+			glm::vec4 params;
+		};
+
+		static_assert(blockMember<BlockLayout::eStd430, glm::mat4>(offsetof(Draw, model)));
+		static_assert(blockMember<BlockLayout::eStd430, glm::vec4>(offsetof(Draw, params)));
+		static_assert(blockSize<BlockLayout::eStd430, Draw, glm::mat4, glm::vec4>());
+
+		// Objects are read as an std430 array in shaders/cull.comp
+		using Object = GpuCulling::Object;
+		static_assert(blockMember<BlockLayout::eStd430, glm::mat4>(offsetof(Object, model)));
+		static_assert(blockMember<BlockLayout::eStd430, glm::vec4>(offsetof(Object, bounds)));
+		static_assert(blockMember<BlockLayout::eStd430, glm::vec4>(offsetof(Object, params)));
+		static_assert(blockMember<BlockLayout::eStd430, uint32_t>(offsetof(Object, count)));
+		static_assert(blockMember<BlockLayout::eStd430, uint32_t>(offsetof(Object, first_index)));
+		static_assert(blockMember<BlockLayout::eStd430, int32_t>(offsetof(Object, base_vertex)));
+		static_assert(blockSize<BlockLayout::eStd430, Object, glm::mat4, glm::vec4, uint32_t>());
+
+		// Normalized planes of the clip volume, pointing inwards
+		std::array<glm::vec4, 6> frustumPlanes(const glm::mat4& view_projection) noexcept
+		{
+			const auto row = [&](int i) { return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]); };
+
+			std::array<glm::vec4, 6> planes = {
+				row(3) + row(0), row(3) - row(0),
+				row(3) + row(1), row(3) - row(1),
+				row(3) + row(2), row(3) - row(2)
+			};
+
+			for (auto& plane : planes)
+				plane /= glm::length(glm::vec3(plane));
+
+			return planes;
+		}
+
+		void linkCompute(ShaderProgram& program, std::string_view resource, ShaderFeatures features = ShaderFeatures::eNone)
+		{
+			const std::string path(resource);
+			Shader shader = shaderFromResource(Shader::Target::eCompute, path, features);
+
+			program.attachShader(shader);
+			program.link();
+			program.detachShader(shader);
+
+			if ((program.flags() & ShaderProgram::TargetFlags::eCompute) != ShaderProgram::TargetFlags::eCompute)
+				throw std::runtime_error("'" + path + "' did not link a compute stage");
+		}
+	}
+
+	GpuCulling::GpuCulling(size_t max_objects) :
+		m_maxObjects(max_objects),
+		m_pyramid(Texture::Target::eTexture2D)
+	{
+		if (max_objects == 0)
+			throw std::invalid_argument("culling needs room for at least one object");
+
+		linkCompute(m_cullProgram, cull_shader::RESOURCE);
+		linkCompute(m_occlusionCullProgram, cull_shader::RESOURCE, ShaderFeatures::eOcclusionCulling);
+		linkCompute(m_pyramidProgram, pyramid_shader::RESOURCE);
+
+		// Device local, only the object list and counters are written from the CPU
+		m_objects.bufferStorage(sizeof(Object) * max_objects, nullptr, Buffer::StorageFlags::eDynamicStorageBit);
+		m_dispatch.bufferStorage(sizeof(DispatchCommand), nullptr, Buffer::StorageFlags::eDynamicStorageBit);
+		m_commands.bufferStorage(sizeof(DrawElementsIndirectCommand) * max_objects, nullptr, (Buffer::StorageFlags)0);
+		m_draws.bufferStorage(sizeof(Draw) * max_objects, nullptr, (Buffer::StorageFlags)0);
+		m_visibleCount.bufferStorage(sizeof(uint32_t), nullptr, Buffer::StorageFlags::eDynamicStorageBit);
+
+		const DispatchCommand empty{ 0, 1, 1, 0 };
+		m_dispatch.bufferSubData(0, sizeof(empty), &empty);
+
+		// Texture units are part of the shaders, only the values need handles
+		m_frustumPlanesUniform = m_cullProgram.uniform<glm::vec4>(cull_shader::uniforms::FrustumPlanes.location);
+		m_occlusionFrustumPlanesUniform = m_occlusionCullProgram.uniform<glm::vec4>(cull_shader::uniforms::FrustumPlanes.location);
+		m_previousViewProjectionUniform = m_occlusionCullProgram.uniform<glm::mat4>(cull_shader::uniforms::PreviousViewProjection.location);
+		m_sourceLevelUniform = m_pyramidProgram.uniform<int>(pyramid_shader::uniforms::SourceLevel.location);
+	}
+
+	void GpuCulling::setObjects(const std::vector<Object>& objects)
+	{
+		if (objects.size() > m_maxObjects)
+			throw std::invalid_argument("object count exceeds the culling capacity");
+
+		if (!objects.empty())
+			m_objects.bufferSubData(0, sizeof(Object) * objects.size(), objects.data());
+
+		const auto groups = (uint32_t)((objects.size() + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE);
+		const DispatchCommand dispatch{ groups, 1, 1, (uint32_t)objects.size() };
+		m_dispatch.bufferSubData(0, sizeof(dispatch), &dispatch);
+
+		m_objectCount = objects.size();
+	}
+
+	void GpuCulling::cull(const glm::mat4& view_projection)
+	{
+		RENDERER_PROFILE_GPU_SCOPE("GpuCulling::cull");
+		m_viewProjection = view_projection;
+
+		const uint32_t zero = 0;
+		m_visibleCount.bufferSubData(0, sizeof(zero), &zero);
+
+		if (m_objectCount == 0)
+			return;
+
+		const auto planes = frustumPlanes(view_projection);
+		const auto occlusion = m_occlusionCulling && m_pyramidValid;
+
+		if (occlusion)
+		{
+			m_occlusionCullProgram.bind();
+			m_occlusionCullProgram.set(m_occlusionFrustumPlanesUniform, planes.data(), (uint32_t)planes.size());
+			m_occlusionCullProgram.set(m_previousViewProjectionUniform, m_pyramidViewProjection);
+			m_pyramid.bindUnit(cull_shader::textures::DepthPyramid.binding);
+		}
+		else
+		{
+			m_cullProgram.bind();
+			m_cullProgram.set(m_frustumPlanesUniform, planes.data(), (uint32_t)planes.size());
+		}
+
+		m_objects.bindBase(Buffer::Target::eShaderStorage, cull_shader::storage_blocks::ObjectData.binding);
+		m_commands.bindBase(Buffer::Target::eShaderStorage, cull_shader::storage_blocks::CommandData.binding);
+		m_draws.bindBase(Buffer::Target::eShaderStorage, cull_shader::storage_blocks::DrawData.binding);
+		m_dispatch.bindBase(Buffer::Target::eShaderStorage, cull_shader::storage_blocks::DispatchData.binding);
+		m_visibleCount.bindBase(Buffer::Target::eAtomicCounter, cull_shader::atomic_counters::VisibleCount.binding);
+
+		// The group count lives next to the object count on the GPU
+		m_dispatch.bind(Buffer::Target::eDispatchIndirect);
+		glDispatchComputeIndirect(0);
+
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	void GpuCulling::draw(const ShaderProgram& program, const VertexArray& vertex_array, unsigned int storage_binding) const noexcept
+	{
+		RENDERER_PROFILE_GPU_SCOPE("GpuCulling::draw");
+		if (m_objectCount == 0)
+			return;
+
+		m_commands.bind(Buffer::Target::eDrawIndirect);
+		m_visibleCount.bind(Buffer::Target::eParameter);
+		m_draws.bindBase(Buffer::Target::eShaderStorage, storage_binding);
+
+		program.bind();
+		vertex_array.bind();
+
+		glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, (GLsizei)m_objectCount, 0);
+	}
+
+	void GpuCulling::buildDepthPyramid(const Texture& depth, int width, int height)
+	{
+		RENDERER_PROFILE_GPU_SCOPE("GpuCulling::buildDepthPyramid");
+		if (width <= 0 || height <= 0)
+			throw std::invalid_argument("depth pyramid source must not be empty");
+
+		// Level 0 is half the source resolution
+		const auto pyramid_width = std::max(width / 2, 1);
+		const auto pyramid_height = std::max(height / 2, 1);
+
+		if (pyramid_width != m_pyramidWidth || pyramid_height != m_pyramidHeight)
+		{
+			m_pyramidWidth = pyramid_width;
+			m_pyramidHeight = pyramid_height;
+			m_pyramidLevels = std::bit_width((unsigned int)std::max(pyramid_width, pyramid_height));
+
+			m_pyramid = Texture(Texture::Target::eTexture2D);
+			m_pyramid.storage2D(m_pyramidLevels, DataFormat::eR32F, m_pyramidWidth, m_pyramidHeight);
+			m_pyramid.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eNearestMipmapNearest);
+			m_pyramid.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eNearest);
+			m_pyramid.parameter(Texture::Parameter::eWrapS, (int)GL_CLAMP_TO_EDGE);
+			m_pyramid.parameter(Texture::Parameter::eWrapT, (int)GL_CLAMP_TO_EDGE);
+		}
+
+		m_pyramidProgram.bind();
+
+		for (int level = 0; level < m_pyramidLevels; ++level)
+		{
+			if (level == 0)
+				depth.bindUnit(pyramid_shader::textures::Source.binding);
+			else
+				m_pyramid.bindUnit(pyramid_shader::textures::Source.binding);
+
+			m_pyramidProgram.set(m_sourceLevelUniform, std::max(level - 1, 0));
+			m_pyramid.bindImage(pyramid_shader::images::Destination.binding, level, Texture::Access::eWriteOnly, DataFormat::eR32F);
+
+			const auto level_width = (uint32_t)std::max(m_pyramidWidth >> level, 1);
+			const auto level_height = (uint32_t)std::max(m_pyramidHeight >> level, 1);
+			glDispatchCompute((level_width + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, (level_height + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		}
+
+		m_pyramidViewProjection = m_viewProjection;
+		m_pyramidValid = true;
+	}
+
+	void GpuCulling::setOcclusionCulling(bool enabled) noexcept
+	{
+		m_occlusionCulling = enabled;
+	}
+
+	uint32_t GpuCulling::readVisibleCount() const noexcept
+	{
+		uint32_t count = 0;
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		m_visibleCount.getSubData(0, sizeof(count), &count);
+		return count;
+	}
+
+	std::vector<DrawElementsIndirectCommand> GpuCulling::readCommands() const
+	{
+		std::vector<DrawElementsIndirectCommand> commands(readVisibleCount());
+		if (!commands.empty())
+			m_commands.getSubData(0, sizeof(DrawElementsIndirectCommand) * commands.size(), commands.data());
+		return commands;
+	}
+
+	size_t GpuCulling::objectCount() const noexcept
+	{
+		return m_objectCount;
+	}
+
+	size_t GpuCulling::maxObjects() const noexcept
+	{
+		return m_maxObjects;
+	}
+
+	bool GpuCulling::occlusionCulling() const noexcept
+	{
+		return m_occlusionCulling;
+	}
+
+	const Texture& GpuCulling::depthPyramid() const noexcept
+	{
+		return m_pyramid;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <renderer/core/hot_reload.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <shader_preprocessor/preprocessor.hpp>
+#include <shader_preprocessor/reflector.hpp>
+
+#include <renderer/utility/profiler.hpp>
+
+#ifdef RENDERER_RC_ENABLED
+#include <cmrc/cmrc.hpp>
+CMRC_DECLARE(rc);
+#endif
+
+namespace gfx::core
+{
+	namespace
+	{
+		constexpr const char* SHADER_EXTENSIONS[] = { ".vert", ".frag", ".comp" };
+
+		struct ProcessedShaders
+		{
+			HotReload::ShaderSources sources;
+			std::string error;
+		};
+
+		// The embedded shaders were processed by the build and carry its slots as explicit layouts. Reserving them
+		// first keeps every existing name on the slot of the generated header constants the renderer binds with,
+		// only declarations added since get free slots.
+		void reserveBuildSlots(shpp::SlotAllocator& allocator, const std::vector<std::filesystem::path>& paths)
+		{
+#ifdef RENDERER_RC_ENABLED
+			const auto rcfs = cmrc::rc::get_filesystem();
+			for (const auto& path : paths)
+			{
+				const auto resource = "shaders/" + path.filename().string();
+				if (!rcfs.exists(resource))
+					continue;
+
+				const auto data = rcfs.open(resource);
+				shpp::ShaderFile file;
+				file.path = path;
+				file.stage = shpp::stageFromPath(path);
+				file.source.assign(data.begin(), data.end());
+				file.files.push_back(path);
+
+				shpp::reflect(file);
+				allocator.reserve(file);
+			}
+#endif
+		}
+
+		ProcessedShaders processShaderDirectory(const std::filesystem::path& directory)
+		{
+			RENDERER_PROFILE_SCOPE("HotReload::processShaders");
+
+			ProcessedShaders result;
+			try
+			{
+				std::vector<std::filesystem::path> paths;
+				for (const auto& entry : std::filesystem::directory_iterator(directory))
+				{
+					const auto extension = entry.path().extension();
+					const auto shader = std::find(std::begin(SHADER_EXTENSIONS), std::end(SHADER_EXTENSIONS), extension) != std::end(SHADER_EXTENSIONS);
+					if (entry.is_regular_file() && shader)
+						paths.push_back(entry.path());
+				}
+
+				// One sorted list like the glob of the build, slots are assigned in file order
+				std::sort(paths.begin(), paths.end());
+
+				shpp::Preprocessor preprocessor;
+				preprocessor.addIncludeDirectory(directory / "include");
+
+				std::vector<shpp::ShaderFile> files;
+				for (const auto& path : paths)
+				{
+					auto file = preprocessor.process(path);
+					shpp::reflect(file);
+					files.push_back(std::move(file));
+				}
+
+				shpp::SlotAllocator allocator;
+				reserveBuildSlots(allocator, paths);
+				for (const auto& file : files)
+					allocator.reserve(file);
+
+				for (auto& file : files)
+				{
+					allocator.assign(file);
+					result.sources.emplace("shaders/" + file.path.filename().string(), std::move(file.source));
+				}
+			}
+			catch (const std::exception& e)
+			{
+				result.sources.clear();
+				result.error = e.what();
+			}
+
+			return result;
+		}
+	}
+
+	HotReload::HotReload(std::filesystem::path resources, UploadThread& uploads) :
+		m_resources(std::move(resources)),
+		m_uploads(&uploads)
+	{
+		m_watcher.watch(m_resources / "shaders");
+		m_watcher.watch(m_resources / "shaders" / "include");
+	}
+
+	void HotReload::onShaders(ShaderHandler handler)
+	{
+		m_shaderHandlers.push_back(std::move(handler));
+	}
+
+	void HotReload::onFile(const std::string& resource, FileHandler handler)
+	{
+		const auto path = m_resources / resource;
+		m_watcher.watch(path.parent_path());
+		m_fileHandlers[path.lexically_normal().generic_string()] = std::move(handler);
+	}
+
+	void HotReload::update()
+	{
+		const auto shaders = (m_resources / "shaders").lexically_normal();
+		for (const auto& path : m_watcher.changes())
+		{
+			const auto normal = path.lexically_normal();
+			const auto handler = m_fileHandlers.find(normal.generic_string());
+			if (handler != m_fileHandlers.end())
+			{
+				handler->second(normal);
+				continue;
+			}
+
+			const auto parent = normal.parent_path();
+			if (parent == shaders || parent == shaders / "include")
+				m_shadersChanged = true;
+		}
+
+		if (m_shadersChanged && !m_processing && !m_shaderHandlers.empty())
+			processShaders();
+	}
+
+	void HotReload::report(const std::string& source, std::string error)
+	{
+		auto entry = std::find_if(m_errors.begin(), m_errors.end(), [&source](const auto& failure) { return failure.first == source; });
+		if (entry != m_errors.end())
+		{
+			if (error.empty())
+				m_errors.erase(entry);
+			else
+				entry->second = std::move(error);
+		}
+		else if (!error.empty())
+		{
+			m_errors.emplace_back(source, std::move(error));
+		}
+
+		m_error.clear();
+		for (const auto& failure : m_errors)
+		{
+			if (!m_error.empty())
+				m_error += '\n';
+			m_error += failure.second;
+		}
+	}
+
+	bool HotReload::enabled() const noexcept
+	{
+		return m_watcher.supported();
+	}
+
+	const std::string& HotReload::error() const noexcept
+	{
+		return m_error;
+	}
+
+	void HotReload::processShaders()
+	{
+		m_processing = true;
+		m_shadersChanged = false;
+
+		m_uploads->upload(
+			[directory = m_resources / "shaders"]() { return processShaderDirectory(directory); },
+			[this](ProcessedShaders&& result) {
+				m_processing = false;
+				const auto failed = !result.error.empty();
+				report(SHADER_SOURCE, std::move(result.error));
+				if (failed)
+					return;
+
+				for (const auto& handler : m_shaderHandlers)
+					handler(result.sources);
+			}
+		);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <renderer/core/image.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <climits>
+#include <stdexcept>
+
+#ifdef RENDERER_RC_ENABLED
+#include <cmrc/cmrc.hpp>
+CMRC_DECLARE(rc);
+#endif
+
+#include <stb_image.h>
+
+#include <renderer/utility/profiler.hpp>
+
+namespace gfx::core
+{
+	void Image::PixelDeleter::operator()(unsigned char* pixels) const noexcept
+	{
+		std::free(pixels);
+	}
+
+	size_t Image::componentSize() const noexcept
+	{
+		switch (type)
+		{
+		case gl::Type::eUnsignedShort:
+			return sizeof(uint16_t);
+		case gl::Type::eFloat:
+			return sizeof(float);
+		default:
+			return sizeof(unsigned char);
+		}
+	}
+
+	size_t Image::size() const noexcept
+	{
+		return (size_t)width * height * channels * componentSize();
+	}
+
+	bool Image::empty() const noexcept
+	{
+		return pixels == nullptr;
+	}
+
+#ifdef RENDERER_RC_ENABLED
+	Image imageFromResource(const std::string& path, int desired_channels)
+	{
+		auto rcfs = cmrc::rc::get_filesystem();
+		auto file = rcfs.open(path);
+
+		try
+		{
+			return imageFromMemory((const unsigned char*)file.cbegin(), file.size(), desired_channels);
+		}
+		catch (const std::runtime_error& e)
+		{
+			throw std::runtime_error(std::string("Unable to parse texture source file resource '") + path + "': " + e.what());
+		}
+	}
+#endif
+
+	Image imageFromMemory(const unsigned char* data, size_t size, int desired_channels)
+	{
+		RENDERER_PROFILE_SCOPE("imageFromMemory");
+		if (size > INT_MAX)
+			throw std::runtime_error("encoded image is too large");
+
+		Image image;
+		if (stbi_is_hdr_from_memory(data, (int)size))
+		{
+			image.type = gl::Type::eFloat;
+			image.pixels.reset((unsigned char*)stbi_loadf_from_memory(data, (int)size, &image.width, &image.height, &image.channels, desired_channels));
+		}
+		else if (stbi_is_16_bit_from_memory(data, (int)size))
+		{
+			image.type = gl::Type::eUnsignedShort;
+			image.pixels.reset((unsigned char*)stbi_load_16_from_memory(data, (int)size, &image.width, &image.height, &image.channels, desired_channels));
+		}
+		else
+		{
+			image.pixels.reset(stbi_load_from_memory(data, (int)size, &image.width, &image.height, &image.channels, desired_channels));
+		}
+		if (image.pixels == nullptr)
+			throw std::runtime_error(stbi_failure_reason());
+
+		if (desired_channels != 0)
+			image.channels = desired_channels;
+
+		return image;
+	}
+
+	size_t imageDecodedSize(const unsigned char* data, size_t size, int desired_channels) noexcept
+	{
+		int width, height, channels;
+		if (size > INT_MAX || !stbi_info_from_memory(data, (int)size, &width, &height, &channels))
+			return 0;
+
+		size_t component_size = sizeof(unsigned char);
+		if (stbi_is_hdr_from_memory(data, (int)size))
+			component_size = sizeof(float);
+		else if (stbi_is_16_bit_from_memory(data, (int)size))
+			component_size = sizeof(uint16_t);
+
+		return (size_t)width * height * (desired_channels != 0 ? desired_channels : channels) * component_size;
+	}
+}
\ No newline at end of file
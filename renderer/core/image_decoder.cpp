@@ -0,0 +1,164 @@
+#include <renderer/core/image_decoder.hpp>
+
+#include <utility>
+
+#ifdef RENDERER_RC_ENABLED
+#include <cmrc/cmrc.hpp>
+CMRC_DECLARE(rc);
+#endif
+
+namespace gfx::core
+{
+	ImageDecoder::ImageDecoder(util::ThreadPool& pool, size_t memory_budget) :
+		m_state(std::make_shared<State>())
+	{
+		m_state->pool = &pool;
+		m_state->budget = memory_budget;
+	}
+
+	ImageDecoder::~ImageDecoder()
+	{
+		std::deque<Job> dropped;
+		{
+			std::lock_guard lock(m_state->mutex);
+			m_state->pool = nullptr;
+			dropped.swap(m_state->queued);
+		}
+	}
+
+	std::future<Image> ImageDecoder::decode(const unsigned char* data, size_t size, int desired_channels)
+	{
+		auto promise = std::make_shared<std::promise<Image>>();
+		auto future = promise->get_future();
+		decode(data, size, promiseCallback(std::move(promise)), desired_channels);
+		return future;
+	}
+
+	std::future<Image> ImageDecoder::decode(std::vector<unsigned char> data, int desired_channels)
+	{
+		auto promise = std::make_shared<std::promise<Image>>();
+		auto future = promise->get_future();
+		decode(std::move(data), promiseCallback(std::move(promise)), desired_channels);
+		return future;
+	}
+
+	void ImageDecoder::decode(const unsigned char* data, size_t size, Callback callback, int desired_channels)
+	{
+		enqueue({ data, size, {}, desired_channels, imageDecodedSize(data, size, desired_channels), std::move(callback) });
+	}
+
+	void ImageDecoder::decode(std::vector<unsigned char> data, Callback callback, int desired_channels)
+	{
+		const size_t reservation = imageDecodedSize(data.data(), data.size(), desired_channels);
+		Job job = { nullptr, data.size(), std::move(data), desired_channels, reservation, std::move(callback) };
+		job.data = job.owned.data();
+		enqueue(std::move(job));
+	}
+
+#ifdef RENDERER_RC_ENABLED
+	std::future<Image> ImageDecoder::decodeResource(const std::string& path, int desired_channels)
+	{
+		auto promise = std::make_shared<std::promise<Image>>();
+		auto future = promise->get_future();
+		decodeResource(path, promiseCallback(std::move(promise)), desired_channels);
+		return future;
+	}
+
+	void ImageDecoder::decodeResource(const std::string& path, Callback callback, int desired_channels)
+	{
+		// Resources are embedded in the binary, no copy of the encoded data is needed
+		auto rcfs = cmrc::rc::get_filesystem();
+		auto file = rcfs.open(path);
+		decode((const unsigned char*)file.cbegin(), file.size(), std::move(callback), desired_channels);
+	}
+#endif
+
+	size_t ImageDecoder::memoryBudget() const noexcept
+	{
+		return m_state->budget;
+	}
+
+	size_t ImageDecoder::memoryInFlight() const
+	{
+		std::lock_guard lock(m_state->mutex);
+		return m_state->in_flight;
+	}
+
+	size_t ImageDecoder::queuedCount() const
+	{
+		std::lock_guard lock(m_state->mutex);
+		return m_state->queued.size();
+	}
+
+	ImageDecoder::Callback ImageDecoder::promiseCallback(std::shared_ptr<std::promise<Image>> promise)
+	{
+		return [promise = std::move(promise)](Image image, std::exception_ptr error)
+		{
+			if (error)
+				promise->set_exception(error);
+			else
+				promise->set_value(std::move(image));
+		};
+	}
+
+	void ImageDecoder::enqueue(Job job)
+	{
+		{
+			std::lock_guard lock(m_state->mutex);
+			m_state->queued.push_back(std::move(job));
+		}
+		m_state->dispatch();
+	}
+
+	void ImageDecoder::State::dispatch()
+	{
+		std::lock_guard lock(mutex);
+		while (pool != nullptr && !queued.empty())
+		{
+			auto& next = queued.front();
+			if (in_flight != 0 && in_flight + next.reservation > budget)
+				break;
+
+			in_flight += next.reservation;
+			pool->post([self = shared_from_this(), job = std::make_shared<Job>(std::move(next))]()
+			{
+				self->run(*job);
+			});
+			queued.pop_front();
+		}
+	}
+
+	void ImageDecoder::State::release(size_t bytes)
+	{
+		{
+			std::lock_guard lock(mutex);
+			in_flight -= bytes;
+		}
+		dispatch();
+	}
+
+	void ImageDecoder::State::run(Job& job)
+	{
+		// The reservation is returned when the last owner of the decoded image lets go of it
+		std::shared_ptr<void> reservation(nullptr, [self = shared_from_this(), bytes = job.reservation](void*)
+		{
+			self->release(bytes);
+		});
+
+		Image image;
+		std::exception_ptr error;
+		try
+		{
+			image = imageFromMemory(job.data, job.size, job.desired_channels);
+			image.reservation = std::move(reservation);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		// Encoded data is no longer needed, free it before handing the image over
+		std::vector<unsigned char>().swap(job.owned);
+		job.callback(std::move(image), error);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <renderer/core/indirect_batch.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+#include <renderer/gl/gpu_timer.hpp>
+
+namespace gfx::core
+{
+	IndirectBatch::IndirectBatch(size_t draw_data_size) :
+		m_drawDataSize(draw_data_size)
+	{
+		if (draw_data_size == 0)
+			throw std::invalid_argument("draw data size must not be zero");
+	}
+
+	void IndirectBatch::add(const gl::ShaderProgram& program, const gl::VertexArray& vertex_array, uint32_t count, uint32_t first_index, int32_t base_vertex, const void* draw_data)
+	{
+		const auto key = ((uint64_t)program.id() << 32) | vertex_array.id();
+
+		size_t index;
+		if (m_groupIndices.contains(key))
+		{
+			index = m_groupIndices[key];
+		}
+		else
+		{
+			index = m_groups.size();
+			m_groupIndices[key] = index;
+			m_groups.push_back({});
+		}
+
+		// Refreshed since emptied groups outlive the objects they were recorded with
+		auto& group = m_groups[index];
+		group.program = &program;
+		group.vertex_array = &vertex_array;
+
+		group.commands.push_back({ count, 1, first_index, base_vertex, 0 });
+
+		const auto offset = group.data.size();
+		group.data.resize(offset + m_drawDataSize);
+		std::memcpy(group.data.data() + offset, draw_data, m_drawDataSize);
+
+		m_size++;
+	}
+
+	void IndirectBatch::clear() noexcept
+	{
+		for (auto& group : m_groups)
+		{
+			group.commands.clear();
+			group.data.clear();
+		}
+
+		m_size = 0;
+	}
+
+	void IndirectBatch::submit(gl::RingBuffer& ring, unsigned int storage_binding)
+	{
+		RENDERER_PROFILE_GPU_SCOPE("IndirectBatch::submit");
+		m_stats = {};
+		ring.buffer().bind(gl::Buffer::Target::eDrawIndirect);
+
+		for (const auto& group : m_groups)
+		{
+			if (group.commands.empty())
+				continue;
+
+			const auto commands = ring.push(group.commands, alignof(DrawElementsIndirectCommand));
+			const auto data = ring.allocateStorage(group.data.size());
+			std::memcpy(data.data, group.data.data(), group.data.size());
+
+			ring.bindRange(gl::Buffer::Target::eShaderStorage, storage_binding, data);
+			group.program->bind();
+			group.vertex_array->bind();
+
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)commands.offset, (GLsizei)group.commands.size(), 0);
+
+			m_stats.draws += group.commands.size();
+			m_stats.batches++;
+		}
+	}
+
+	size_t IndirectBatch::drawDataSize() const noexcept
+	{
+		return m_drawDataSize;
+	}
+
+	size_t IndirectBatch::size() const noexcept
+	{
+		return m_size;
+	}
+
+	const IndirectBatch::Stats& IndirectBatch::stats() const noexcept
+	{
+		return m_stats;
+	}
+}
\ No newline at end of file
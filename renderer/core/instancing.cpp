@@ -0,0 +1,84 @@
+#include <renderer/core/instancing.hpp>
+
+#include <cstring>
+
+#include <renderer/gl/gpu_timer.hpp>
+
+namespace gfx::core
+{
+	void Instance::enableAttributes(gl::VertexArray& vertex_array, unsigned int binding_index) noexcept
+	{
+		for (unsigned int column = 0; column < 4; ++column)
+		{
+			const auto index = MODEL_ATTRIBUTE + column;
+			vertex_array.enableAttribute(index);
+			vertex_array.formatAttribute(index, 4, gl::Type::eFloat, false, offsetof(Instance, model) + sizeof(glm::vec4) * column);
+			vertex_array.bindAttribute(index, binding_index);
+		}
+
+		vertex_array.enableAttribute(PARAMS_ATTRIBUTE);
+		vertex_array.formatAttribute(PARAMS_ATTRIBUTE, 4, gl::Type::eFloat, false, offsetof(Instance, params));
+		vertex_array.bindAttribute(PARAMS_ATTRIBUTE, binding_index);
+
+		vertex_array.bindingDivisor(binding_index, 1);
+	}
+
+	InstanceBatch::InstanceBatch(gl::VertexArray& vertex_array, unsigned int binding_index) :
+		m_vertexArray(vertex_array),
+		m_bindingIndex(binding_index)
+	{
+	}
+
+	void InstanceBatch::add(uint32_t count, uint32_t first_index, int32_t base_vertex, const Instance* instances, size_t instance_count)
+	{
+		if (instance_count == 0)
+			return;
+
+		m_meshes.push_back({ count, first_index, base_vertex, (uint32_t)m_instances.size(), (uint32_t)instance_count });
+		m_instances.insert(m_instances.end(), instances, instances + instance_count);
+	}
+
+	void InstanceBatch::add(uint32_t count, uint32_t first_index, int32_t base_vertex, const std::vector<Instance>& instances)
+	{
+		add(count, first_index, base_vertex, instances.data(), instances.size());
+	}
+
+	void InstanceBatch::clear() noexcept
+	{
+		m_meshes.clear();
+		m_instances.clear();
+	}
+
+	void InstanceBatch::submit(gl::RingBuffer& ring, const gl::ShaderProgram& program)
+	{
+		RENDERER_PROFILE_GPU_SCOPE("InstanceBatch::submit");
+		m_stats = {};
+		if (m_meshes.empty())
+			return;
+
+		const auto instances = ring.push(m_instances, alignof(glm::vec4));
+		m_vertexArray.bindVertexBuffer(ring.buffer(), instances.offset, sizeof(Instance), m_bindingIndex);
+
+		program.bind();
+		m_vertexArray.bind();
+
+		for (const auto& mesh : m_meshes)
+		{
+			const auto indices = (const void*)(sizeof(unsigned int) * mesh.first_index);
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT, indices, mesh.instance_count, mesh.base_vertex, mesh.base_instance);
+
+			m_stats.draws++;
+			m_stats.instances += mesh.instance_count;
+		}
+	}
+
+	size_t InstanceBatch::size() const noexcept
+	{
+		return m_meshes.size();
+	}
+
+	const InstanceBatch::Stats& InstanceBatch::stats() const noexcept
+	{
+		return m_stats;
+	}
+}
\ No newline at end of file
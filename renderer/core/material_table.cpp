@@ -0,0 +1,228 @@
+#include <renderer/core/material_table.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	MaterialTable::MaterialTable(const Settings& settings) :
+		m_settings(settings),
+		m_bindless(settings.bindless && GLAD_GL_ARB_bindless_texture),
+		m_array(Texture::Target::eTexture2DArray)
+	{
+		if (settings.textures_per_material <= 0)
+			throw std::invalid_argument("material table requires at least one texture per material");
+
+		if (!m_bindless)
+		{
+			if (settings.array_width <= 0 || settings.array_height <= 0 || settings.array_layers <= 0)
+				throw std::invalid_argument("material texture array size must be positive");
+
+			const auto levels = (size_t)std::bit_width((unsigned int)std::max(settings.array_width, settings.array_height));
+			m_array.storage3D(levels, settings.array_format, settings.array_width, settings.array_height, settings.array_layers);
+			m_array.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eLinearMipmapLinear);
+			m_array.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eLinear);
+
+			for (int layer = settings.array_layers; layer > 0; --layer)
+				m_freeLayers.push_back(layer - 1);
+		}
+	}
+
+	MaterialTable::~MaterialTable() noexcept
+	{
+		for (const auto& [handle, references] : m_residentHandles)
+			Texture::makeNonResident(handle);
+	}
+
+	MaterialTable::MaterialId MaterialTable::create()
+	{
+		MaterialId material;
+		if (!m_freeMaterials.empty())
+		{
+			material = m_freeMaterials.back();
+			m_freeMaterials.pop_back();
+		}
+		else
+		{
+			material = (MaterialId)m_used.size();
+			m_used.push_back(false);
+			m_keys.resize(m_keys.size() + m_settings.textures_per_material, 0);
+			m_entries.resize(m_entries.size() + 2 * (size_t)m_settings.textures_per_material, 0);
+		}
+
+		m_used[material] = true;
+		for (int slot = 0; slot < m_settings.textures_per_material; ++slot)
+			markDirty(slotIndex(material, slot));
+
+		return material;
+	}
+
+	void MaterialTable::release(MaterialId material) noexcept
+	{
+		// Releasing twice would hand the slot out twice
+		if (!valid(material, 0))
+			return;
+
+		for (int slot = 0; slot < m_settings.textures_per_material; ++slot)
+			clearTexture(material, slot);
+
+		m_used[material] = false;
+		m_freeMaterials.push_back(material);
+	}
+
+	void MaterialTable::setTexture(MaterialId material, int slot, const Texture& texture)
+	{
+		if (!valid(material, slot))
+			throw std::out_of_range("material or material texture slot out of range");
+
+		clearTexture(material, slot);
+		const auto index = slotIndex(material, slot);
+
+		if (m_bindless)
+		{
+			const auto handle = texture.handle();
+			if (m_residentHandles[handle]++ == 0)
+				Texture::makeResident(handle);
+
+			m_keys[index] = handle;
+			m_entries[2 * index] = (uint32_t)handle;
+			m_entries[2 * index + 1] = (uint32_t)(handle >> 32);
+		}
+		else
+		{
+			// Every slot gets its own copy, texture names are reused once deleted so they cannot identify a layer
+			int width, height, format, levels;
+			glGetTextureLevelParameteriv(texture.id(), 0, GL_TEXTURE_WIDTH, &width);
+			glGetTextureLevelParameteriv(texture.id(), 0, GL_TEXTURE_HEIGHT, &height);
+			glGetTextureLevelParameteriv(texture.id(), 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+			glGetTextureParameteriv(texture.id(), GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+
+			if (width != m_settings.array_width || height != m_settings.array_height || format != (int)m_settings.array_format)
+				throw std::invalid_argument("material texture does not match the texture array layout");
+			if (m_freeLayers.empty())
+				throw std::runtime_error("material texture array is full");
+
+			const int layer = m_freeLayers.back();
+			m_freeLayers.pop_back();
+
+			levels = std::min(levels, (int)std::bit_width((unsigned int)std::max(width, height)));
+			for (int level = 0; level < levels; ++level)
+			{
+				texture.copyImageSubData(Texture::Target::eTexture2D, level, 0, 0, 0,
+					m_array, Texture::Target::eTexture2DArray, level, 0, 0, layer,
+					std::max(width >> level, 1), std::max(height >> level, 1), 1);
+			}
+
+			m_keys[index] = (uint64_t)layer + 1;
+			m_entries[2 * index] = (uint32_t)layer + 1;
+			m_entries[2 * index + 1] = 0;
+		}
+
+		markDirty(index);
+	}
+
+	void MaterialTable::clearTexture(MaterialId material, int slot) noexcept
+	{
+		if (!valid(material, slot))
+			return;
+
+		const auto index = slotIndex(material, slot);
+		const auto key = m_keys[index];
+		if (key == 0)
+			return;
+
+		if (m_bindless)
+		{
+			if (--m_residentHandles[key] == 0)
+			{
+				Texture::makeNonResident(key);
+				m_residentHandles.erase(key);
+			}
+		}
+		else
+		{
+			m_freeLayers.push_back((int)(key - 1));
+		}
+
+		m_keys[index] = 0;
+		m_entries[2 * index] = 0;
+		m_entries[2 * index + 1] = 0;
+		markDirty(index);
+	}
+
+	void MaterialTable::flush()
+	{
+		if (m_entries.empty())
+			return;
+
+		const size_t size = m_entries.size() * sizeof(uint32_t);
+		if (size > m_capacity)
+		{
+			// Storage is immutable, grow geometrically and upload everything
+			m_capacity = std::max(size, 2 * m_capacity);
+			std::vector<uint32_t> data(m_entries);
+			data.resize(m_capacity / sizeof(uint32_t), 0);
+
+			m_buffer = Buffer();
+			m_buffer.bufferStorage(data, Buffer::StorageFlags::eDynamicStorageBit);
+		}
+		else if (m_dirtyBegin < m_dirtyEnd)
+		{
+			const size_t begin = m_dirtyBegin * 2;
+			const size_t end = m_dirtyEnd * 2;
+			m_buffer.bufferSubData(begin * sizeof(uint32_t), (end - begin) * sizeof(uint32_t), m_entries.data() + begin);
+		}
+
+		m_dirtyBegin = SIZE_MAX;
+		m_dirtyEnd = 0;
+	}
+
+	void MaterialTable::bind(unsigned int storage_binding, int array_unit) const noexcept
+	{
+		m_buffer.bindBase(Buffer::Target::eShaderStorage, storage_binding);
+		if (!m_bindless)
+			m_array.bindUnit(array_unit);
+	}
+
+	void MaterialTable::applyUniforms(const ShaderProgram& program, int array_unit) const noexcept
+	{
+		const auto id = program.id();
+		glProgramUniform1i(id, glGetUniformLocation(id, "MaterialTexturesPerMaterial"), m_settings.textures_per_material);
+		glProgramUniform1i(id, glGetUniformLocation(id, "MaterialBindless"), m_bindless);
+		glProgramUniform1i(id, glGetUniformLocation(id, "MaterialArray"), array_unit);
+	}
+
+	bool MaterialTable::bindless() const noexcept
+	{
+		return m_bindless;
+	}
+
+	size_t MaterialTable::materialCount() const noexcept
+	{
+		return m_used.size() - m_freeMaterials.size();
+	}
+
+	const Buffer& MaterialTable::buffer() const noexcept
+	{
+		return m_buffer;
+	}
+
+	bool MaterialTable::valid(MaterialId material, int slot) const noexcept
+	{
+		return material < m_used.size() && m_used[material] && slot >= 0 && slot < m_settings.textures_per_material;
+	}
+
+	size_t MaterialTable::slotIndex(MaterialId material, int slot) const noexcept
+	{
+		return (size_t)material * m_settings.textures_per_material + slot;
+	}
+
+	void MaterialTable::markDirty(size_t index) noexcept
+	{
+		m_dirtyBegin = std::min(m_dirtyBegin, index);
+		m_dirtyEnd = std::max(m_dirtyEnd, index + 1);
+	}
+}
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <glm/vec4.hpp>
 #include <tiny_obj_loader.h>
 
+#include <renderer/utility/profiler.hpp>
+
 
 #ifdef RENDERER_RC_ENABLED
 #include <cmrc/cmrc.hpp>
@@ -67,6 +69,7 @@ namespace gfx::core
 		std::vector<unsigned int>& indices
 	)
 	{
+		RENDERER_PROFILE_SCOPE("objFromString");
 		tinyobj::ObjReaderConfig reader_config;
 		reader_config.vertex_color = false;
 		reader_config.triangulation_method = "simple";
@@ -0,0 +1,75 @@
+#include <renderer/core/pipeline_cache.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	const ShaderPipeline& PipelineCache::pipeline(std::initializer_list<const ShaderProgram*> programs)
+	{
+		Key key{};
+		for (const auto* program : programs)
+		{
+			if (program == nullptr)
+				continue;
+
+			for (size_t stage = 0; stage < key.size(); ++stage)
+			{
+				if (((GLenum)program->flags() & (1u << stage)) != 0)
+					key[stage] = program->id();
+			}
+		}
+
+		const auto it = m_pipelines.find(key);
+		if (it != m_pipelines.end())
+			return *it->second;
+
+		auto pipeline = std::make_unique<ShaderPipeline>();
+		for (const auto* program : programs)
+		{
+			if (program != nullptr)
+				pipeline->useProgram(*program);
+		}
+
+		const auto& result = *pipeline;
+		m_pipelines.emplace(key, std::move(pipeline));
+		return result;
+	}
+
+	void PipelineCache::forget(const ShaderProgram& program)
+	{
+		std::vector<Key> keys;
+		for (const auto& [key, pipeline] : m_pipelines)
+		{
+			if (std::find(key.begin(), key.end(), program.id()) != key.end())
+				keys.push_back(key);
+		}
+
+		for (const auto& key : keys)
+			m_pipelines.erase(key);
+	}
+
+	void PipelineCache::clear() noexcept
+	{
+		m_pipelines.clear();
+	}
+
+	size_t PipelineCache::size() const noexcept
+	{
+		return m_pipelines.size();
+	}
+
+	size_t PipelineCache::KeyHash::operator()(const Key& key) const noexcept
+	{
+		// FNV-1a over the program names
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (const auto name : key)
+		{
+			hash ^= name;
+			hash *= 0x100000001b3ull;
+		}
+		return (size_t)hash;
+	}
+}
\ No newline at end of file
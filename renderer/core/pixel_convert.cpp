@@ -0,0 +1,516 @@
+#include <renderer/core/pixel_convert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RENDERER_PIXEL_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC exposes every intrinsic unconditionally, gcc and clang need the target per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RENDERER_TARGET(features)
+#else
+#define RENDERER_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace gfx::core
+{
+	namespace
+	{
+		// Scalar kernels, also used for the tails of the vector loops
+
+		template<int Channels, typename T>
+		void expandScalar(const T* src, T* dst, size_t count, T opaque) noexcept
+		{
+			for (size_t i = 0; i < count; ++i, src += Channels, dst += 4)
+			{
+				if constexpr (Channels == 1)
+				{
+					dst[0] = dst[1] = dst[2] = src[0];
+					dst[3] = opaque;
+				}
+				else if constexpr (Channels == 2)
+				{
+					dst[0] = dst[1] = dst[2] = src[0];
+					dst[3] = src[1];
+				}
+				else if constexpr (Channels == 3)
+				{
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = opaque;
+				}
+				else
+				{
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = src[3];
+				}
+			}
+		}
+
+		template<typename T>
+		void expandDispatch(const T* src, int channels, T* dst, size_t count, T opaque) noexcept
+		{
+			switch (channels)
+			{
+			case 1:
+				expandScalar<1>(src, dst, count, opaque);
+				break;
+			case 2:
+				expandScalar<2>(src, dst, count, opaque);
+				break;
+			case 3:
+				expandScalar<3>(src, dst, count, opaque);
+				break;
+			default:
+				std::memmove(dst, src, count * 4 * sizeof(T));
+				break;
+			}
+		}
+
+		void swizzleScalar(const uint8_t* src, uint8_t* dst, size_t count, const std::array<uint8_t, 4>& order) noexcept
+		{
+			for (size_t i = 0; i < count; ++i, src += 4, dst += 4)
+			{
+				const uint8_t pixel[4] = { src[0], src[1], src[2], src[3] };
+				dst[0] = pixel[order[0]];
+				dst[1] = pixel[order[1]];
+				dst[2] = pixel[order[2]];
+				dst[3] = pixel[order[3]];
+			}
+		}
+
+		// Exact rounded c * a / 255
+		uint8_t mulDiv255(uint32_t c, uint32_t a) noexcept
+		{
+			const uint32_t t = c * a + 128;
+			return (uint8_t)((t + (t >> 8)) >> 8);
+		}
+
+		void premultiplyScalar(uint8_t* pixels, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i, pixels += 4)
+			{
+				const uint32_t a = pixels[3];
+				pixels[0] = mulDiv255(pixels[0], a);
+				pixels[1] = mulDiv255(pixels[1], a);
+				pixels[2] = mulDiv255(pixels[2], a);
+			}
+		}
+
+		void premultiplyScalar(float* pixels, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; ++i, pixels += 4)
+			{
+				pixels[0] *= pixels[3];
+				pixels[1] *= pixels[3];
+				pixels[2] *= pixels[3];
+			}
+		}
+
+		uint16_t floatToHalfScalar(float value) noexcept
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000u);
+			bits &= 0x7FFFFFFFu;
+
+			// Inf and NaN, NaNs stay quiet
+			if (bits >= 0x7F800000u)
+				return sign | 0x7C00u | (bits > 0x7F800000u ? 0x0200u : 0u);
+
+			// Anything from 65520 up rounds to infinity
+			if (bits >= 0x477FF000u)
+				return sign | 0x7C00u;
+
+			// Subnormal halves
+			if (bits < 0x38800000u)
+			{
+				if (bits < 0x33000000u)
+					return sign;
+
+				const uint32_t exponent = bits >> 23;
+				const uint32_t mantissa = (bits & 0x7FFFFFu) | 0x800000u;
+				const uint32_t shift = 126 - exponent;
+
+				uint32_t half = mantissa >> shift;
+				const uint32_t remainder = mantissa & ((1u << shift) - 1);
+				const uint32_t halfway = 1u << (shift - 1);
+				if (remainder > halfway || (remainder == halfway && (half & 1u)))
+					++half;
+				return sign | (uint16_t)half;
+			}
+
+			// Normal halves, a mantissa carry correctly bumps the exponent
+			uint32_t half = (bits - 0x38000000u) >> 13;
+			const uint32_t remainder = bits & 0x1FFFu;
+			if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+				++half;
+			return sign | (uint16_t)half;
+		}
+
+		// sRGB transfer tables
+
+		float srgbDecode(float value) noexcept
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		struct SRGBTables
+		{
+			// Linear value of every 8-bit code
+			float to_linear[256];
+
+			// Linear value halfway between consecutive codes, encoding is a search of these thresholds
+			float thresholds[255];
+
+			SRGBTables() noexcept
+			{
+				for (int i = 0; i < 256; ++i)
+					to_linear[i] = srgbDecode((float)i / 255.0f);
+				for (int i = 0; i < 255; ++i)
+					thresholds[i] = srgbDecode(((float)i + 0.5f) / 255.0f);
+			}
+
+			uint8_t encode(float linear) const noexcept
+			{
+				return (uint8_t)(std::upper_bound(thresholds, thresholds + 255, linear) - thresholds);
+			}
+		};
+
+		const SRGBTables& srgbTables() noexcept
+		{
+			static const SRGBTables tables;
+			return tables;
+		}
+
+		uint8_t unormFromFloat(float value) noexcept
+		{
+			return (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+#ifdef RENDERER_PIXEL_SIMD
+		// Runtime feature detection
+
+		struct CpuFeatures
+		{
+			bool ssse3 = false;
+			bool f16c = false;
+		};
+
+		uint64_t xgetbv0() noexcept
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			uint32_t eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return ((uint64_t)edx << 32) | eax;
+#endif
+		}
+
+		CpuFeatures detectCpuFeatures() noexcept
+		{
+			CpuFeatures features;
+			unsigned int ecx;
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 1);
+			ecx = (unsigned int)info[2];
+#else
+			unsigned int eax, ebx, edx;
+			if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+				return features;
+#endif
+			features.ssse3 = (ecx & (1u << 9)) != 0;
+
+			// F16C is VEX encoded, the OS has to preserve the AVX register state
+			const bool osxsave = (ecx & (1u << 27)) != 0;
+			if (osxsave && (ecx & (1u << 29)) != 0)
+				features.f16c = (xgetbv0() & 0x6) == 0x6;
+
+			return features;
+		}
+
+		const CpuFeatures& cpuFeatures() noexcept
+		{
+			static const CpuFeatures features = detectCpuFeatures();
+			return features;
+		}
+
+		// SSSE3 kernels, 16 pixels per iteration for 8-bit and 8 pixels for 16-bit sources
+
+		RENDERER_TARGET("ssse3")
+		size_t expandRGBA8SSSE3(const uint8_t* src, int channels, uint8_t* dst, size_t count) noexcept
+		{
+			const __m128i opaque = _mm_set1_epi32((int)0xFF000000u);
+			size_t i = 0;
+
+			if (channels == 1)
+			{
+				const __m128i masks[4] = {
+					_mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+					_mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+					_mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+					_mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1)
+				};
+				for (; i + 16 <= count; i += 16, src += 16, dst += 64)
+				{
+					const __m128i grey = _mm_loadu_si128((const __m128i*)src);
+					for (int j = 0; j < 4; ++j)
+						_mm_storeu_si128((__m128i*)dst + j, _mm_or_si128(_mm_shuffle_epi8(grey, masks[j]), opaque));
+				}
+			}
+			else if (channels == 2)
+			{
+				const __m128i lo = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+				const __m128i hi = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+				for (; i + 16 <= count; i += 16, src += 32, dst += 64)
+				{
+					const __m128i a = _mm_loadu_si128((const __m128i*)src);
+					const __m128i b = _mm_loadu_si128((const __m128i*)src + 1);
+					_mm_storeu_si128((__m128i*)dst + 0, _mm_shuffle_epi8(a, lo));
+					_mm_storeu_si128((__m128i*)dst + 1, _mm_shuffle_epi8(a, hi));
+					_mm_storeu_si128((__m128i*)dst + 2, _mm_shuffle_epi8(b, lo));
+					_mm_storeu_si128((__m128i*)dst + 3, _mm_shuffle_epi8(b, hi));
+				}
+			}
+			else if (channels == 3)
+			{
+				// Each output register takes 12 source bytes, realigned across the three loads
+				const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+				for (; i + 16 <= count; i += 16, src += 48, dst += 64)
+				{
+					const __m128i a = _mm_loadu_si128((const __m128i*)src);
+					const __m128i b = _mm_loadu_si128((const __m128i*)src + 1);
+					const __m128i c = _mm_loadu_si128((const __m128i*)src + 2);
+					_mm_storeu_si128((__m128i*)dst + 0, _mm_or_si128(_mm_shuffle_epi8(a, mask), opaque));
+					_mm_storeu_si128((__m128i*)dst + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), mask), opaque));
+					_mm_storeu_si128((__m128i*)dst + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), mask), opaque));
+					_mm_storeu_si128((__m128i*)dst + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(c, 4), mask), opaque));
+				}
+			}
+
+			return i;
+		}
+
+		RENDERER_TARGET("ssse3")
+		size_t expandRGB16SSSE3(const uint16_t* src, uint16_t* dst, size_t count) noexcept
+		{
+			const __m128i mask = _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+			const __m128i opaque = _mm_set1_epi64x((long long)0xFFFF000000000000ull);
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8, src += 24, dst += 32)
+			{
+				const __m128i a = _mm_loadu_si128((const __m128i*)src);
+				const __m128i b = _mm_loadu_si128((const __m128i*)src + 1);
+				const __m128i c = _mm_loadu_si128((const __m128i*)src + 2);
+				_mm_storeu_si128((__m128i*)dst + 0, _mm_or_si128(_mm_shuffle_epi8(a, mask), opaque));
+				_mm_storeu_si128((__m128i*)dst + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), mask), opaque));
+				_mm_storeu_si128((__m128i*)dst + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), mask), opaque));
+				_mm_storeu_si128((__m128i*)dst + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(c, 4), mask), opaque));
+			}
+			return i;
+		}
+
+		RENDERER_TARGET("ssse3")
+		size_t swizzleSSSE3(const uint8_t* src, uint8_t* dst, size_t count, const std::array<uint8_t, 4>& order) noexcept
+		{
+			alignas(16) uint8_t mask_bytes[16];
+			for (int p = 0; p < 4; ++p)
+			{
+				for (int c = 0; c < 4; ++c)
+					mask_bytes[p * 4 + c] = (uint8_t)(p * 4 + order[c]);
+			}
+			const __m128i mask = _mm_load_si128((const __m128i*)mask_bytes);
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4, src += 16, dst += 16)
+				_mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), mask));
+			return i;
+		}
+
+		// SSE2 kernels, baseline on x86-64
+
+		size_t premultiplySSE2(uint8_t* pixels, size_t count) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i bias = _mm_set1_epi16(128);
+			const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000u);
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4, pixels += 16)
+			{
+				const __m128i px = _mm_loadu_si128((const __m128i*)pixels);
+
+				__m128i lo = _mm_unpacklo_epi8(px, zero);
+				__m128i hi = _mm_unpackhi_epi8(px, zero);
+				const __m128i alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+				const __m128i alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+
+				// Same rounding as mulDiv255
+				lo = _mm_add_epi16(_mm_mullo_epi16(lo, alpha_lo), bias);
+				hi = _mm_add_epi16(_mm_mullo_epi16(hi, alpha_hi), bias);
+				lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+				hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+				const __m128i color = _mm_packus_epi16(lo, hi);
+				_mm_storeu_si128((__m128i*)pixels, _mm_or_si128(_mm_andnot_si128(alpha_mask, color), _mm_and_si128(alpha_mask, px)));
+			}
+			return i;
+		}
+
+		size_t premultiplySSE2(float* pixels, size_t count) noexcept
+		{
+			const __m128 alpha_mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+			size_t i = 0;
+			for (; i < count; ++i, pixels += 4)
+			{
+				const __m128 px = _mm_loadu_ps(pixels);
+				const __m128 color = _mm_mul_ps(px, _mm_shuffle_ps(px, px, _MM_SHUFFLE(3, 3, 3, 3)));
+				_mm_storeu_ps(pixels, _mm_or_ps(_mm_andnot_ps(alpha_mask, color), _mm_and_ps(alpha_mask, px)));
+			}
+			return i;
+		}
+
+		// F16C kernel
+
+		RENDERER_TARGET("f16c")
+		size_t floatToHalfF16C(const float* src, uint16_t* dst, size_t count) noexcept
+		{
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i lo = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+				const __m128i hi = _mm_cvtps_ph(_mm_loadu_ps(src + i + 4), _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi64(lo, hi));
+			}
+			return i;
+		}
+#endif
+	}
+
+	void expandToRGBA8(const uint8_t* src, int channels, uint8_t* dst, size_t count) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		if (cpuFeatures().ssse3)
+			done = expandRGBA8SSSE3(src, channels, dst, count);
+#endif
+		expandDispatch<uint8_t>(src + done * channels, channels, dst + done * 4, count - done, 0xFF);
+	}
+
+	void expandToRGBA16(const uint16_t* src, int channels, uint16_t* dst, size_t count) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		if (channels == 3 && cpuFeatures().ssse3)
+			done = expandRGB16SSSE3(src, dst, count);
+#endif
+		expandDispatch<uint16_t>(src + done * channels, channels, dst + done * 4, count - done, 0xFFFF);
+	}
+
+	void expandToRGBAF(const float* src, int channels, float* dst, size_t count) noexcept
+	{
+		expandDispatch<float>(src, channels, dst, count, 1.0f);
+	}
+
+	void swizzleRGBA8(const uint8_t* src, uint8_t* dst, size_t count, const std::array<uint8_t, 4>& order) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		if (cpuFeatures().ssse3)
+			done = swizzleSSSE3(src, dst, count, order);
+#endif
+		swizzleScalar(src + done * 4, dst + done * 4, count - done, order);
+	}
+
+	void premultiplyRGBA8(uint8_t* pixels, size_t count) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		done = premultiplySSE2(pixels, count);
+#endif
+		premultiplyScalar(pixels + done * 4, count - done);
+	}
+
+	void premultiplySRGBA8(uint8_t* pixels, size_t count) noexcept
+	{
+		const auto& tables = srgbTables();
+		for (size_t i = 0; i < count; ++i, pixels += 4)
+		{
+			const float alpha = (float)pixels[3] / 255.0f;
+			pixels[0] = tables.encode(tables.to_linear[pixels[0]] * alpha);
+			pixels[1] = tables.encode(tables.to_linear[pixels[1]] * alpha);
+			pixels[2] = tables.encode(tables.to_linear[pixels[2]] * alpha);
+		}
+	}
+
+	void premultiplyRGBA16(uint16_t* pixels, size_t count) noexcept
+	{
+		// Plain integer loop, vectorized by the compiler
+		for (size_t i = 0; i < count; ++i, pixels += 4)
+		{
+			const uint32_t a = pixels[3];
+			pixels[0] = (uint16_t)(((uint32_t)pixels[0] * a + 32767u) / 65535u);
+			pixels[1] = (uint16_t)(((uint32_t)pixels[1] * a + 32767u) / 65535u);
+			pixels[2] = (uint16_t)(((uint32_t)pixels[2] * a + 32767u) / 65535u);
+		}
+	}
+
+	void premultiplyRGBAF(float* pixels, size_t count) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		done = premultiplySSE2(pixels, count);
+#endif
+		premultiplyScalar(pixels + done * 4, count - done);
+	}
+
+	void srgb8ToLinearF(const uint8_t* src, float* dst, size_t count, int channels) noexcept
+	{
+		const auto& tables = srgbTables();
+		const bool has_alpha = channels == 2 || channels == 4;
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (int c = 0; c < channels; ++c, ++src, ++dst)
+				*dst = (has_alpha && c == channels - 1) ? (float)*src / 255.0f : tables.to_linear[*src];
+		}
+	}
+
+	void linearFToSRGB8(const float* src, uint8_t* dst, size_t count, int channels) noexcept
+	{
+		const auto& tables = srgbTables();
+		const bool has_alpha = channels == 2 || channels == 4;
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (int c = 0; c < channels; ++c, ++src, ++dst)
+				*dst = (has_alpha && c == channels - 1) ? unormFromFloat(*src) : tables.encode(*src);
+		}
+	}
+
+	void floatToHalf(const float* src, uint16_t* dst, size_t count) noexcept
+	{
+		size_t done = 0;
+#ifdef RENDERER_PIXEL_SIMD
+		if (cpuFeatures().f16c)
+			done = floatToHalfF16C(src, dst, count);
+#endif
+		for (size_t i = done; i < count; ++i)
+			dst[i] = floatToHalfScalar(src[i]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include <renderer/core/program_cache.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <renderer/utility/profiler.hpp>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	namespace
+	{
+		constexpr char ENTRY_MAGIC[4] = { 'G', 'P', 'B', '2' };
+		constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+		struct EntryHeader
+		{
+			char magic[4];
+			uint32_t format;
+			uint64_t key;
+			uint64_t driver;
+			uint32_t flags;
+			uint32_t padding;
+			uint64_t size;
+		};
+
+		// FNV-1a, stable across runs and standard libraries unlike std::hash
+		uint64_t fnv1a(uint64_t hash, std::string_view data) noexcept
+		{
+			for (const auto c : data)
+			{
+				hash ^= (unsigned char)c;
+				hash *= 0x100000001b3ull;
+			}
+			return hash;
+		}
+
+		std::string glString(GLenum name)
+		{
+			const auto* value = reinterpret_cast<const char*>(glGetString(name));
+			return value != nullptr ? value : "";
+		}
+
+		bool readHeader(std::ifstream& file, EntryHeader& header, uint64_t driver)
+		{
+			if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+				return false;
+
+			return std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) == 0 && header.driver == driver;
+		}
+	}
+
+	ProgramCache::ProgramCache(std::filesystem::path directory, size_t max_size) :
+		m_directory(std::move(directory)),
+		m_maxSize(max_size)
+	{
+		int formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+
+		m_enabled = formats > 0 && !error;
+		m_driver = glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' + glString(GL_VERSION);
+		m_driverHash = fnv1a(FNV_OFFSET, m_driver);
+
+		if (m_enabled)
+			trim();
+	}
+
+	ShaderProgram ProgramCache::link(const std::vector<Source>& sources, bool separable)
+	{
+		RENDERER_PROFILE_SCOPE("ProgramCache::link");
+		if (auto program = find(sources, separable))
+			return std::move(*program);
+
+		ShaderProgram program;
+		std::vector<Shader> shaders;
+		shaders.reserve(sources.size());
+		for (const auto& source : sources)
+			shaders.emplace_back(source.target, source.code);
+
+		program.parameter(ShaderProgram::Parameter::eBinaryRetrievable, m_enabled);
+		program.parameter(ShaderProgram::Parameter::eSeparable, separable);
+		for (const auto& shader : shaders)
+			program.attachShader(shader);
+		program.link();
+		for (const auto& shader : shaders)
+			program.detachShader(shader);
+
+		store(sources, program, separable);
+		return program;
+	}
+
+	std::optional<ShaderProgram> ProgramCache::find(const std::vector<Source>& sources, bool separable)
+	{
+		RENDERER_PROFILE_SCOPE("ProgramCache::find");
+		if (m_enabled)
+		{
+			if (auto binary = readEntry(key(sources, separable)))
+			{
+				ShaderProgram program;
+				program.parameter(ShaderProgram::Parameter::eSeparable, separable);
+				if (program.loadBinary(*binary))
+				{
+					++m_stats.hits;
+					return program;
+				}
+
+				++m_stats.rejected;
+			}
+		}
+
+		++m_stats.misses;
+		return std::nullopt;
+	}
+
+	void ProgramCache::store(const std::vector<Source>& sources, const ShaderProgram& program, bool separable) const
+	{
+		if (m_enabled)
+			writeEntry(key(sources, separable), program.binary());
+	}
+
+	bool ProgramCache::enabled() const noexcept
+	{
+		return m_enabled;
+	}
+
+	const ProgramCache::Stats& ProgramCache::stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	const std::filesystem::path& ProgramCache::directory() const noexcept
+	{
+		return m_directory;
+	}
+
+	uint64_t ProgramCache::key(const std::vector<Source>& sources, bool separable) const noexcept
+	{
+		auto hash = fnv1a(FNV_OFFSET, m_driver);
+		hash = fnv1a(hash, separable ? "separable" : "");
+		for (const auto& source : sources)
+		{
+			const auto target = (uint32_t)source.target;
+			hash = fnv1a(hash, std::string_view(reinterpret_cast<const char*>(&target), sizeof(target)));
+			hash = fnv1a(hash, source.code);
+
+			// Keeps "ab" + "c" apart from "a" + "bc"
+			const auto size = (uint64_t)source.code.size();
+			hash = fnv1a(hash, std::string_view(reinterpret_cast<const char*>(&size), sizeof(size)));
+		}
+		return hash;
+	}
+
+	std::filesystem::path ProgramCache::entryPath(uint64_t key) const
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+		return m_directory / name;
+	}
+
+	std::optional<ShaderProgram::Binary> ProgramCache::readEntry(uint64_t key) const
+	{
+		const auto path = entryPath(key);
+		std::error_code error;
+		const auto file_size = std::filesystem::file_size(path, error);
+		if (error)
+			return std::nullopt;
+
+		std::optional<ShaderProgram::Binary> binary;
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return std::nullopt;
+
+			// A corrupt size must not turn into a huge allocation
+			EntryHeader header;
+			if (readHeader(file, header, m_driverHash) && header.key == key && header.size > 0 && header.size <= file_size - sizeof(header))
+			{
+				binary.emplace();
+				binary->format = header.format;
+				binary->flags = (ShaderProgram::TargetFlags)header.flags;
+				binary->data.resize(header.size);
+				if (!file.read(reinterpret_cast<char*>(binary->data.data()), (std::streamsize)binary->data.size()))
+					binary.reset();
+			}
+		}
+
+		// Stale or broken entries would only be skipped again
+		if (!binary)
+		{
+			std::filesystem::remove(path, error);
+			return std::nullopt;
+		}
+
+		// The write time orders entries for eviction
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+		return binary;
+	}
+
+	void ProgramCache::writeEntry(uint64_t key, const ShaderProgram::Binary& binary) const
+	{
+		if (binary.data.empty())
+			return;
+
+		EntryHeader header;
+		std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+		header.format = binary.format;
+		header.key = key;
+		header.driver = m_driverHash;
+		header.flags = (uint32_t)binary.flags;
+		header.padding = 0;
+		header.size = binary.data.size();
+
+		// Written next to the entry and renamed over it, so a crash never leaves a truncated entry behind
+		const auto path = entryPath(key);
+		auto temp_path = path;
+		temp_path += ".tmp";
+
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(binary.data.data()), (std::streamsize)binary.data.size());
+		file.close();
+
+		std::error_code error;
+		if (file)
+			std::filesystem::rename(temp_path, path, error);
+		if (!file || error)
+		{
+			std::filesystem::remove(temp_path, error);
+			return;
+		}
+
+		m_size += sizeof(header) + binary.data.size();
+		if (m_size > m_maxSize)
+			trim();
+	}
+
+	void ProgramCache::trim() const
+	{
+		struct Entry
+		{
+			std::filesystem::path path;
+			size_t size;
+			std::filesystem::file_time_type time;
+		};
+
+		std::vector<Entry> entries;
+		size_t total = 0;
+
+		std::error_code error;
+		for (auto it = std::filesystem::directory_iterator(m_directory, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			const auto& path = it->path();
+			if (path.extension() != ".bin" || !it->is_regular_file(error))
+				continue;
+
+			EntryHeader header;
+			std::ifstream file(path, std::ios::binary);
+			const auto current = file && readHeader(file, header, m_driverHash);
+			file.close();
+
+			if (!current)
+			{
+				std::filesystem::remove(path, error);
+				continue;
+			}
+
+			const auto size = (size_t)it->file_size(error);
+			entries.push_back({ path, size, it->last_write_time(error) });
+			total += size;
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.time < rhs.time; });
+		for (const auto& entry : entries)
+		{
+			if (total <= m_maxSize)
+				break;
+
+			if (std::filesystem::remove(entry.path, error))
+				total -= entry.size;
+		}
+
+		m_size = total;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include <renderer/core/shader_compiler.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <glad/glad.h>
+
+#include <renderer/utility/profiler.hpp>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	ShaderCompiler::ShaderCompiler(ProgramCache* cache) :
+		m_cache(cache)
+	{
+		// Let the driver pick the number of compiler threads
+		if (GLAD_GL_KHR_parallel_shader_compile)
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		else if (GLAD_GL_ARB_parallel_shader_compile)
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	}
+
+	ShaderCompiler::Handle ShaderCompiler::submit(std::vector<ProgramCache::Source> sources, bool separable)
+	{
+		Handle handle;
+		if (!m_freeHandles.empty())
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else
+		{
+			handle = (Handle)m_jobs.size();
+			m_jobs.emplace_back();
+		}
+
+		auto& job = *(m_jobs[handle] = std::make_unique<Job>());
+		job.separable = separable;
+
+		if (m_cache)
+		{
+			if (auto program = m_cache->find(sources, separable))
+			{
+				job.program = std::move(*program);
+				job.status = Status::eReady;
+				++m_stats.ready;
+				return handle;
+			}
+		}
+
+		job.shaders.reserve(sources.size());
+		for (const auto& source : sources)
+			job.shaders.emplace_back(source.target).compile(source.code);
+
+		job.sources = std::move(sources);
+		m_pending.push_back(handle);
+		++m_stats.pending;
+		return handle;
+	}
+
+	void ShaderCompiler::poll()
+	{
+		RENDERER_PROFILE_SCOPE("ShaderCompiler::poll");
+		std::erase_if(m_pending, [this](Handle handle) {
+			if (!advance(*m_jobs[handle], false))
+				return false;
+
+			if (m_jobs[handle]->released)
+				destroy(handle);
+			return true;
+		});
+	}
+
+	void ShaderCompiler::finish()
+	{
+		RENDERER_PROFILE_SCOPE("ShaderCompiler::finish");
+		for (const auto handle : m_pending)
+		{
+			advance(*m_jobs[handle], true);
+			if (m_jobs[handle]->released)
+				destroy(handle);
+		}
+		m_pending.clear();
+	}
+
+	void ShaderCompiler::release(Handle handle)
+	{
+		auto& job = m_jobs[handle];
+		if (!job)
+			return;
+
+		// The driver still works on it, poll() destroys it when it is done
+		if (job->status == Status::eCompiling || job->status == Status::eLinking)
+		{
+			job->released = true;
+			return;
+		}
+
+		destroy(handle);
+	}
+
+	ShaderCompiler::Status ShaderCompiler::status(Handle handle) const noexcept
+	{
+		const auto& job = m_jobs[handle];
+		return job && !job->released ? job->status : Status::eReleased;
+	}
+
+	const ShaderProgram* ShaderCompiler::program(Handle handle) const noexcept
+	{
+		if (handle == INVALID_HANDLE || status(handle) != Status::eReady)
+			return nullptr;
+
+		return &m_jobs[handle]->program;
+	}
+
+	const std::string& ShaderCompiler::error(Handle handle) const noexcept
+	{
+		static const std::string released;
+		return m_jobs[handle] ? m_jobs[handle]->error : released;
+	}
+
+	const ShaderCompiler::Stats& ShaderCompiler::stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	bool ShaderCompiler::parallel() const noexcept
+	{
+		return Shader::parallelCompileSupported();
+	}
+
+	bool ShaderCompiler::advance(Job& job, bool wait)
+	{
+		if (job.status == Status::eCompiling)
+		{
+			const auto compiled = [](const Shader& shader) { return shader.completed(); };
+			if (!wait && !std::all_of(job.shaders.begin(), job.shaders.end(), compiled))
+				return false;
+
+			for (const auto& shader : job.shaders)
+			{
+				if (!shader.compiled())
+				{
+					fail(job, shader.infoLog());
+					return true;
+				}
+			}
+
+			job.program.parameter(ShaderProgram::Parameter::eBinaryRetrievable, m_cache && m_cache->enabled());
+			job.program.parameter(ShaderProgram::Parameter::eSeparable, job.separable);
+			for (const auto& shader : job.shaders)
+				job.program.attachShader(shader);
+			job.program.startLink();
+			job.status = Status::eLinking;
+		}
+
+		if (!wait && !job.program.completed())
+			return false;
+
+		for (const auto& shader : job.shaders)
+			job.program.detachShader(shader);
+		job.shaders.clear();
+
+		try
+		{
+			job.program.finishLink();
+		}
+		catch (const std::exception& e)
+		{
+			fail(job, e.what());
+			return true;
+		}
+
+		if (m_cache)
+			m_cache->store(job.sources, job.program, job.separable);
+
+		job.sources.clear();
+		job.status = Status::eReady;
+		--m_stats.pending;
+		++m_stats.ready;
+		return true;
+	}
+
+	void ShaderCompiler::destroy(Handle handle) noexcept
+	{
+		if (m_jobs[handle]->status == Status::eReady)
+			--m_stats.ready;
+		else
+			--m_stats.failed;
+
+		m_jobs[handle].reset();
+		m_freeHandles.push_back(handle);
+	}
+
+	void ShaderCompiler::fail(Job& job, std::string error)
+	{
+		job.shaders.clear();
+		job.sources.clear();
+		job.error = std::move(error);
+		job.status = Status::eFailed;
+		--m_stats.pending;
+		++m_stats.failed;
+	}
+}
\ No newline at end of file
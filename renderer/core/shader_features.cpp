@@ -0,0 +1,100 @@
+#include <renderer/core/shader_features.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace gfx::core
+{
+	namespace
+	{
+		struct FeatureName
+		{
+			ShaderFeatures feature;
+			const char* name;
+			const char* define;
+		};
+
+		constexpr FeatureName FEATURE_NAMES[SHADER_FEATURE_COUNT] = {
+			{ ShaderFeatures::eInstancing, "instancing", "FEATURE_INSTANCING" },
+			{ ShaderFeatures::eAlphaTest, "alpha_test", "FEATURE_ALPHA_TEST" },
+			{ ShaderFeatures::eNormalMapping, "normal_mapping", "FEATURE_NORMAL_MAPPING" },
+			{ ShaderFeatures::eSkinning, "skinning", "FEATURE_SKINNING" },
+			{ ShaderFeatures::eOcclusionCulling, "occlusion_culling", "FEATURE_OCCLUSION_CULLING" }
+		};
+
+		// Offset past the line holding #version, 0 when there is none
+		size_t versionEnd(std::string_view source, size_t& line) noexcept
+		{
+			size_t begin = 0;
+			line = 1;
+			while (begin < source.size())
+			{
+				auto end = source.find('\n', begin);
+				end = end == std::string_view::npos ? source.size() : end + 1;
+
+				auto pos = begin;
+				while (pos < end && (source[pos] == ' ' || source[pos] == '\t'))
+					++pos;
+
+				if (source.compare(pos, 1, "#") == 0)
+				{
+					++pos;
+					while (pos < end && (source[pos] == ' ' || source[pos] == '\t'))
+						++pos;
+
+					if (source.compare(pos, 7, "version") == 0)
+						return end;
+				}
+
+				begin = end;
+				++line;
+			}
+
+			line = 0;
+			return 0;
+		}
+	}
+
+	const char* featureName(ShaderFeatures feature) noexcept
+	{
+		const auto it = std::find_if(std::begin(FEATURE_NAMES), std::end(FEATURE_NAMES), [feature](const auto& entry) { return entry.feature == feature; });
+		return it != std::end(FEATURE_NAMES) ? it->name : nullptr;
+	}
+
+	std::optional<ShaderFeatures> featureFromName(std::string_view name) noexcept
+	{
+		const auto it = std::find_if(std::begin(FEATURE_NAMES), std::end(FEATURE_NAMES), [name](const auto& entry) { return name == entry.name; });
+		if (it == std::end(FEATURE_NAMES))
+			return std::nullopt;
+
+		return it->feature;
+	}
+
+	std::string injectFeatures(std::string_view source, ShaderFeatures features)
+	{
+		if (features == ShaderFeatures::eNone)
+			return std::string(source);
+
+		size_t version_line;
+		const auto offset = versionEnd(source, version_line);
+
+		std::string defines;
+		for (const auto& entry : FEATURE_NAMES)
+		{
+			if ((features & entry.feature) != ShaderFeatures::eNone)
+				defines += std::string("#define ") + entry.define + " 1\n";
+		}
+
+		if (version_line > 0)
+			defines += "#line " + std::to_string(version_line + 1) + " 0\n";
+
+		// A last line without a newline needs one before the defines
+		std::string result(source.substr(0, offset));
+		if (!result.empty() && result.back() != '\n')
+			result += '\n';
+
+		result += defines;
+		result += source.substr(offset);
+		return result;
+	}
+}
\ No newline at end of file
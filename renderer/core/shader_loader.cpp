@@ -6,6 +6,8 @@
 #include <stdexcept>
 #include <iterator>
 
+#include <renderer/utility/profiler.hpp>
+
 #ifdef RENDERER_RC_ENABLED
 #include <cmrc/cmrc.hpp>
 CMRC_DECLARE(rc);
@@ -16,27 +18,33 @@ using namespace gfx::gl;
 namespace gfx::core
 {
 #ifdef RENDERER_RC_ENABLED
-	Shader shaderFromResource(Shader::Target target, const std::string& filepath) 
+	Shader shaderFromResource(Shader::Target target, const std::string& filepath, ShaderFeatures features) 
+	{
+		return Shader(target, sourceFromResource(filepath, features));
+	}
+
+	std::string sourceFromResource(const std::string& filepath, ShaderFeatures features)
 	{
+		RENDERER_PROFILE_SCOPE("sourceFromResource");
 		auto rcfs = cmrc::rc::get_filesystem();
 		auto file = rcfs.open(filepath);
-		return Shader(target, std::string(file.begin(), file.end()));
+		return injectFeatures(std::string_view(file.begin(), file.size()), features);
 	}
 #endif
 
-	Shader shaderFromFile(Shader::Target target, const std::string& filepath)
+	Shader shaderFromFile(Shader::Target target, const std::string& filepath, ShaderFeatures features)
 	{
 		std::ifstream iss(filepath);
 		if (!iss)
 			throw std::runtime_error(std::string("Unable to open file '") + filepath + "'");
 
-		return shaderFromStream(target, iss);
+		return shaderFromStream(target, iss, features);
 	}
 
-	Shader shaderFromStream(Shader::Target target, std::istream& is)
+	Shader shaderFromStream(Shader::Target target, std::istream& is, ShaderFeatures features)
 	{
 		std::string data;
 		std::getline(is, data, '\0');
-		return Shader(target, data);
+		return Shader(target, injectFeatures(data, features));
 	}
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <renderer/core/shader_variants.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace gfx::core
+{
+	ShaderVariants::ShaderVariants(ShaderCompiler& compiler) noexcept :
+		m_compiler(&compiler)
+	{
+	}
+
+	ShaderVariants::Id ShaderVariants::add(std::string name, std::vector<ProgramCache::Source> sources, ShaderFeatures supported, bool separable)
+	{
+		const auto exists = std::any_of(m_programs.begin(), m_programs.end(), [&name](const auto& program) { return program.name == name; });
+		if (exists)
+			throw std::invalid_argument("Shader program '" + name + "' is already registered");
+
+		m_programs.push_back({ std::move(name), std::move(sources), supported, separable });
+		return (Id)(m_programs.size() - 1);
+	}
+
+	ShaderCompiler::Handle ShaderVariants::request(Id id, ShaderFeatures features)
+	{
+		const auto& program = m_programs[id];
+		features &= program.supported;
+
+		const auto key = ((uint64_t)id << 32) | (uint32_t)features;
+		const auto it = m_variants.find(key);
+		if (it != m_variants.end())
+			return it->second;
+
+		const auto handle = submit(program, features);
+		m_variants.emplace(key, handle);
+		m_compiling.push_back(key);
+		return handle;
+	}
+
+	void ShaderVariants::reload(Id id, std::vector<ProgramCache::Source> sources)
+	{
+		auto& program = m_programs[id];
+		program.sources = std::move(sources);
+
+		for (const auto& [key, handle] : m_variants)
+		{
+			if ((Id)(key >> 32) != id)
+				continue;
+
+			// A newer reload supersedes one that is still compiling
+			for (auto& reload : m_reloads)
+				reload.stale |= reload.key == key;
+
+			m_reloads.push_back({ key, submit(program, (ShaderFeatures)(uint32_t)key), false });
+		}
+	}
+
+	std::vector<std::string> ShaderVariants::update()
+	{
+		std::vector<std::string> errors;
+
+		// Failed variants stay registered, so they are not submitted again until a reload
+		std::erase_if(m_compiling, [this, &errors](uint64_t key) {
+			const auto handle = m_variants[key];
+			const auto status = m_compiler->status(handle);
+			if (status == ShaderCompiler::Status::eFailed)
+				errors.push_back(describe(key) + ": " + m_compiler->error(handle));
+
+			return status != ShaderCompiler::Status::eCompiling && status != ShaderCompiler::Status::eLinking;
+		});
+
+		std::erase_if(m_reloads, [this, &errors](const Reload& reload) {
+			if (reload.stale)
+			{
+				m_compiler->release(reload.handle);
+				return true;
+			}
+
+			const auto status = m_compiler->status(reload.handle);
+			if (status == ShaderCompiler::Status::eReady)
+			{
+				auto& handle = m_variants[reload.key];
+				m_compiler->release(handle);
+				handle = reload.handle;
+				return true;
+			}
+
+			if (status == ShaderCompiler::Status::eFailed)
+			{
+				errors.push_back(describe(reload.key) + ": " + m_compiler->error(reload.handle));
+				m_compiler->release(reload.handle);
+				return true;
+			}
+
+			return false;
+		});
+
+		return errors;
+	}
+
+	const gl::ShaderProgram* ShaderVariants::program(Id id, ShaderFeatures features)
+	{
+		return m_compiler->program(request(id, features));
+	}
+
+	size_t ShaderVariants::prewarm(std::istream& manifest)
+	{
+		size_t count = 0;
+		std::string line;
+		while (std::getline(manifest, line))
+		{
+			line = line.substr(0, line.find('#'));
+
+			std::istringstream words(line);
+			std::string name;
+			if (!(words >> name))
+				continue;
+
+			const auto it = std::find_if(m_programs.begin(), m_programs.end(), [&name](const auto& program) { return program.name == name; });
+			if (it == m_programs.end())
+				throw std::invalid_argument("Unknown shader program '" + name + "' in variant manifest");
+
+			auto features = ShaderFeatures::eNone;
+			std::string feature_name;
+			while (words >> feature_name)
+			{
+				const auto feature = featureFromName(feature_name);
+				if (!feature)
+					throw std::invalid_argument("Unknown shader feature '" + feature_name + "' in variant manifest");
+				features |= *feature;
+			}
+
+			request((Id)(it - m_programs.begin()), features);
+			++count;
+		}
+
+		return count;
+	}
+
+	size_t ShaderVariants::variantCount() const noexcept
+	{
+		return m_variants.size();
+	}
+
+	ShaderCompiler::Handle ShaderVariants::submit(const Program& program, ShaderFeatures features)
+	{
+		auto sources = program.sources;
+		for (auto& source : sources)
+			source.code = injectFeatures(source.code, features);
+
+		return m_compiler->submit(std::move(sources), program.separable);
+	}
+
+	std::string ShaderVariants::describe(uint64_t key) const
+	{
+		// Program and feature names like a manifest line
+		auto description = m_programs[key >> 32].name;
+		for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; ++bit)
+		{
+			const auto feature = (ShaderFeatures)((uint32_t)key & (1u << bit));
+			if (const auto* name = featureName(feature))
+				description += std::string(" ") + name;
+		}
+		return description;
+	}
+}
\ No newline at end of file
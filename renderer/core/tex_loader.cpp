@@ -1,46 +1,162 @@
 #include <renderer/core/tex_loader.hpp>
 
-#ifdef RENDERER_RC_ENABLED
-#include <cmrc/cmrc.hpp>
-CMRC_DECLARE(rc);
-#endif
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
 
-#include <stb_image.h>
+#include <renderer/core/pixel_convert.hpp>
+#include <renderer/utility/profiler.hpp>
 
 using namespace gfx::gl;
 
 namespace gfx::core
 {
+	namespace
+	{
+		struct Upload
+		{
+			DataFormat internal_format;
+			DataFormat format;
+			Type type;
+			const void* pixels;
+			size_t row_size;
+		};
+
+		// Drivers report the client layout they copy without conversion, which is BGRA on most desktop parts.
+		bool prefersBGRA(DataFormat internal_format, Type& type) noexcept
+		{
+			int format = 0, preferred_type = 0;
+			glGetInternalformativ(GL_TEXTURE_2D, (GLenum)internal_format, GL_TEXTURE_IMAGE_FORMAT, 1, &format);
+			glGetInternalformativ(GL_TEXTURE_2D, (GLenum)internal_format, GL_TEXTURE_IMAGE_TYPE, 1, &preferred_type);
+
+			if (format != GL_BGRA)
+				return false;
+
+			// Both are the same byte order in memory on little endian hosts
+			type = preferred_type == GL_UNSIGNED_INT_8_8_8_8_REV ? Type::eUnsignedInt8888Rev : Type::eUnsignedByte;
+			return true;
+		}
+
+		DataFormat baseFormat(int channels) noexcept
+		{
+			switch (channels)
+			{
+			case 1:
+				return DataFormat::eR;
+			case 2:
+				return DataFormat::eRG;
+			case 3:
+				return DataFormat::eRGB;
+			default:
+				return DataFormat::eRGBA;
+			}
+		}
+	}
+
 #ifdef RENDERER_RC_ENABLED
-	Texture texture2DFromResource(const std::string& path)
+	Texture texture2DFromResource(const std::string& path, const TextureImportOptions& options)
+	{
+		return texture2DFromImage(imageFromResource(path), options);
+	}
+#endif
+
+	Texture texture2DFromImage(const Image& image, const TextureImportOptions& options)
 	{
-		auto rcfs = cmrc::rc::get_filesystem();
-		auto file = rcfs.open(path);
+		RENDERER_PROFILE_SCOPE("texture2DFromImage");
+		const size_t count = (size_t)image.width * image.height;
+		const bool premultiply = options.premultiply_alpha && (image.channels == 2 || image.channels == 4);
 
-		int width, height, channels;
-		const unsigned char* image_rc_data = (const unsigned char*)file.cbegin();
-		size_t file_size = file.size();
+		// 1 and 2 channel images stay as they are unless they carry color, 3 channel images are always
+		// padded here rather than by the driver. Only 8 bit images have an sRGB format to expand to.
+		const bool srgb = options.srgb && image.type == Type::eUnsignedByte;
+		const bool expand = image.channels == 3 || (image.channels < 4 && (srgb || premultiply));
 
-		unsigned char* image_data = stbi_load_from_memory(image_rc_data, file_size, &width, &height, &channels, 0);
-		if (image_data == nullptr)
+		Upload upload{ DataFormat::eRGBA, baseFormat(image.channels), image.type, image.pixels.get(), (size_t)image.width * image.channels * image.componentSize() };
+
+		std::vector<uint8_t> rgba8;
+		std::vector<uint16_t> rgba16;
+		std::vector<float> rgbaf;
+
+		if (image.type == Type::eFloat)
 		{
-			throw std::runtime_error(std::string("Unable to parse file texture source file resource '") + path + "': " + stbi_failure_reason());
+			const float* src = (const float*)image.pixels.get();
+			if (image.channels != 4 || premultiply)
+			{
+				rgbaf.resize(count * 4);
+				expandToRGBAF(src, image.channels, rgbaf.data(), count);
+				if (premultiply)
+					premultiplyRGBAF(rgbaf.data(), count);
+				src = rgbaf.data();
+			}
+
+			rgba16.resize(count * 4);
+			floatToHalf(src, rgba16.data(), count * 4);
+			upload = { DataFormat::eRGBA16F, DataFormat::eRGBA, Type::eHalfFloat, rgba16.data(), (size_t)image.width * 8 };
 		}
+		else if (image.type == Type::eUnsignedShort)
+		{
+			const DataFormat sized[] = { DataFormat::eR16, DataFormat::eRG16, DataFormat::eRGBA16, DataFormat::eRGBA16 };
+			upload.internal_format = sized[image.channels - 1];
 
-		Texture texture(Texture::Target::eTexture2D);
-		DataFormat internal_format;
-		if (channels == 1)
-			internal_format = DataFormat::eR8;
-		else if (channels == 2)
-			internal_format = DataFormat::eRG8;
-		else if (channels == 3)
-			internal_format = DataFormat::eRGB8;
+			if (expand || premultiply)
+			{
+				rgba16.resize(count * 4);
+				expandToRGBA16((const uint16_t*)image.pixels.get(), image.channels, rgba16.data(), count);
+				if (premultiply)
+					premultiplyRGBA16(rgba16.data(), count);
+				upload = { DataFormat::eRGBA16, DataFormat::eRGBA, Type::eUnsignedShort, rgba16.data(), (size_t)image.width * 8 };
+			}
+		}
 		else
-			internal_format = DataFormat::eRGBA8;
-		texture.storage2D(0, internal_format, width, height);
+		{
+			const DataFormat sized[] = { DataFormat::eR8, DataFormat::eRG8, DataFormat::eRGBA8, DataFormat::eRGBA8 };
+			upload.internal_format = sized[image.channels - 1];
 
-		stbi_image_free(image_data);
-		return std::move(texture);
-}
-#endif
+			if (expand || premultiply || image.channels == 4)
+			{
+				const DataFormat internal_format = options.srgb ? DataFormat::eSRG8Alpha8 : DataFormat::eRGBA8;
+				upload = { internal_format, DataFormat::eRGBA, Type::eUnsignedByte, image.pixels.get(), (size_t)image.width * 4 };
+
+				Type bgra_type;
+				const bool bgra = prefersBGRA(internal_format, bgra_type);
+
+				if (image.channels != 4 || premultiply || bgra)
+				{
+					rgba8.resize(count * 4);
+					expandToRGBA8(image.pixels.get(), image.channels, rgba8.data(), count);
+					if (premultiply)
+					{
+						if (options.srgb)
+							premultiplySRGBA8(rgba8.data(), count);
+						else
+							premultiplyRGBA8(rgba8.data(), count);
+					}
+					if (bgra)
+					{
+						swizzleRGBA8(rgba8.data(), rgba8.data(), count, { 2, 1, 0, 3 });
+						upload.format = DataFormat::eBGRA;
+						upload.type = bgra_type;
+					}
+					upload.pixels = rgba8.data();
+				}
+			}
+		}
+
+		const auto levels = (size_t)std::bit_width((unsigned int)std::max(image.width, image.height));
+
+		Texture texture(Texture::Target::eTexture2D);
+		texture.storage2D(levels, upload.internal_format, image.width, image.height);
+
+		// Rows of 1 and 2 channel images are tightly packed
+		const bool packed = upload.row_size % 4 != 0;
+		if (packed)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		texture.subImage2D(0, 0, 0, image.width, image.height, upload.format, upload.type, upload.pixels);
+		if (packed)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		texture.generateMipmap();
+		return texture;
+	}
 }
\ No newline at end of file
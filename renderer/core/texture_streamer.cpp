@@ -0,0 +1,402 @@
+#include <renderer/core/texture_streamer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include <glm/geometric.hpp>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	namespace
+	{
+		int levelSize(int size, int level) noexcept
+		{
+			return std::max(size >> level, 1);
+		}
+
+		void setFilters(Texture& texture) noexcept
+		{
+			texture.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eLinearMipmapLinear);
+			texture.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eLinear);
+		}
+	}
+
+	TextureStreamer::TextureStreamer(const Settings& settings, util::ThreadPool& pool) :
+		m_settings(settings),
+		m_pool(pool),
+		m_loadQueue(std::make_shared<LoadQueue>())
+	{
+		if (settings.tail_size <= 0)
+			throw std::invalid_argument("texture streamer tail size must be positive");
+	}
+
+	TextureStreamer::Handle TextureStreamer::add(Source source)
+	{
+		if (source.width <= 0 || source.height <= 0 || source.texel_size == 0)
+			throw std::invalid_argument("streamed texture size must be positive");
+		if (!source.loader)
+			throw std::invalid_argument("streamed texture requires a mip loader");
+
+		Handle handle;
+		if (!m_freeHandles.empty())
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else
+		{
+			handle = (Handle)m_entries.size();
+			m_entries.emplace_back();
+		}
+
+		auto& entry = m_entries[handle];
+		entry.source = std::move(source);
+		entry.levels = std::bit_width((unsigned int)std::max(entry.source.width, entry.source.height));
+
+		entry.tail = 0;
+		while (entry.tail + 1 < entry.levels && std::max(levelSize(entry.source.width, entry.tail), levelSize(entry.source.height, entry.tail)) > m_settings.tail_size)
+			++entry.tail;
+
+		entry.allocated = entry.resident = entry.wanted = entry.target = entry.tail;
+		entry.loading = -1;
+		entry.coverage = 0.0f;
+		entry.fade = 0.0f;
+		entry.last_used = m_frame;
+
+		entry.texture = Texture(Texture::Target::eTexture2D);
+		entry.texture.storage2D(entry.levels - entry.tail, entry.source.internal_format, levelSize(entry.source.width, entry.tail), levelSize(entry.source.height, entry.tail));
+		setFilters(entry.texture);
+
+		// The tail is loaded up front so every texture can be sampled from the first frame
+		for (int level = entry.tail; level < entry.levels; ++level)
+		{
+			const auto image = entry.source.loader(level);
+			if (image.empty() || image.width != levelSize(entry.source.width, level) || image.height != levelSize(entry.source.height, level))
+			{
+				remove(handle);
+				throw std::runtime_error("unable to load the mip tail of a streamed texture");
+			}
+			uploadLevel(entry, level, image);
+		}
+		applyLevelClamp(entry);
+
+		++entry.generation;
+		entry.used = true;
+		++m_stats.textures;
+		return handle;
+	}
+
+	void TextureStreamer::remove(Handle handle) noexcept
+	{
+		auto& entry = m_entries[handle];
+		if (entry.used)
+			--m_stats.textures;
+
+		// Pending loads see the new generation and are discarded
+		++entry.generation;
+		entry.used = false;
+		entry.source = {};
+		entry.texture = Texture(Texture::Target::eTexture2D);
+		m_freeHandles.push_back(handle);
+	}
+
+	void TextureStreamer::addView(const glm::vec3& position, const glm::mat4& projection, int viewport_height) noexcept
+	{
+		m_views.push_back({ position, projection[1][1] * (float)viewport_height * 0.5f, projection[3][3] == 0.0f });
+	}
+
+	void TextureStreamer::requestUsage(Handle handle, const glm::vec3& center, float radius, float uv_density) noexcept
+	{
+		if (handle >= m_entries.size() || !m_entries[handle].used)
+			return;
+
+		auto& entry = m_entries[handle];
+		const float texels_per_unit = uv_density * (float)std::max(entry.source.width, entry.source.height);
+
+		for (const auto& view : m_views)
+		{
+			float pixels_per_unit = view.scale;
+			if (view.perspective)
+				pixels_per_unit /= std::max(glm::distance(center, view.position) - radius, 1e-3f);
+
+			// One texel per pixel is level 0, every halving of the screen footprint is one level coarser
+			const float ratio = std::max(texels_per_unit / std::max(pixels_per_unit, 1e-6f), 1.0f);
+			const int level = std::clamp((int)std::floor(std::log2(ratio) + m_settings.mip_bias), 0, entry.tail);
+
+			const float diameter = 2.0f * radius * pixels_per_unit;
+			entry.wanted = std::min(entry.wanted, level);
+			entry.coverage = std::max(entry.coverage, diameter * diameter);
+		}
+
+		entry.last_used = m_frame;
+	}
+
+	void TextureStreamer::update()
+	{
+		m_stats.uploads = 0;
+		m_stats.reallocations = 0;
+		m_stats.dropped_levels = 0;
+
+		fitBudget();
+
+		// Drop levels beyond the target, least recently used first, until every target fits
+		size_t required = 0;
+		std::vector<Handle> droppable;
+		for (Handle handle = 0; handle < m_entries.size(); ++handle)
+		{
+			const auto& entry = m_entries[handle];
+			if (!entry.used)
+				continue;
+
+			required += chainBytes(entry, std::min(entry.allocated, entry.target));
+			if (entry.allocated < entry.target)
+				droppable.push_back(handle);
+		}
+
+		if (required > m_settings.vram_budget)
+		{
+			std::sort(droppable.begin(), droppable.end(), [this](Handle a, Handle b) { return m_entries[a].last_used < m_entries[b].last_used; });
+			for (const auto handle : droppable)
+			{
+				if (required <= m_settings.vram_budget)
+					break;
+
+				auto& entry = m_entries[handle];
+				required -= chainBytes(entry, entry.allocated) - chainBytes(entry, entry.target);
+				reallocate(entry, entry.target);
+			}
+		}
+
+		// Upload a bounded number of finished levels
+		std::vector<LoadedMip> mips;
+		{
+			std::lock_guard lock(m_loadQueue->mutex);
+			auto& completed = m_loadQueue->completed;
+			const size_t count = std::min(completed.size(), (size_t)std::max(m_settings.max_uploads_per_frame, 0));
+			mips.assign(std::make_move_iterator(completed.begin()), std::make_move_iterator(completed.begin() + count));
+			completed.erase(completed.begin(), completed.begin() + count);
+		}
+
+		for (const auto& mip : mips)
+		{
+			--m_pending;
+
+			auto& entry = m_entries[mip.handle];
+			if (!entry.used || entry.generation != mip.generation)
+				continue;
+
+			entry.loading = -1;
+			if (mip.level != entry.resident - 1 || mip.level < entry.target)
+				continue;
+			if (mip.image.empty() || mip.image.width != levelSize(entry.source.width, mip.level) || mip.image.height != levelSize(entry.source.height, mip.level))
+				continue; // Requested again next frame
+
+			// Allocate down to the target at once, so the following levels do not reallocate again
+			if (mip.level < entry.allocated)
+				reallocate(entry, entry.target);
+
+			uploadLevel(entry, mip.level, mip.image);
+			entry.resident = mip.level;
+			entry.fade = m_settings.fade_frames > 0 ? 1.0f : 0.0f;
+			applyLevelClamp(entry);
+			++m_stats.uploads;
+		}
+
+		// Request the next finer level of the textures with the largest screen coverage first
+		std::vector<Handle> loads;
+		for (Handle handle = 0; handle < m_entries.size(); ++handle)
+		{
+			const auto& entry = m_entries[handle];
+			if (entry.used && entry.loading < 0 && entry.resident > entry.target)
+				loads.push_back(handle);
+		}
+
+		std::sort(loads.begin(), loads.end(), [this](Handle a, Handle b) { return m_entries[a].coverage > m_entries[b].coverage; });
+		for (const auto handle : loads)
+		{
+			if (m_pending >= m_settings.max_pending_loads)
+				break;
+			requestLoad(handle);
+		}
+
+		// Fade new levels in and reset the usage for the next frame
+		m_stats.resident_bytes = 0;
+		for (auto& entry : m_entries)
+		{
+			if (!entry.used)
+				continue;
+
+			if (entry.fade > 0.0f)
+			{
+				entry.fade = std::max(entry.fade - 1.0f / (float)m_settings.fade_frames, 0.0f);
+				applyLevelClamp(entry);
+			}
+
+			m_stats.resident_bytes += chainBytes(entry, entry.allocated);
+			entry.wanted = entry.tail;
+			entry.coverage = 0.0f;
+		}
+
+		m_stats.pending_loads = m_pending;
+		m_views.clear();
+		++m_frame;
+	}
+
+	void TextureStreamer::bind(Handle handle, int unit) const noexcept
+	{
+		m_entries[handle].texture.bindUnit(unit);
+	}
+
+	const Texture& TextureStreamer::texture(Handle handle) const noexcept
+	{
+		return m_entries[handle].texture;
+	}
+
+	int TextureStreamer::levelCount(Handle handle) const noexcept
+	{
+		return m_entries[handle].levels;
+	}
+
+	int TextureStreamer::residentLevel(Handle handle) const noexcept
+	{
+		return m_entries[handle].resident;
+	}
+
+	int TextureStreamer::wantedLevel(Handle handle) const noexcept
+	{
+		return m_entries[handle].target;
+	}
+
+	const TextureStreamer::Settings& TextureStreamer::settings() const noexcept
+	{
+		return m_settings;
+	}
+
+	const TextureStreamer::Stats& TextureStreamer::stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	size_t TextureStreamer::levelBytes(const Entry& entry, int level) const noexcept
+	{
+		return (size_t)levelSize(entry.source.width, level) * levelSize(entry.source.height, level) * entry.source.texel_size;
+	}
+
+	size_t TextureStreamer::chainBytes(const Entry& entry, int level) const noexcept
+	{
+		size_t bytes = 0;
+		for (; level < entry.levels; ++level)
+			bytes += levelBytes(entry, level);
+		return bytes;
+	}
+
+	void TextureStreamer::fitBudget()
+	{
+		using Candidate = std::pair<float, Handle>;
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+		size_t total = 0;
+		for (Handle handle = 0; handle < m_entries.size(); ++handle)
+		{
+			auto& entry = m_entries[handle];
+			if (!entry.used)
+				continue;
+
+			entry.target = entry.wanted;
+			total += chainBytes(entry, entry.target);
+			if (entry.target < entry.tail)
+				candidates.push({ entry.coverage, handle });
+		}
+
+		// Coarsen the textures with the least screen coverage first, each level covers a quarter of the texels
+		// of the one below so its weight drops accordingly
+		while (total > m_settings.vram_budget && !candidates.empty())
+		{
+			auto [coverage, handle] = candidates.top();
+			candidates.pop();
+
+			auto& entry = m_entries[handle];
+			total -= levelBytes(entry, entry.target);
+			++entry.target;
+
+			if (entry.target < entry.tail)
+				candidates.push({ coverage * 0.25f, handle });
+		}
+
+		m_stats.wanted_bytes = total;
+	}
+
+	void TextureStreamer::reallocate(Entry& entry, int allocated)
+	{
+		const auto& source = entry.source;
+
+		Texture texture(Texture::Target::eTexture2D);
+		texture.storage2D(entry.levels - allocated, source.internal_format, levelSize(source.width, allocated), levelSize(source.height, allocated));
+		setFilters(texture);
+
+		for (int level = std::max(entry.resident, allocated); level < entry.levels; ++level)
+		{
+			entry.texture.copyImageSubData(Texture::Target::eTexture2D, level - entry.allocated, 0, 0, 0,
+				texture, Texture::Target::eTexture2D, level - allocated, 0, 0, 0,
+				levelSize(source.width, level), levelSize(source.height, level), 1);
+		}
+
+		if (allocated > entry.resident)
+		{
+			m_stats.dropped_levels += allocated - entry.resident;
+			entry.resident = allocated;
+			entry.fade = 0.0f;
+		}
+
+		entry.texture = std::move(texture);
+		entry.allocated = allocated;
+		applyLevelClamp(entry);
+		++m_stats.reallocations;
+	}
+
+	void TextureStreamer::uploadLevel(Entry& entry, int level, const Image& image) noexcept
+	{
+		const bool packed = (size_t)image.width * entry.source.texel_size % 4 != 0;
+		if (packed)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		entry.texture.subImage2D(level - entry.allocated, 0, 0, image.width, image.height, entry.source.format, entry.source.type, image.pixels.get());
+		if (packed)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void TextureStreamer::applyLevelClamp(Entry& entry) noexcept
+	{
+		// Levels above the base are allocated but not uploaded, the minimum LOD is relative to the base
+		entry.texture.parameter(Texture::Parameter::eBaseLevel, entry.resident - entry.allocated);
+		entry.texture.parameter(Texture::Parameter::eMinLOD, entry.fade);
+	}
+
+	void TextureStreamer::requestLoad(Handle handle)
+	{
+		auto& entry = m_entries[handle];
+		entry.loading = entry.resident - 1;
+		++m_pending;
+
+		m_pool.post([queue = m_loadQueue, loader = entry.source.loader, handle, generation = entry.generation, level = entry.loading]()
+		{
+			LoadedMip mip{ handle, generation, level, {} };
+			try
+			{
+				mip.image = loader(level);
+			}
+			catch (...)
+			{
+				// Reported as an empty image and retried
+			}
+
+			std::lock_guard lock(queue->mutex);
+			queue->completed.push_back(std::move(mip));
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include <renderer/core/upload_thread.hpp>
+
+#include <stdexcept>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/utility/profiler.hpp>
+
+namespace gfx::core
+{
+	UploadThread::UploadThread(GLFWwindow* shared, size_t max_completions) :
+		m_completions(max_completions)
+	{
+		// The context inherits the current hints, which created the shared one
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		m_window = glfwCreateWindow(1, 1, "Uploads", nullptr, shared);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+		if (m_window == nullptr)
+			throw std::runtime_error("Unable to create upload context.");
+
+		m_worker = std::thread(&UploadThread::workerLoop, this);
+	}
+
+	UploadThread::~UploadThread()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskAvailable.notify_all();
+		m_worker.join();
+
+		glfwDestroyWindow(m_window);
+	}
+
+	void UploadThread::post(std::function<void()> work, std::function<void()> done)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_tasks.push_back({ std::move(work), std::move(done) });
+			++m_pending;
+		}
+		m_taskAvailable.notify_one();
+	}
+
+	size_t UploadThread::poll()
+	{
+		RENDERER_PROFILE_SCOPE("UploadThread::poll");
+		size_t completed = 0;
+		while (auto* completion = m_completions.front())
+		{
+			// Completions are in submission order, the rest can't be done either
+			if (!completion->fence.signaled())
+				break;
+
+			auto done = std::move(completion->done);
+			auto error = completion->error;
+			m_completions.pop();
+
+			{
+				std::lock_guard lock(m_mutex);
+				--m_pending;
+			}
+
+			if (error)
+				std::rethrow_exception(error);
+
+			done();
+			++completed;
+		}
+
+		return completed;
+	}
+
+	size_t UploadThread::pendingCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_pending;
+	}
+
+	void UploadThread::workerLoop()
+	{
+		glfwMakeContextCurrent(m_window);
+		util::Profiler::instance().registerThread("Uploads");
+
+		const auto stopping = [this]() {
+			std::lock_guard lock(m_mutex);
+			return m_stopping;
+		};
+
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock lock(m_mutex);
+				m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+				if (m_stopping)
+					break;
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+			}
+
+			Completion completion;
+			completion.done = std::move(task.done);
+
+			try
+			{
+				RENDERER_PROFILE_SCOPE("UploadThread::task");
+				task.work();
+			}
+			catch (...)
+			{
+				completion.error = std::current_exception();
+			}
+
+			// The fence only signals for other contexts once it has been flushed
+			completion.fence.insert();
+			glFlush();
+
+			// The render thread stops polling before shutting down, don't wait on it then
+			while (!m_completions.tryPush(std::move(completion)) && !stopping())
+				std::this_thread::yield();
+		}
+
+		// The names still cached by this thread are deleted on its own context before it is released
+		gl::NamePool::current().release();
+		glfwMakeContextCurrent(nullptr);
+	}
+}
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <cmath>
 #include <limits>
 
+#include <renderer/shaders/simple_vert.hpp>
+
 namespace gfx::core
 {
 
@@ -36,11 +38,11 @@ namespace gfx::core
 		switch (attr)
 		{
 		case gl::Attribute::ePosition:
-			return 0;
+			return shaders::simple_vert::attributes::VertexPosition_modelspace.location;
 		case gl::Attribute::eTexCoords:
-			return 1;
+			return shaders::simple_vert::attributes::VertexUV.location;
 		case gl::Attribute::eNormal:
-			return 2;
+			return shaders::simple_vert::attributes::VertexNormal_modelspace.location;
 		default:
 			return 0;
 		}
@@ -0,0 +1,457 @@
+#include <renderer/core/virtual_texture.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+using namespace gfx::gl;
+
+namespace gfx::core
+{
+	namespace
+	{
+		// Feedback requests are packed as x:12 | y:12 | mip:4, cleared texels read back as all ones.
+		constexpr uint32_t NO_REQUEST = 0xFFFFFFFFu;
+		constexpr uint32_t MAX_PAGES = 1u << 12;
+
+		// Page table entries are RGBA8 texels of (slot x, slot y, resident mip, 255).
+		constexpr int MAX_SLOTS_PER_AXIS = 256;
+
+		uint64_t pageKey(const VirtualTexture::PageId& page) noexcept
+		{
+			return ((uint64_t)page.mip << 48) | ((uint64_t)page.y << 24) | (uint64_t)page.x;
+		}
+
+		VirtualTexture::PageId parentPage(const VirtualTexture::PageId& page) noexcept
+		{
+			return { page.mip + 1, page.x / 2, page.y / 2 };
+		}
+
+		uint32_t packEntry(uint32_t slot_x, uint32_t slot_y, uint32_t mip) noexcept
+		{
+			return slot_x | (slot_y << 8) | (mip << 16) | (0xFFu << 24);
+		}
+
+		uint32_t entryMip(uint32_t entry) noexcept
+		{
+			return (entry >> 16) & 0xFFu;
+		}
+	}
+
+	VirtualTexture::VirtualTexture(const Settings& settings, TileLoader loader, util::ThreadPool& pool) :
+		m_settings(settings),
+		m_loader(std::move(loader)),
+		m_pool(pool),
+		m_cache(Texture::Target::eTexture2D),
+		m_pageTable(Texture::Target::eTexture2D),
+		m_loadQueue(std::make_shared<LoadQueue>()),
+		m_feedbackColor(Texture::Target::eTexture2D)
+	{
+		if (settings.page_size <= 0 || settings.border < 0)
+			throw std::invalid_argument("virtual texture page size must be positive");
+		if (settings.width <= 0 || settings.height <= 0 || settings.width % settings.page_size != 0 || settings.height % settings.page_size != 0)
+			throw std::invalid_argument("virtual texture size must be a multiple of the page size");
+
+		m_pagesX = (uint32_t)(settings.width / settings.page_size);
+		m_pagesY = (uint32_t)(settings.height / settings.page_size);
+		if (!std::has_single_bit(m_pagesX) || !std::has_single_bit(m_pagesY))
+			throw std::invalid_argument("virtual texture page count must be a power of two");
+		if (m_pagesX > MAX_PAGES || m_pagesY > MAX_PAGES)
+			throw std::invalid_argument("virtual texture exceeds the maximum page count");
+
+		m_mipCount = (uint32_t)std::bit_width(std::max(m_pagesX, m_pagesY));
+
+		// Physical cache, sized from the VRAM budget
+		m_slotSize = settings.page_size + 2 * settings.border;
+		const size_t slot_bytes = (size_t)m_slotSize * m_slotSize * 4;
+
+		int max_texture_size;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+		const int max_slots_per_axis = std::min(max_texture_size / m_slotSize, MAX_SLOTS_PER_AXIS);
+
+		const size_t budget_slots = std::max<size_t>(settings.vram_budget / slot_bytes, 2);
+		m_slotsX = std::min((int)std::ceil(std::sqrt((double)budget_slots)), max_slots_per_axis);
+		m_slotsY = std::min((int)(budget_slots / m_slotsX), max_slots_per_axis);
+		if (m_slotsX * m_slotsY < 2)
+			throw std::invalid_argument("virtual texture page size exceeds the maximum texture size");
+
+		m_cache.storage2D(1, DataFormat::eRGBA8, (ssize_t)m_slotsX * m_slotSize, (ssize_t)m_slotsY * m_slotSize);
+		m_cache.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eLinear);
+		m_cache.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eLinear);
+		m_cache.parameter(Texture::Parameter::eWrapS, (int)GL_CLAMP_TO_EDGE);
+		m_cache.parameter(Texture::Parameter::eWrapT, (int)GL_CLAMP_TO_EDGE);
+
+		m_slots.resize((size_t)m_slotsX * m_slotsY);
+		m_freeSlots.reserve(m_slots.size());
+		for (size_t i = m_slots.size(); i > 0; --i)
+			m_freeSlots.push_back((uint32_t)(i - 1));
+
+		// Page table, one texel per page in a full mip chain
+		m_pageTable.storage2D(m_mipCount, DataFormat::eRGBA8, m_pagesX, m_pagesY);
+		m_pageTable.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eNearestMipmapNearest);
+		m_pageTable.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eNearest);
+
+		m_tableLevels.resize(m_mipCount);
+		m_dirtyRows.resize(m_mipCount, { UINT32_MAX, 0 });
+		for (uint32_t mip = 0; mip < m_mipCount; ++mip)
+			m_tableLevels[mip].resize((size_t)pagesX(mip) * pagesY(mip), 0);
+
+		resizeFeedback(settings.feedback_width, settings.feedback_height, settings.feedback_scale);
+
+		// The coarsest page is loaded up front and never evicted, so every lookup has a fallback
+		const PageId root = { m_mipCount - 1, 0, 0 };
+		std::vector<unsigned char> pixels((size_t)m_slotSize * m_slotSize * 4);
+		if (!m_loader(root, m_slotSize, settings.border, pixels.data()))
+			throw std::runtime_error("unable to load the root page of the virtual texture");
+
+		uint32_t root_slot = 0;
+		acquireSlot(root_slot);
+		m_slots[root_slot].pinned = true;
+		uploadTile(root_slot, pixels.data());
+		forEachTableEntry(root, [](uint32_t& entry) { entry = packEntry(0, 0, 0xFF); });
+		mapPage(root, root_slot);
+		flushPageTable();
+	}
+
+	void VirtualTexture::beginFeedback() noexcept
+	{
+		glGetIntegerv(GL_VIEWPORT, m_savedViewport.data());
+
+		m_feedback.bind();
+		glViewport(0, 0, m_settings.feedback_width, m_settings.feedback_height);
+
+		const unsigned int clear_request[4] = { NO_REQUEST, NO_REQUEST, NO_REQUEST, NO_REQUEST };
+		m_feedback.clearColor(0, clear_request);
+		m_feedback.clearDepth(1.0f);
+	}
+
+	void VirtualTexture::endFeedback() noexcept
+	{
+		m_feedback.unbind();
+		glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+
+		// Skip the readback rather than stall if the ring is still waiting on the GPU
+		auto& readback = m_readbacks[m_readbackHead];
+		if (readback.pending)
+			return;
+
+		const ssize_t size = (ssize_t)m_settings.feedback_width * m_settings.feedback_height * sizeof(uint32_t);
+		readback.buffer.bind(Buffer::Target::ePixelPack);
+		m_feedbackColor.getTextureImage(0, DataFormat::eRInteger, Type::eUnsignedInt, size, nullptr);
+		readback.buffer.unbind(Buffer::Target::ePixelPack);
+
+		readback.fence.insert();
+		readback.pending = true;
+		m_readbackHead = (m_readbackHead + 1) % m_readbacks.size();
+	}
+
+	void VirtualTexture::resizeFeedback(int width, int height, float scale)
+	{
+		m_settings.feedback_width = std::max(width, 1);
+		m_settings.feedback_height = std::max(height, 1);
+		m_settings.feedback_scale = std::max(scale, 1.0f);
+
+		m_feedbackColor = Texture(Texture::Target::eTexture2D);
+		m_feedbackColor.storage2D(1, DataFormat::eR32UI, m_settings.feedback_width, m_settings.feedback_height);
+
+		m_feedbackDepth = Renderbuffer();
+		m_feedbackDepth.storage(DataFormat::eDepthComponent24, m_settings.feedback_width, m_settings.feedback_height);
+
+		m_feedback.attach(m_feedbackColor, Framebuffer::Attachment::eColor0, 0);
+		m_feedback.attach(m_feedbackDepth, Framebuffer::Attachment::eDepth);
+
+		// In flight readbacks refer to the old size, drop them
+		const size_t size = (size_t)m_settings.feedback_width * m_settings.feedback_height * sizeof(uint32_t);
+		for (auto& readback : m_readbacks)
+		{
+			readback.buffer.bufferData(size, nullptr, Buffer::Usage::eStreamRead);
+			readback.fence.reset();
+			readback.pending = false;
+		}
+		m_readbackHead = 0;
+	}
+
+	void VirtualTexture::update()
+	{
+		++m_frame;
+		m_stats.requests = 0;
+		m_stats.uploads = 0;
+		m_stats.evictions = 0;
+
+		// Consume every readback the GPU has finished with
+		for (size_t i = 0; i < m_readbacks.size(); ++i)
+		{
+			auto& readback = m_readbacks[(m_readbackHead + i) % m_readbacks.size()];
+			if (!readback.pending || !readback.fence.signaled())
+				continue;
+
+			m_requests.resize((size_t)m_settings.feedback_width * m_settings.feedback_height);
+			readback.buffer.getSubData(0, m_requests.size() * sizeof(uint32_t), m_requests.data());
+			readback.fence.reset();
+			readback.pending = false;
+
+			processRequests(m_requests);
+		}
+
+		// Upload a bounded number of finished tiles
+		std::vector<LoadedTile> tiles;
+		{
+			std::lock_guard lock(m_loadQueue->mutex);
+			auto& completed = m_loadQueue->completed;
+			const size_t count = std::min(completed.size(), (size_t)std::max(m_settings.max_uploads_per_frame, 0));
+			tiles.assign(std::make_move_iterator(completed.begin()), std::make_move_iterator(completed.begin() + count));
+			completed.erase(completed.begin(), completed.begin() + count);
+		}
+
+		for (const auto& tile : tiles)
+		{
+			const auto key = pageKey(tile.page);
+			m_pending.erase(key);
+			if (!tile.valid || m_resident.contains(key))
+				continue;
+
+			uint32_t slot;
+			if (!acquireSlot(slot))
+				continue; // Every slot is in use this frame, the page will be requested again
+
+			uploadTile(slot, tile.pixels.data());
+			mapPage(tile.page, slot);
+			++m_stats.uploads;
+		}
+
+		flushPageTable();
+
+		m_stats.resident_pages = m_resident.size();
+		m_stats.capacity = m_slots.size();
+		m_stats.pending_loads = m_pending.size();
+	}
+
+	void VirtualTexture::bind(int cache_unit, int page_table_unit) const noexcept
+	{
+		m_cache.bindUnit(cache_unit);
+		m_pageTable.bindUnit(page_table_unit);
+	}
+
+	void VirtualTexture::applyUniforms(const ShaderProgram& program, int cache_unit, int page_table_unit) const noexcept
+	{
+		// Uniforms that a shader does not use are silently skipped
+		const auto id = program.id();
+		glProgramUniform1i(id, glGetUniformLocation(id, "VTCache"), cache_unit);
+		glProgramUniform1i(id, glGetUniformLocation(id, "VTPageTable"), page_table_unit);
+		glProgramUniform2f(id, glGetUniformLocation(id, "VTVirtualSize"), (float)m_settings.width, (float)m_settings.height);
+		glProgramUniform2f(id, glGetUniformLocation(id, "VTCacheSize"), (float)(m_slotsX * m_slotSize), (float)(m_slotsY * m_slotSize));
+		glProgramUniform1f(id, glGetUniformLocation(id, "VTPageSize"), (float)m_settings.page_size);
+		glProgramUniform1f(id, glGetUniformLocation(id, "VTBorder"), (float)m_settings.border);
+		glProgramUniform1i(id, glGetUniformLocation(id, "VTMaxMip"), (int)m_mipCount - 1);
+		glProgramUniform1f(id, glGetUniformLocation(id, "VTFeedbackBias"), std::log2(m_settings.feedback_scale));
+	}
+
+	const Texture& VirtualTexture::cache() const noexcept
+	{
+		return m_cache;
+	}
+
+	const Texture& VirtualTexture::pageTable() const noexcept
+	{
+		return m_pageTable;
+	}
+
+	int VirtualTexture::mipCount() const noexcept
+	{
+		return (int)m_mipCount;
+	}
+
+	int VirtualTexture::slotSize() const noexcept
+	{
+		return m_slotSize;
+	}
+
+	const VirtualTexture::Stats& VirtualTexture::stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	uint32_t VirtualTexture::pagesX(uint32_t mip) const noexcept
+	{
+		return std::max(m_pagesX >> mip, 1u);
+	}
+
+	uint32_t VirtualTexture::pagesY(uint32_t mip) const noexcept
+	{
+		return std::max(m_pagesY >> mip, 1u);
+	}
+
+	void VirtualTexture::processRequests(const std::vector<uint32_t>& requests)
+	{
+		std::vector<uint32_t> unique_requests(requests);
+		std::sort(unique_requests.begin(), unique_requests.end());
+		unique_requests.erase(std::unique(unique_requests.begin(), unique_requests.end()), unique_requests.end());
+
+		std::vector<PageId> loads;
+		for (const auto request : unique_requests)
+		{
+			if (request == NO_REQUEST)
+				continue;
+
+			PageId page = { (request >> 24) & 0xFu, request & 0xFFFu, (request >> 12) & 0xFFFu };
+			if (page.mip >= m_mipCount || page.x >= pagesX(page.mip) || page.y >= pagesY(page.mip))
+				continue;
+
+			++m_stats.requests;
+
+			// Walk up until a resident page is found, requesting every missing ancestor on the way
+			for (;;)
+			{
+				const auto it = m_resident.find(pageKey(page));
+				if (it != m_resident.end())
+				{
+					m_slots[it->second].last_used = m_frame;
+					break;
+				}
+
+				loads.push_back(page);
+				page = parentPage(page);
+			}
+		}
+
+		// Coarse pages first, they improve the largest screen area
+		std::sort(loads.begin(), loads.end(), [](const PageId& a, const PageId& b) { return a.mip > b.mip; });
+		for (const auto& page : loads)
+		{
+			if (m_pending.size() >= m_settings.max_pending_loads)
+				break;
+			requestLoad(page);
+		}
+	}
+
+	void VirtualTexture::requestLoad(const PageId& page)
+	{
+		if (!m_pending.insert(pageKey(page)).second)
+			return;
+
+		m_pool.post([queue = m_loadQueue, loader = m_loader, page, tile_size = m_slotSize, border = m_settings.border]()
+		{
+			LoadedTile tile{ page, std::vector<unsigned char>((size_t)tile_size * tile_size * 4), false };
+			tile.valid = loader(page, tile_size, border, tile.pixels.data());
+
+			std::lock_guard lock(queue->mutex);
+			queue->completed.push_back(std::move(tile));
+		});
+	}
+
+	bool VirtualTexture::acquireSlot(uint32_t& slot)
+	{
+		if (!m_freeSlots.empty())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+			return true;
+		}
+
+		// Evict the least recently used page that was not requested this frame
+		uint64_t oldest = m_frame;
+		for (uint32_t i = 0; i < m_slots.size(); ++i)
+		{
+			if (!m_slots[i].pinned && m_slots[i].last_used < oldest)
+			{
+				oldest = m_slots[i].last_used;
+				slot = i;
+			}
+		}
+
+		if (oldest == m_frame)
+			return false;
+
+		unmapPage(m_slots[slot].page);
+		++m_stats.evictions;
+		return true;
+	}
+
+	void VirtualTexture::uploadTile(uint32_t slot, const unsigned char* pixels) noexcept
+	{
+		const int x = (int)(slot % m_slotsX) * m_slotSize;
+		const int y = (int)(slot / m_slotsX) * m_slotSize;
+		m_cache.subImage2D(0, x, y, m_slotSize, m_slotSize, DataFormat::eRGBA, Type::eUnsignedByte, pixels);
+	}
+
+	void VirtualTexture::mapPage(const PageId& page, uint32_t slot)
+	{
+		m_resident[pageKey(page)] = slot;
+		m_slots[slot].page = page;
+		m_slots[slot].last_used = m_frame;
+
+		// Take over every entry currently falling back to a coarser page
+		const uint32_t entry = packEntry(slot % m_slotsX, slot / m_slotsX, page.mip);
+		forEachTableEntry(page, [&](uint32_t& current)
+		{
+			if (entryMip(current) > page.mip)
+				current = entry;
+		});
+	}
+
+	void VirtualTexture::unmapPage(const PageId& page)
+	{
+		const auto it = m_resident.find(pageKey(page));
+		const uint32_t slot = it->second;
+		m_resident.erase(it);
+
+		PageId ancestor = parentPage(page);
+		auto fallback = m_resident.find(pageKey(ancestor));
+		while (fallback == m_resident.end())
+		{
+			ancestor = parentPage(ancestor);
+			fallback = m_resident.find(pageKey(ancestor));
+		}
+
+		const uint32_t old_entry = packEntry(slot % m_slotsX, slot / m_slotsX, page.mip);
+		const uint32_t new_entry = packEntry(fallback->second % m_slotsX, fallback->second / m_slotsX, ancestor.mip);
+		forEachTableEntry(page, [&](uint32_t& current)
+		{
+			if (current == old_entry)
+				current = new_entry;
+		});
+
+		m_freeSlots.push_back(slot);
+	}
+
+	template<typename F>
+	void VirtualTexture::forEachTableEntry(const PageId& page, F&& func)
+	{
+		// Visit the footprint of the page on its own level and every finer one
+		for (uint32_t mip = page.mip + 1; mip-- > 0;)
+		{
+			const uint32_t shift = page.mip - mip;
+			const uint32_t width = pagesX(mip);
+			const uint32_t x0 = page.x << shift, x1 = std::min((page.x + 1) << shift, width);
+			const uint32_t y0 = page.y << shift, y1 = std::min((page.y + 1) << shift, pagesY(mip));
+
+			auto& level = m_tableLevels[mip];
+			for (uint32_t y = y0; y < y1; ++y)
+			{
+				for (uint32_t x = x0; x < x1; ++x)
+					func(level[(size_t)y * width + x]);
+			}
+
+			auto& dirty = m_dirtyRows[mip];
+			dirty.first = std::min(dirty.first, y0);
+			dirty.second = std::max(dirty.second, y1);
+		}
+	}
+
+	void VirtualTexture::flushPageTable() noexcept
+	{
+		for (uint32_t mip = 0; mip < m_mipCount; ++mip)
+		{
+			auto& dirty = m_dirtyRows[mip];
+			if (dirty.first >= dirty.second)
+				continue;
+
+			const uint32_t width = pagesX(mip);
+			const uint32_t* rows = m_tableLevels[mip].data() + (size_t)dirty.first * width;
+			m_pageTable.subImage2D(mip, 0, dirty.first, width, dirty.second - dirty.first, DataFormat::eRGBA, Type::eUnsignedByte, rows);
+			dirty = { UINT32_MAX, 0 };
+		}
+	}
+}
\ No newline at end of file
@@ -1,12 +1,17 @@
 #include <renderer/gl/buffer.hpp>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/utility/profiler.hpp>
+
 #include <utility>
 
 namespace gfx::gl
 {
 	Buffer::Buffer() noexcept
 	{
-		glCreateBuffers(1, &m_id);
+		m_id = NamePool::current().createBuffer();
 	}
 
 	Buffer::Buffer(Buffer&& other) noexcept
@@ -22,27 +27,70 @@ namespace gfx::gl
 
 	Buffer::~Buffer() noexcept
 	{
-		glDeleteBuffers(1, &m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eBuffer, m_id);
 	}
 
 	void Buffer::bufferData(size_t size, const void* data, Usage usage) noexcept
 	{
+		RENDERER_PROFILE_SCOPE("Buffer::bufferData");
 		glNamedBufferData(m_id, size, data, (GLenum)usage);
 	}
 
 	void Buffer::bufferStorage(size_t size, const void* data, StorageFlags flags) noexcept
 	{
+		RENDERER_PROFILE_SCOPE("Buffer::bufferStorage");
 		glNamedBufferStorage(m_id, size, data, (GLenum)flags);
 	}
 
+	void Buffer::bufferSubData(size_t offset, size_t size, const void* data) noexcept
+	{
+		RENDERER_PROFILE_SCOPE("Buffer::bufferSubData");
+		glNamedBufferSubData(m_id, offset, size, data);
+	}
+
+	void Buffer::copySubData(Buffer& dst, size_t read_offset, size_t write_offset, size_t size) const noexcept
+	{
+		glCopyNamedBufferSubData(m_id, dst.m_id, read_offset, write_offset, size);
+	}
+
+	void Buffer::getSubData(size_t offset, size_t size, void* data) const noexcept
+	{
+		glGetNamedBufferSubData(m_id, offset, size, data);
+	}
+
+	void* Buffer::mapRange(size_t offset, size_t size, MapFlags access) noexcept
+	{
+		return glMapNamedBufferRange(m_id, offset, size, (GLenum)access);
+	}
+
+	void Buffer::flushMappedRange(size_t offset, size_t size) noexcept
+	{
+		glFlushMappedNamedBufferRange(m_id, offset, size);
+	}
+
+	bool Buffer::unmap() noexcept
+	{
+		return glUnmapNamedBuffer(m_id) == GL_TRUE;
+	}
+
 	void Buffer::bind(Target type) const noexcept
 	{
-		glBindBuffer((GLenum) type, m_id);
+		StateCache::current().bindBuffer((GLenum)type, m_id);
 	}
 
 	void Buffer::unbind(Target type) const noexcept
 	{
-		glBindBuffer((GLenum) type, m_id);
+		StateCache::current().bindBuffer((GLenum)type, 0);
+	}
+
+	void Buffer::bindBase(Target type, unsigned int index) const noexcept
+	{
+		StateCache::current().bindBufferBase((GLenum)type, index, m_id);
+	}
+
+	void Buffer::bindRange(Target type, unsigned int index, size_t offset, size_t size) const noexcept
+	{
+		StateCache::current().bindBufferRange((GLenum)type, index, m_id, offset, size);
 	}
 
 	unsigned int Buffer::id() const noexcept
@@ -0,0 +1,206 @@
+#include <renderer/gl/buffer_pool.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using gfx::util::TlsfAllocator;
+
+namespace gfx::gl
+{
+	BufferPool::BufferPool(size_t page_size, Buffer::StorageFlags flags) :
+		m_pageSize(page_size),
+		m_flags(flags)
+	{
+		if (page_size == 0)
+			throw std::invalid_argument("buffer pool page size must be positive");
+
+		addPage(page_size);
+	}
+
+	BufferPool::Handle BufferPool::allocate(size_t size, size_t alignment)
+	{
+		Handle handle;
+		if (!m_freeHandles.empty())
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		else
+		{
+			handle = (Handle)m_ranges.size();
+			m_ranges.emplace_back();
+		}
+
+		auto& range = m_ranges[handle];
+		range.size = std::max<size_t>(size, 1);
+		range.alignment = std::max<size_t>(alignment, 1);
+
+		for (uint32_t page = 0; page < m_pages.size(); ++page)
+		{
+			range.block = m_pages[page].allocator.allocate(range.size, range.alignment, handle);
+			if (range.block != TlsfAllocator::INVALID_BLOCK)
+			{
+				range.page = page;
+				return handle;
+			}
+		}
+
+		addPage(std::max(m_pageSize, TlsfAllocator::requiredCapacity(range.size, range.alignment)));
+		range.page = (uint32_t)(m_pages.size() - 1);
+		range.block = m_pages.back().allocator.allocate(range.size, range.alignment, handle);
+		if (range.block == TlsfAllocator::INVALID_BLOCK)
+		{
+			m_freeHandles.push_back(handle);
+			releaseEmptyPages();
+			throw std::runtime_error("buffer pool range does not fit a dedicated page");
+		}
+
+		return handle;
+	}
+
+	void BufferPool::free(Handle handle) noexcept
+	{
+		auto& range = m_ranges[handle];
+		m_pages[range.page].allocator.free(range.block);
+		range.block = TlsfAllocator::INVALID_BLOCK;
+		m_freeHandles.push_back(handle);
+
+		releaseEmptyPages();
+	}
+
+	void BufferPool::upload(Handle handle, size_t offset, size_t size, const void* data) noexcept
+	{
+		const auto& range = m_ranges[handle];
+		auto& page = m_pages[range.page];
+		page.buffer.bufferSubData(page.allocator.offset(range.block) + offset, size, data);
+	}
+
+	void BufferPool::copy(Handle handle, size_t offset, const Buffer& src, size_t src_offset, size_t size) noexcept
+	{
+		const auto& range = m_ranges[handle];
+		auto& page = m_pages[range.page];
+		src.copySubData(page.buffer, src_offset, page.allocator.offset(range.block) + offset, size);
+	}
+
+	size_t BufferPool::compact(size_t max_bytes)
+	{
+		size_t moved = 0;
+
+		// Walk every page from its end, moving ranges into free space at lower offsets or earlier pages
+		for (size_t page = m_pages.size(); page-- > 0 && moved < max_bytes;)
+		{
+			const auto& allocator = m_pages[page].allocator;
+			auto block = allocator.lastBlock();
+			while (block != TlsfAllocator::INVALID_BLOCK && moved < max_bytes)
+			{
+				const auto previous = allocator.previousBlock(block);
+				if (!allocator.isFree(block))
+				{
+					const auto handle = (Handle)allocator.userData(block);
+					if (relocate(handle))
+						moved += m_ranges[handle].size;
+				}
+				block = previous;
+			}
+		}
+
+		releaseEmptyPages();
+		return moved;
+	}
+
+	const Buffer& BufferPool::buffer(Handle handle) const noexcept
+	{
+		return m_pages[m_ranges[handle].page].buffer;
+	}
+
+	size_t BufferPool::offset(Handle handle) const noexcept
+	{
+		const auto& range = m_ranges[handle];
+		return m_pages[range.page].allocator.offset(range.block);
+	}
+
+	size_t BufferPool::size(Handle handle) const noexcept
+	{
+		return m_ranges[handle].size;
+	}
+
+	uint32_t BufferPool::page(Handle handle) const noexcept
+	{
+		return m_ranges[handle].page;
+	}
+
+	size_t BufferPool::pageCount() const noexcept
+	{
+		return m_pages.size();
+	}
+
+	const Buffer& BufferPool::pageBuffer(size_t page) const noexcept
+	{
+		return m_pages[page].buffer;
+	}
+
+	BufferPool::Stats BufferPool::stats() const noexcept
+	{
+		Stats stats;
+		stats.pages = m_pages.size();
+		for (const auto& page : m_pages)
+		{
+			const auto page_stats = page.allocator.stats();
+			stats.capacity += page_stats.capacity;
+			stats.used += page_stats.used;
+			stats.largest_free = std::max(stats.largest_free, page_stats.largest_free);
+			stats.allocations += page_stats.allocations;
+			stats.free_blocks += page_stats.free_blocks;
+		}
+
+		const auto free_bytes = stats.capacity - stats.used;
+		if (free_bytes > 0)
+			stats.fragmentation = 1.0f - (float)stats.largest_free / (float)free_bytes;
+
+		return stats;
+	}
+
+	void BufferPool::addPage(size_t capacity)
+	{
+		Page page{ Buffer(), TlsfAllocator(capacity) };
+		page.buffer.bufferStorage(capacity, nullptr, m_flags);
+		m_pages.push_back(std::move(page));
+	}
+
+	bool BufferPool::relocate(Handle handle)
+	{
+		auto& range = m_ranges[handle];
+		auto& source = m_pages[range.page];
+		const auto source_offset = source.allocator.offset(range.block);
+
+		for (uint32_t page = 0; page <= range.page; ++page)
+		{
+			auto& target = m_pages[page];
+			const auto block = target.allocator.allocate(range.size, range.alignment, handle);
+			if (block == TlsfAllocator::INVALID_BLOCK)
+				continue;
+
+			const auto target_offset = target.allocator.offset(block);
+			if (page == range.page && target_offset >= source_offset)
+			{
+				target.allocator.free(block);
+				return false;
+			}
+
+			source.buffer.copySubData(target.buffer, source_offset, target_offset, range.size);
+			source.allocator.free(range.block);
+			range.page = page;
+			range.block = block;
+			return true;
+		}
+
+		return false;
+	}
+
+	void BufferPool::releaseEmptyPages() noexcept
+	{
+		// Only trailing pages go, so the page indices of the remaining ranges stay valid
+		while (m_pages.size() > 1 && m_pages.back().allocator.used() == 0)
+			m_pages.pop_back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include <renderer/gl/deletion_queue.hpp>
+
+#include <utility>
+
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/utility/profiler.hpp>
+
+namespace gfx::gl
+{
+	DeletionQueue& DeletionQueue::instance() noexcept
+	{
+		static DeletionQueue queue;
+		return queue;
+	}
+
+	void DeletionQueue::post(Type type, unsigned int name)
+	{
+		if (name == 0)
+			return;
+
+		std::lock_guard lock(m_mutex);
+		m_posted[(size_t)type].push_back(name);
+	}
+
+	void DeletionQueue::endFrame()
+	{
+		RENDERER_PROFILE_SCOPE("DeletionQueue::endFrame");
+		m_stats = {};
+
+		// Retire in submission order, a batch is only ever behind the ones before it
+		while (!m_batches.empty() && m_batches.front().fence.signaled())
+		{
+			auto& batch = m_batches.front();
+			retire(batch.names);
+			m_spare.push_back(std::move(batch.names));
+			m_batches.pop_front();
+		}
+
+		Names posted;
+		if (!m_spare.empty())
+		{
+			posted = std::move(m_spare.back());
+			m_spare.pop_back();
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			std::swap(posted, m_posted);
+		}
+
+		bool empty = true;
+		for (const auto& names : posted)
+			empty &= names.empty();
+
+		if (empty)
+		{
+			m_spare.push_back(std::move(posted));
+		}
+		else
+		{
+			auto& batch = m_batches.emplace_back();
+			batch.names = std::move(posted);
+			batch.fence.insert();
+		}
+
+		for (const auto& batch : m_batches)
+		{
+			for (const auto& names : batch.names)
+				m_stats.pending += names.size();
+		}
+	}
+
+	void DeletionQueue::flush()
+	{
+		for (auto& batch : m_batches)
+			retire(batch.names);
+		m_batches.clear();
+
+		Names posted;
+		{
+			std::lock_guard lock(m_mutex);
+			std::swap(posted, m_posted);
+		}
+		retire(posted);
+	}
+
+	const DeletionQueue::Stats& DeletionQueue::stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	void DeletionQueue::retire(Names& names) noexcept
+	{
+		auto& state = StateCache::current();
+
+		for (size_t type = 0; type < TYPE_COUNT; ++type)
+		{
+			auto& list = names[type];
+			if (list.empty())
+				continue;
+
+			const auto count = (GLsizei)list.size();
+			switch ((Type)type)
+			{
+			case Type::eBuffer:
+				for (const auto name : list)
+					state.forgetBuffer(name);
+				glDeleteBuffers(count, list.data());
+				break;
+			case Type::eTexture:
+				for (const auto name : list)
+					state.forgetTexture(name);
+				glDeleteTextures(count, list.data());
+				break;
+			case Type::eVertexArray:
+				for (const auto name : list)
+					state.forgetVertexArray(name);
+				glDeleteVertexArrays(count, list.data());
+				break;
+			case Type::eFramebuffer:
+				for (const auto name : list)
+					state.forgetFramebuffer(name);
+				glDeleteFramebuffers(count, list.data());
+				break;
+			case Type::eRenderbuffer:
+				glDeleteRenderbuffers(count, list.data());
+				break;
+			case Type::eShader:
+				for (const auto name : list)
+					glDeleteShader(name);
+				break;
+			case Type::eShaderProgram:
+				for (const auto name : list)
+				{
+					state.forgetProgram(name);
+					glDeleteProgram(name);
+				}
+				break;
+			case Type::eProgramPipeline:
+				for (const auto name : list)
+					state.forgetProgramPipeline(name);
+				glDeleteProgramPipelines(count, list.data());
+				break;
+			case Type::eQuery:
+				glDeleteQueries(count, list.data());
+				break;
+			}
+
+			m_stats.deleted += list.size();
+			list.clear();
+		}
+	}
+}
\ No newline at end of file
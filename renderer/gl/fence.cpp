@@ -0,0 +1,76 @@
+#include <renderer/gl/fence.hpp>
+
+#include <utility>
+
+namespace gfx::gl
+{
+	Fence::Fence() noexcept
+	{ }
+
+	Fence::Fence(Fence&& other) noexcept
+	{
+		using std::swap;
+		swap(m_sync, other.m_sync);
+	}
+
+	Fence& Fence::operator=(Fence&& other) noexcept
+	{
+		using std::swap;
+		swap(m_sync, other.m_sync);
+		return *this;
+	}
+
+	Fence::~Fence() noexcept
+	{
+		reset();
+	}
+
+	void Fence::insert() noexcept
+	{
+		reset();
+		m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void Fence::reset() noexcept
+	{
+		if (m_sync != nullptr)
+		{
+			glDeleteSync(m_sync);
+			m_sync = nullptr;
+		}
+	}
+
+	bool Fence::signaled() const noexcept
+	{
+		if (m_sync == nullptr)
+			return true;
+
+		int status = GL_UNSIGNALED;
+		glGetSynciv(m_sync, GL_SYNC_STATUS, 1, nullptr, &status);
+		return status == GL_SIGNALED;
+	}
+
+	Fence::Status Fence::wait(uint64_t timeout_ns) const noexcept
+	{
+		if (m_sync == nullptr)
+			return Status::eAlreadySignaled;
+
+		return (Status)glClientWaitSync(m_sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+	}
+
+	void Fence::serverWait() const noexcept
+	{
+		if (m_sync != nullptr)
+			glWaitSync(m_sync, 0, GL_TIMEOUT_IGNORED);
+	}
+
+	bool Fence::valid() const noexcept
+	{
+		return m_sync != nullptr;
+	}
+
+	GLsync Fence::id() const noexcept
+	{
+		return m_sync;
+	}
+}
\ No newline at end of file
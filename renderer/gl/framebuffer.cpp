@@ -1,6 +1,10 @@
 
 #include <renderer/gl/framebuffer.hpp>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/gl/state_cache.hpp>
+
 #include <stdexcept>
 #include <utility>
 
@@ -8,7 +12,7 @@ namespace gfx::gl
 {
 	Framebuffer::Framebuffer() noexcept
 	{
-		glCreateFramebuffers(1, &m_id);
+		m_id = NamePool::current().createFramebuffer();
 	}
 
 	Framebuffer::Framebuffer(Framebuffer&& other) noexcept
@@ -24,17 +28,17 @@ namespace gfx::gl
 
 	Framebuffer::~Framebuffer() noexcept
 	{
-		glDeleteFramebuffers(1, &m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eFramebuffer, m_id);
 	}
 
 	void Framebuffer::bind(Target target) const noexcept
 	{
-		glBindFramebuffer((GLenum) target, m_id);
+		StateCache::current().bindFramebuffer((GLenum)target, m_id);
 	}
 
 	void Framebuffer::unbind(Target target) const noexcept
 	{
-		glBindFramebuffer((GLenum) target, 0);
+		StateCache::current().bindFramebuffer((GLenum)target, 0);
 	}
 	
 	void Framebuffer::attach(const Renderbuffer& buffer, Attachment attachment) noexcept
@@ -47,6 +51,31 @@ namespace gfx::gl
 		glNamedFramebufferTexture(m_id, (GLenum)attachment, texture.id(), level);
 	}
 
+	void Framebuffer::clearColor(int draw_buffer, const float* value) noexcept
+	{
+		glClearNamedFramebufferfv(m_id, GL_COLOR, draw_buffer, value);
+	}
+
+	void Framebuffer::clearColor(int draw_buffer, const int* value) noexcept
+	{
+		glClearNamedFramebufferiv(m_id, GL_COLOR, draw_buffer, value);
+	}
+
+	void Framebuffer::clearColor(int draw_buffer, const unsigned int* value) noexcept
+	{
+		glClearNamedFramebufferuiv(m_id, GL_COLOR, draw_buffer, value);
+	}
+
+	void Framebuffer::clearDepth(float depth) noexcept
+	{
+		glClearNamedFramebufferfv(m_id, GL_DEPTH, 0, &depth);
+	}
+
+	void Framebuffer::blit(const Framebuffer* dst, int src_x0, int src_y0, int src_x1, int src_y1, int dst_x0, int dst_y0, int dst_x1, int dst_y1, GLbitfield mask, GLenum filter) const noexcept
+	{
+		glBlitNamedFramebuffer(m_id, dst ? dst->m_id : 0, src_x0, src_y0, src_x1, src_y1, dst_x0, dst_y0, dst_x1, dst_y1, mask, filter);
+	}
+
 	Framebuffer::Status Framebuffer::status(Target target) const noexcept
 	{
 		return (Framebuffer::Status)glCheckNamedFramebufferStatus(m_id, (GLenum)target);
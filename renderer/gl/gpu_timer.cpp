@@ -0,0 +1,143 @@
+#include <renderer/gl/gpu_timer.hpp>
+
+#include <glad/glad.h>
+
+namespace gfx::gl
+{
+	GpuTimer& GpuTimer::instance() noexcept
+	{
+		static GpuTimer timer;
+		return timer;
+	}
+
+	void GpuTimer::beginFrame()
+	{
+		// Resolve in submission order, a frame is only ever behind the ones before it
+		while (m_slots[m_oldest].pending && resolve(m_slots[m_oldest]))
+		{
+			m_slots[m_oldest].pending = false;
+			m_oldest = (m_oldest + 1) % FRAME_COUNT;
+		}
+
+		m_recording = false;
+		if (!util::Profiler::enabled())
+			return;
+
+		auto& slot = m_slots[m_current];
+		if (slot.pending)
+		{
+			++m_skipped;
+			return;
+		}
+
+		m_recording = true;
+		m_depth = 0;
+		slot.used = 0;
+		slot.records.clear();
+
+		// The GPU clock is only comparable to itself, the time the GL server reaches this point maps it to the CPU
+		GLint64 gpu_time = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+		slot.clockOffset = (int64_t)util::Profiler::now() - (int64_t)gpu_time;
+		slot.frameBegin = timestamp();
+	}
+
+	void GpuTimer::endFrame() noexcept
+	{
+		if (!m_recording)
+			return;
+
+		auto& slot = m_slots[m_current];
+		slot.frameEnd = timestamp();
+		slot.pending = true;
+
+		m_recording = false;
+		m_current = (m_current + 1) % FRAME_COUNT;
+	}
+
+	size_t GpuTimer::begin(const char* name) noexcept
+	{
+		if (!m_recording)
+			return NO_ZONE;
+
+		auto& slot = m_slots[m_current];
+		slot.records.push_back({ name, timestamp(), 0, m_depth++ });
+		return slot.records.size() - 1;
+	}
+
+	void GpuTimer::end(size_t zone) noexcept
+	{
+		if (zone == NO_ZONE || !m_recording)
+			return;
+
+		m_slots[m_current].records[zone].end = timestamp();
+		--m_depth;
+	}
+
+	void GpuTimer::release() noexcept
+	{
+		for (auto& slot : m_slots)
+			slot = {};
+
+		m_oldest = 0;
+		m_current = 0;
+		m_recording = false;
+	}
+
+	const GpuTimer::Frame& GpuTimer::lastFrame() const noexcept
+	{
+		return m_lastFrame;
+	}
+
+	size_t GpuTimer::skippedFrames() const noexcept
+	{
+		return m_skipped;
+	}
+
+	size_t GpuTimer::timestamp() noexcept
+	{
+		auto& slot = m_slots[m_current];
+		if (slot.used == slot.queries.size())
+			slot.queries.emplace_back(Query::Target::eTimestamp);
+
+		slot.queries[slot.used].counter();
+		return slot.used++;
+	}
+
+	bool GpuTimer::resolve(Slot& slot)
+	{
+		// The end of the frame is written last, nothing else is worth polling before it
+		if (!slot.queries[slot.frameEnd].available())
+			return false;
+
+		for (size_t i = 0; i < slot.used; ++i)
+		{
+			if (!slot.queries[i].available())
+				return false;
+		}
+
+		const auto time = [&slot](size_t query) {
+			return (uint64_t)((int64_t)slot.queries[query].result() + slot.clockOffset);
+		};
+
+		m_lastFrame.begin = time(slot.frameBegin);
+		m_lastFrame.end = time(slot.frameEnd);
+		m_lastFrame.zones.clear();
+
+		// Zones still open when the frame ended have no end timestamp
+		for (const auto& record : slot.records)
+		{
+			if (record.end != 0)
+				m_lastFrame.zones.push_back({ record.name, time(record.begin), time(record.end), record.depth });
+		}
+
+		if (util::Profiler::enabled())
+		{
+			auto& profiler = util::Profiler::instance();
+			for (const auto& zone : m_lastFrame.zones)
+				profiler.recordGpu(zone.name, zone.begin, zone.end);
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <renderer/gl/name_pool.hpp>
+
+namespace gfx::gl
+{
+	NamePool& NamePool::current() noexcept
+	{
+		thread_local NamePool pool;
+		return pool;
+	}
+
+	template<typename Create>
+	unsigned int NamePool::take(std::vector<unsigned int>& pool, Create&& create)
+	{
+		if (pool.empty())
+		{
+			pool.resize(BATCH_SIZE);
+			create((GLsizei)pool.size(), pool.data());
+		}
+
+		const auto name = pool.back();
+		pool.pop_back();
+		return name;
+	}
+
+	unsigned int NamePool::createBuffer()
+	{
+		return take(m_buffers, [](GLsizei n, unsigned int* names) { glCreateBuffers(n, names); });
+	}
+
+	unsigned int NamePool::createTexture(GLenum target)
+	{
+		return take(m_textures[target], [target](GLsizei n, unsigned int* names) { glCreateTextures(target, n, names); });
+	}
+
+	unsigned int NamePool::createVertexArray()
+	{
+		return take(m_vertexArrays, [](GLsizei n, unsigned int* names) { glCreateVertexArrays(n, names); });
+	}
+
+	unsigned int NamePool::createFramebuffer()
+	{
+		return take(m_framebuffers, [](GLsizei n, unsigned int* names) { glCreateFramebuffers(n, names); });
+	}
+
+	unsigned int NamePool::createRenderbuffer()
+	{
+		return take(m_renderbuffers, [](GLsizei n, unsigned int* names) { glCreateRenderbuffers(n, names); });
+	}
+
+	void NamePool::release() noexcept
+	{
+		glDeleteBuffers((GLsizei)m_buffers.size(), m_buffers.data());
+		m_buffers.clear();
+
+		for (const auto& [target, textures] : m_textures)
+		{
+			glDeleteTextures((GLsizei)textures.size(), textures.data());
+		}
+		m_textures.clear();
+
+		glDeleteVertexArrays((GLsizei)m_vertexArrays.size(), m_vertexArrays.data());
+		m_vertexArrays.clear();
+
+		glDeleteFramebuffers((GLsizei)m_framebuffers.size(), m_framebuffers.data());
+		m_framebuffers.clear();
+
+		glDeleteRenderbuffers((GLsizei)m_renderbuffers.size(), m_renderbuffers.data());
+		m_renderbuffers.clear();
+	}
+}
\ No newline at end of file
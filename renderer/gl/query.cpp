@@ -0,0 +1,74 @@
+#include <renderer/gl/query.hpp>
+
+#include <renderer/gl/deletion_queue.hpp>
+
+#include <utility>
+
+namespace gfx::gl
+{
+	Query::Query(Target target) noexcept :
+		m_target(target)
+	{
+		glCreateQueries((GLenum)target, 1, &m_id);
+	}
+
+	Query::Query(Query&& other) noexcept
+	{
+		using std::swap;
+		swap(m_id, other.m_id);
+		swap(m_target, other.m_target);
+	}
+
+	Query& Query::operator=(Query&& other) noexcept
+	{
+		using std::swap;
+		swap(m_id, other.m_id);
+		swap(m_target, other.m_target);
+
+		return *this;
+	}
+
+	Query::~Query() noexcept
+	{
+		DeletionQueue::instance().post(DeletionQueue::Type::eQuery, m_id);
+	}
+
+	void Query::begin() noexcept
+	{
+		glBeginQuery((GLenum)m_target, m_id);
+	}
+
+	void Query::end() noexcept
+	{
+		glEndQuery((GLenum)m_target);
+	}
+
+	void Query::counter() noexcept
+	{
+		glQueryCounter(m_id, GL_TIMESTAMP);
+	}
+
+	bool Query::available() const noexcept
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(m_id, GL_QUERY_RESULT_AVAILABLE, &available);
+		return available == GL_TRUE;
+	}
+
+	uint64_t Query::result() const noexcept
+	{
+		GLuint64 result = 0;
+		glGetQueryObjectui64v(m_id, GL_QUERY_RESULT, &result);
+		return result;
+	}
+
+	Query::Target Query::target() const noexcept
+	{
+		return m_target;
+	}
+
+	unsigned int Query::id() const noexcept
+	{
+		return m_id;
+	}
+}
\ No newline at end of file
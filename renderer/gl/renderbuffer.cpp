@@ -1,21 +1,24 @@
 #include <renderer/gl/renderbuffer.hpp>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+
 #include <utility>
 
 namespace gfx::gl
 {
 	Renderbuffer::Renderbuffer() noexcept
 	{
-		glCreateRenderbuffers(1, &m_id);
+		m_id = NamePool::current().createRenderbuffer();
 	}
 
-	Renderbuffer::Renderbuffer(Renderbuffer&& other)
+	Renderbuffer::Renderbuffer(Renderbuffer&& other) noexcept
 	{
 		using std::swap;
 		swap(m_id, other.m_id);
 	}
 
-	Renderbuffer& Renderbuffer::operator=(Renderbuffer&& other)
+	Renderbuffer& Renderbuffer::operator=(Renderbuffer&& other) noexcept
 	{
 		using std::swap;
 		swap(m_id, other.m_id);
@@ -25,7 +28,7 @@ namespace gfx::gl
 
 	Renderbuffer::~Renderbuffer()
 	{
-		glDeleteRenderbuffers(1, &m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eRenderbuffer, m_id);
 	}
 
 	void Renderbuffer::bind(Target target) const noexcept
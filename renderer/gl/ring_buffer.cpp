@@ -0,0 +1,111 @@
+#include <renderer/gl/ring_buffer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace gfx::gl
+{
+	namespace
+	{
+		size_t alignUp(size_t value, size_t alignment) noexcept
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	RingBuffer::RingBuffer(size_t frame_size, size_t frames) :
+		m_fences(frames)
+	{
+		if (frame_size == 0 || frames == 0)
+			throw std::invalid_argument("ring buffer size must be positive");
+
+		int uniform_alignment, storage_alignment;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage_alignment);
+		m_uniformAlignment = (size_t)std::max(uniform_alignment, 1);
+		m_storageAlignment = (size_t)std::max(storage_alignment, 1);
+
+		// Every frame region starts on a boundary valid for both binding types
+		m_frameSize = alignUp(frame_size, std::max(m_uniformAlignment, m_storageAlignment));
+
+		const auto size = m_frameSize * frames;
+		m_buffer.bufferStorage(size, nullptr, Buffer::StorageFlags::eMapWriteBit | Buffer::StorageFlags::eMapPersistentBit | Buffer::StorageFlags::eMapCoherentBit);
+		m_mapping = (unsigned char*)m_buffer.mapRange(0, size, Buffer::MapFlags::eMapWriteBit | Buffer::MapFlags::eMapPersistentBit | Buffer::MapFlags::eMapCoherentBit);
+		if (m_mapping == nullptr)
+			throw std::runtime_error("unable to map the ring buffer");
+	}
+
+	void RingBuffer::beginFrame() noexcept
+	{
+		m_frame = (m_frame + 1) % m_fences.size();
+		m_head = 0;
+
+		// Only blocks when the GPU still reads this region
+		auto& fence = m_fences[m_frame];
+		while (fence.wait(1000000000ull) == Fence::Status::eTimeoutExpired)
+		{ }
+		fence.reset();
+	}
+
+	void RingBuffer::endFrame() noexcept
+	{
+		m_fences[m_frame].insert();
+	}
+
+	RingBuffer::Allocation RingBuffer::allocate(size_t size, size_t alignment)
+	{
+		const auto offset = alignUp(m_head, std::max<size_t>(alignment, 1));
+		if (offset + size > m_frameSize)
+			throw std::runtime_error("ring buffer frame region exhausted");
+
+		m_head = offset + size;
+
+		const auto buffer_offset = m_frame * m_frameSize + offset;
+		return { m_mapping + buffer_offset, buffer_offset, size };
+	}
+
+	RingBuffer::Allocation RingBuffer::allocateUniform(size_t size)
+	{
+		return allocate(size, m_uniformAlignment);
+	}
+
+	RingBuffer::Allocation RingBuffer::allocateStorage(size_t size)
+	{
+		return allocate(size, m_storageAlignment);
+	}
+
+	void RingBuffer::bindRange(Buffer::Target target, unsigned int index, const Allocation& allocation) const noexcept
+	{
+		m_buffer.bindRange(target, index, allocation.offset, allocation.size);
+	}
+
+	const Buffer& RingBuffer::buffer() const noexcept
+	{
+		return m_buffer;
+	}
+
+	size_t RingBuffer::frameSize() const noexcept
+	{
+		return m_frameSize;
+	}
+
+	size_t RingBuffer::frameCount() const noexcept
+	{
+		return m_fences.size();
+	}
+
+	size_t RingBuffer::used() const noexcept
+	{
+		return m_head;
+	}
+
+	size_t RingBuffer::uniformAlignment() const noexcept
+	{
+		return m_uniformAlignment;
+	}
+
+	size_t RingBuffer::storageAlignment() const noexcept
+	{
+		return m_storageAlignment;
+	}
+}
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/utility/profiler.hpp>
+
 namespace gfx::gl
 {
 	Shader::Shader(Target target) noexcept :
@@ -39,38 +42,70 @@ namespace gfx::gl
 
 	Shader::~Shader()
 	{
-		glDeleteShader(m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eShader, m_id);
 	}
 
 	void Shader::loadSource(const std::string& data)
 	{
+		RENDERER_PROFILE_SCOPE("Shader::loadSource");
+		compile(data);
+
+#if !defined(NDEBUG) || defined(RENDER_ENABLE_SHADER_DEBUG)
+		if (!compiled())
+		{
+			auto info_log = infoLog();
+			if (info_log.empty())
+				throw std::runtime_error("unknown shader compilation error");
 
+			throw std::runtime_error(info_log);
+		}
+#endif
+	}
+
+	void Shader::compile(const std::string& data) noexcept
+	{
 		const int shader_data_size = data.size();
 		const char* const shader_data_ptr = data.data();
 		glShaderSource(m_id, 1, &shader_data_ptr, &shader_data_size);
 		glCompileShader(m_id);
+	}
 
-#if !defined(NDEBUG) || defined(RENDER_ENABLE_SHADER_DEBUG)
+	bool Shader::completed() const noexcept
+	{
+		if (!parallelCompileSupported())
+			return true;
+
+		int completed;
+		glGetShaderiv(m_id, GL_COMPLETION_STATUS_KHR, &completed);
+		return completed == GL_TRUE;
+	}
+
+	bool Shader::compiled() const noexcept
+	{
+		int status;
+		glGetShaderiv(m_id, GL_COMPILE_STATUS, &status);
+		return status == GL_TRUE;
+	}
+
+	std::string Shader::infoLog() const
+	{
+		int info_log_len;
+		glGetShaderiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
+
+		std::string info_log;
+		if (info_log_len > 0)
 		{
-			int status, info_log_len;
-			glGetShaderiv(m_id, GL_COMPILE_STATUS, &status);
-			glGetShaderiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
-			if (!status)
-			{
-				if (info_log_len > 0)
-				{
-					std::string info_log;
-					info_log.resize(info_log_len);
-					glGetShaderInfoLog(m_id, info_log_len, nullptr, info_log.data());
-					throw std::runtime_error(info_log);
-				}
-				else
-				{
-					throw std::runtime_error("unknown shader compilation error");
-				}
-			}
+			info_log.resize(info_log_len);
+			glGetShaderInfoLog(m_id, info_log_len, nullptr, info_log.data());
+			info_log.resize(info_log_len - 1);
 		}
-#endif
+
+		return info_log;
+	}
+
+	bool Shader::parallelCompileSupported() noexcept
+	{
+		return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
 	}
 
 	Shader::Target Shader::target() const noexcept
@@ -1,2 +1,152 @@
-//#include <renderer/gl/shader_pipeline.hpp>
+#include <renderer/gl/shader_pipeline.hpp>
 
+#include <bit>
+#include <utility>
+
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/state_cache.hpp>
+
+namespace gfx::gl
+{
+	namespace
+	{
+		// Stage bits are consecutive, GL_VERTEX_SHADER_BIT through GL_COMPUTE_SHADER_BIT
+		constexpr GLenum ALL_STAGES = (1u << ShaderPipeline::STAGE_COUNT) - 1;
+
+		size_t stageIndex(ShaderProgram::TargetFlags stage) noexcept
+		{
+			return (size_t)std::countr_zero((GLenum)stage);
+		}
+	}
+
+	ShaderPipeline::ShaderPipeline() noexcept
+	{
+		glCreateProgramPipelines(1, &m_id);
+	}
+
+	ShaderPipeline::ShaderPipeline(ShaderPipeline&& other) noexcept
+	{
+		using std::swap;
+		swap(m_programs, other.m_programs);
+		swap(m_flags, other.m_flags);
+		swap(m_id, other.m_id);
+	}
+
+	ShaderPipeline& ShaderPipeline::operator=(ShaderPipeline&& other) noexcept
+	{
+		using std::swap;
+		swap(m_programs, other.m_programs);
+		swap(m_flags, other.m_flags);
+		swap(m_id, other.m_id);
+
+		return *this;
+	}
+
+	ShaderPipeline::~ShaderPipeline() noexcept
+	{
+		DeletionQueue::instance().post(DeletionQueue::Type::eProgramPipeline, m_id);
+	}
+
+	void ShaderPipeline::useProgram(const ShaderProgram& program) noexcept
+	{
+		useProgram(program, program.flags());
+	}
+
+	void ShaderPipeline::useProgram(const ShaderProgram& program, TargetFlags stages) noexcept
+	{
+		stages &= program.flags();
+		if (stages == (TargetFlags)0)
+			return;
+
+		glUseProgramStages(m_id, (GLbitfield)stages, program.id());
+		for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
+		{
+			if (((GLenum)stages & (1u << stage)) != 0)
+				m_programs[stage] = &program;
+		}
+		m_flags |= stages;
+	}
+
+	void ShaderPipeline::clearStages(TargetFlags stages) noexcept
+	{
+		stages &= (TargetFlags)ALL_STAGES;
+		glUseProgramStages(m_id, (GLbitfield)stages, 0);
+		for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
+		{
+			if (((GLenum)stages & (1u << stage)) != 0)
+				m_programs[stage] = nullptr;
+		}
+		m_flags = (TargetFlags)((GLenum)m_flags & ~(GLenum)stages);
+	}
+
+	void ShaderPipeline::validate() const
+	{
+		glValidateProgramPipeline(m_id);
+
+		int status;
+		glGetProgramPipelineiv(m_id, GL_VALIDATE_STATUS, &status);
+		if (!status)
+		{
+			auto info_log = infoLog();
+			if (info_log.empty())
+				throw std::runtime_error("unknown program pipeline validation error");
+
+			throw std::runtime_error(info_log);
+		}
+	}
+
+	std::string ShaderPipeline::infoLog() const
+	{
+		int info_log_len;
+		glGetProgramPipelineiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
+
+		std::string info_log;
+		if (info_log_len > 0)
+		{
+			info_log.resize(info_log_len);
+			glGetProgramPipelineInfoLog(m_id, info_log_len, nullptr, info_log.data());
+			info_log.resize(info_log_len - 1);
+		}
+
+		return info_log;
+	}
+
+	void ShaderPipeline::bind() const noexcept
+	{
+		auto& state = StateCache::current();
+		state.useProgram(0);
+		state.bindProgramPipeline(m_id);
+	}
+
+	void ShaderPipeline::unbind() const noexcept
+	{
+		StateCache::current().bindProgramPipeline(0);
+	}
+
+	const ShaderProgram* ShaderPipeline::program(TargetFlags stage) const noexcept
+	{
+		const auto index = stageIndex(stage);
+		return index < STAGE_COUNT ? m_programs[index] : nullptr;
+	}
+
+	ShaderPipeline::TargetFlags ShaderPipeline::flags() const noexcept
+	{
+		return m_flags;
+	}
+
+	unsigned int ShaderPipeline::id() const noexcept
+	{
+		return m_id;
+	}
+
+	size_t ShaderPipeline::firstStage(const ShaderProgram& program) const noexcept
+	{
+		for (size_t stage = 0; stage < STAGE_COUNT; ++stage)
+		{
+			if (m_programs[stage] == &program)
+				return stage;
+		}
+
+		return STAGE_COUNT;
+	}
+}
\ No newline at end of file
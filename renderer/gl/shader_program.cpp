@@ -1,20 +1,92 @@
 #include <renderer/gl/shader_program.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <utility>
 
 #include <glad/glad.h>
 #include <glfw/glfw3.h>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/utility/profiler.hpp>
+
 namespace gfx::gl
 {
+	namespace
+	{
+		struct ValueType
+		{
+			GLenum type;
+			GLenum component;
+			uint32_t components;
+		};
+
+		// Types not listed are opaque (samplers, images), which are set as a single integer
+		constexpr ValueType VALUE_TYPES[] = {
+			{ GL_FLOAT, GL_FLOAT, 1 }, { GL_FLOAT_VEC2, GL_FLOAT, 2 }, { GL_FLOAT_VEC3, GL_FLOAT, 3 }, { GL_FLOAT_VEC4, GL_FLOAT, 4 },
+			{ GL_FLOAT_MAT2, GL_FLOAT, 4 }, { GL_FLOAT_MAT3, GL_FLOAT, 9 }, { GL_FLOAT_MAT4, GL_FLOAT, 16 },
+			{ GL_FLOAT_MAT2x3, GL_FLOAT, 6 }, { GL_FLOAT_MAT2x4, GL_FLOAT, 8 }, { GL_FLOAT_MAT3x2, GL_FLOAT, 6 },
+			{ GL_FLOAT_MAT3x4, GL_FLOAT, 12 }, { GL_FLOAT_MAT4x2, GL_FLOAT, 8 }, { GL_FLOAT_MAT4x3, GL_FLOAT, 12 },
+			{ GL_INT, GL_INT, 1 }, { GL_INT_VEC2, GL_INT, 2 }, { GL_INT_VEC3, GL_INT, 3 }, { GL_INT_VEC4, GL_INT, 4 },
+			{ GL_BOOL, GL_INT, 1 }, { GL_BOOL_VEC2, GL_INT, 2 }, { GL_BOOL_VEC3, GL_INT, 3 }, { GL_BOOL_VEC4, GL_INT, 4 },
+			{ GL_UNSIGNED_INT, GL_UNSIGNED_INT, 1 }, { GL_UNSIGNED_INT_VEC2, GL_UNSIGNED_INT, 2 },
+			{ GL_UNSIGNED_INT_VEC3, GL_UNSIGNED_INT, 3 }, { GL_UNSIGNED_INT_VEC4, GL_UNSIGNED_INT, 4 },
+			{ GL_DOUBLE, GL_DOUBLE, 1 }, { GL_DOUBLE_VEC2, GL_DOUBLE, 2 }, { GL_DOUBLE_VEC3, GL_DOUBLE, 3 }, { GL_DOUBLE_VEC4, GL_DOUBLE, 4 },
+			{ GL_DOUBLE_MAT2, GL_DOUBLE, 4 }, { GL_DOUBLE_MAT3, GL_DOUBLE, 9 }, { GL_DOUBLE_MAT4, GL_DOUBLE, 16 }
+		};
+
+		ValueType valueType(GLenum type) noexcept
+		{
+			for (const auto& value_type : VALUE_TYPES)
+			{
+				if (value_type.type == type)
+					return value_type;
+			}
+
+			return { type, GL_INT, 1 };
+		}
+
+		bool isOpaque(GLenum type) noexcept
+		{
+			return std::none_of(std::begin(VALUE_TYPES), std::end(VALUE_TYPES), [type](const auto& value_type) { return value_type.type == type; });
+		}
+	}
+
+	bool UniformTraits<int>::accepts(GLenum type) noexcept
+	{
+		return type == GL_INT || type == GL_BOOL || isOpaque(type);
+	}
+
 	ShaderProgram::ShaderProgram() noexcept
 	{
 		m_id = glCreateProgram();
 	}
 
+	ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
+	{
+		using std::swap;
+		swap(m_uniforms, other.m_uniforms);
+		swap(m_uniformValues, other.m_uniformValues);
+		swap(m_flags, other.m_flags);
+		swap(m_id, other.m_id);
+	}
+
+	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept
+	{
+		using std::swap;
+		swap(m_uniforms, other.m_uniforms);
+		swap(m_uniformValues, other.m_uniformValues);
+		swap(m_flags, other.m_flags);
+		swap(m_id, other.m_id);
+
+		return *this;
+	}
+
 	ShaderProgram::~ShaderProgram() noexcept
 	{
-		glDeleteProgram(m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eShaderProgram, m_id);
 	}
 
 	void ShaderProgram::attachShader(const Shader& shader) noexcept
@@ -29,28 +101,63 @@ namespace gfx::gl
 
 	void ShaderProgram::link()
 	{
-		glLinkProgram(m_id);
+		RENDERER_PROFILE_SCOPE("ShaderProgram::link");
+		startLink();
 #if !defined(NDEBUG) || defined(RENDERER_ENABLE_SHADER_PROGRAM_DEBUG)
+		finishLink();
+#else
+		readStages();
+		reflectUniforms();
+#endif
+	}
+
+	void ShaderProgram::startLink() noexcept
+	{
+		glLinkProgram(m_id);
+	}
+
+	bool ShaderProgram::completed() const noexcept
+	{
+		if (!Shader::parallelCompileSupported())
+			return true;
+
+		int completed;
+		glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &completed);
+		return completed == GL_TRUE;
+	}
+
+	void ShaderProgram::finishLink()
+	{
+		RENDERER_PROFILE_SCOPE("ShaderProgram::finishLink");
+		int status;
+		glGetProgramiv(m_id, GL_LINK_STATUS, &status);
+		if (!status)
 		{
-			int status, info_log_len;
-			glGetProgramiv(m_id, GL_LINK_STATUS, &status);
-			glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
-			if (!status)
-			{
-				if (info_log_len > 0)
-				{
-					std::string info_log;
-					info_log.resize(info_log_len);
-					glGetProgramInfoLog(m_id, info_log_len, nullptr, info_log.data());
-					throw std::runtime_error(info_log);
-				}
-				else
-				{
-					throw std::runtime_error("unknown shader program link error");
-				}
-			}
+			auto info_log = infoLog();
+			if (info_log.empty())
+				throw std::runtime_error("unknown shader program link error");
+
+			throw std::runtime_error(info_log);
 		}
-#endif
+
+		readStages();
+		reflectUniforms();
+	}
+
+	std::string ShaderProgram::infoLog() const
+	{
+		int info_log_len;
+		glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &info_log_len);
+
+		std::string info_log;
+		if (info_log_len > 0)
+		{
+			info_log.resize(info_log_len);
+			glGetProgramInfoLog(m_id, info_log_len, nullptr, info_log.data());
+			info_log.resize(info_log_len - 1);
+		}
+
+		return info_log;
 	}
 
 	void ShaderProgram::parameter(ShaderProgram::Parameter param, bool value) noexcept
@@ -58,6 +165,61 @@ namespace gfx::gl
 		glProgramParameteri(m_id, (GLenum)param, value ? GL_TRUE : GL_FALSE);
 	}
 
+	ShaderProgram::Binary ShaderProgram::binary() const
+	{
+		int length = 0;
+		glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+
+		Binary binary;
+		binary.flags = m_flags;
+		binary.data.resize(length);
+		if (length > 0)
+			glGetProgramBinary(m_id, length, nullptr, &binary.format, binary.data.data());
+
+		return binary;
+	}
+
+	bool ShaderProgram::loadBinary(const Binary& binary)
+	{
+		RENDERER_PROFILE_SCOPE("ShaderProgram::loadBinary");
+		glProgramBinary(m_id, binary.format, binary.data.data(), (GLsizei)binary.data.size());
+
+		int status;
+		glGetProgramiv(m_id, GL_LINK_STATUS, &status);
+		if (!status)
+			return false;
+
+		// A loaded program has no attached shaders to read the stages from
+		m_flags = binary.flags;
+		reflectUniforms();
+		return true;
+	}
+
+	void ShaderProgram::readStages()
+	{
+		// Stages are read back from the attached shaders, which are commonly detached right after linking
+		int num_shaders;
+		glGetProgramiv(m_id, GL_ATTACHED_SHADERS, &num_shaders);
+		std::vector<unsigned int> shaders(num_shaders);
+		glGetAttachedShaders(m_id, num_shaders, nullptr, shaders.data());
+
+		m_flags = (TargetFlags)0;
+		for (const auto shader : shaders)
+		{
+			int type;
+			glGetShaderiv(shader, GL_SHADER_TYPE, &type);
+			switch (type)
+			{
+			case GL_VERTEX_SHADER: m_flags |= TargetFlags::eVertex; break;
+			case GL_FRAGMENT_SHADER: m_flags |= TargetFlags::eFragment; break;
+			case GL_GEOMETRY_SHADER: m_flags |= TargetFlags::eGeometry; break;
+			case GL_TESS_CONTROL_SHADER: m_flags |= TargetFlags::eTesselationCtrl; break;
+			case GL_TESS_EVALUATION_SHADER: m_flags |= TargetFlags::eTesselationEval; break;
+			case GL_COMPUTE_SHADER: m_flags |= TargetFlags::eCompute; break;
+			}
+		}
+	}
+
 	int ShaderProgram::getUniform(const std::string& uniform_name) const
 	{
 		return getUniform(uniform_name.c_str());
@@ -65,20 +227,30 @@ namespace gfx::gl
 
 	int ShaderProgram::getUniform(const char* uniform_name) const
 	{
+		const auto it = m_uniforms.find(uniform_name);
+		if (it != m_uniforms.end())
+			return it->second.location;
+
+		// Not reflected, e.g. a single element of an array
 		int val = glGetUniformLocation(m_id, uniform_name);
 		if (val < 0)
 			throw std::runtime_error(std::string("Unable to find uniform with name '") + uniform_name + "'");
 		return val;
 	}
 
+	bool ShaderProgram::hasUniform(const std::string& uniform_name) const noexcept
+	{
+		return m_uniforms.find(uniform_name) != m_uniforms.end();
+	}
+
 	void ShaderProgram::bind() const noexcept
 	{
-		glUseProgram(m_id);
+		StateCache::current().useProgram(m_id);
 	}
 
 	void ShaderProgram::unbind() const noexcept
 	{
-		glUseProgram(0);
+		StateCache::current().useProgram(0);
 	}
 
 	std::vector<std::string> ShaderProgram::getUniformNames() const
@@ -130,6 +302,79 @@ namespace gfx::gl
 		return attributes;
 	}
 
+	void ShaderProgram::reflectUniforms()
+	{
+		m_uniforms.clear();
+		m_uniformValues.clear();
+
+		int num_uniforms, max_name_len;
+		glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &num_uniforms);
+		glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_name_len);
+		std::string temp_name;
+		temp_name.resize(max_name_len);
+
+		constexpr GLenum properties[] = { GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE };
+		for (int i = 0; i < num_uniforms; ++i)
+		{
+			int values[3];
+			glGetProgramResourceiv(m_id, GL_UNIFORM, i, 3, properties, 3, nullptr, values);
+
+			// Members of uniform blocks have no location
+			if (values[0] < 0)
+				continue;
+
+			const auto value_type = valueType((GLenum)values[1]);
+			const uint32_t element_size = value_type.components * (value_type.component == GL_DOUBLE ? 8 : 4);
+
+			UniformInfo info;
+			info.location = values[0];
+			info.type = (GLenum)values[1];
+			info.count = (uint32_t)values[2];
+			info.offset = (uint32_t)m_uniformValues.size();
+			m_uniformValues.resize(m_uniformValues.size() + element_size * info.count);
+
+			// Seed the shadow with the initial values, array elements have consecutive locations
+			for (uint32_t element = 0; element < info.count; ++element)
+			{
+				auto* shadow = m_uniformValues.data() + info.offset + element * element_size;
+				const int location = info.location + (int)element;
+				switch (value_type.component)
+				{
+				case GL_FLOAT: glGetUniformfv(m_id, location, reinterpret_cast<float*>(shadow)); break;
+				case GL_UNSIGNED_INT: glGetUniformuiv(m_id, location, reinterpret_cast<unsigned int*>(shadow)); break;
+				case GL_DOUBLE: glGetUniformdv(m_id, location, reinterpret_cast<double*>(shadow)); break;
+				default: glGetUniformiv(m_id, location, reinterpret_cast<int*>(shadow)); break;
+				}
+			}
+
+			GLsizei actual_length;
+			glGetProgramResourceName(m_id, GL_UNIFORM, i, (GLsizei)temp_name.size(), &actual_length, temp_name.data());
+			std::string name(temp_name.data(), actual_length);
+
+			if (name.ends_with("[0]"))
+				m_uniforms.emplace(name.substr(0, name.size() - 3), info);
+			m_uniforms.emplace(std::move(name), info);
+		}
+	}
+
+	const ShaderProgram::UniformInfo& ShaderProgram::uniformInfo(const std::string& uniform_name) const
+	{
+		const auto it = m_uniforms.find(uniform_name);
+		if (it == m_uniforms.end())
+			throw std::runtime_error("Unable to find uniform with name '" + uniform_name + "'");
+
+		return it->second;
+	}
+
+	const ShaderProgram::UniformInfo& ShaderProgram::uniformInfo(int location) const
+	{
+		const auto it = std::find_if(m_uniforms.begin(), m_uniforms.end(), [location](const auto& entry) { return entry.second.location == location; });
+		if (it == m_uniforms.end())
+			throw std::runtime_error("Unable to find uniform at location " + std::to_string(location));
+
+		return it->second;
+	}
+
 	ShaderProgram::TargetFlags ShaderProgram::flags() const noexcept
 	{
 		return m_flags;
@@ -0,0 +1,353 @@
+#include <renderer/gl/state_cache.hpp>
+
+#include <iterator>
+
+namespace gfx::gl
+{
+	namespace
+	{
+		constexpr GLenum BUFFER_TARGETS[] = {
+			GL_ARRAY_BUFFER, GL_ATOMIC_COUNTER_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+			GL_DISPATCH_INDIRECT_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_PARAMETER_BUFFER, GL_PIXEL_PACK_BUFFER,
+			GL_PIXEL_UNPACK_BUFFER, GL_QUERY_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_TEXTURE_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER
+		};
+
+		constexpr GLenum INDEXED_TARGETS[] = {
+			GL_ATOMIC_COUNTER_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER
+		};
+
+		constexpr GLenum CAPABILITIES[] = {
+			GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST,
+			GL_STENCIL_TEST, GL_FRAMEBUFFER_SRGB, GL_MULTISAMPLE, GL_POLYGON_OFFSET_FILL
+		};
+	}
+
+	StateCache& StateCache::current() noexcept
+	{
+		thread_local StateCache cache;
+		return cache;
+	}
+
+	StateCache::StateCache() noexcept
+	{
+		invalidate();
+	}
+
+	void StateCache::useProgram(unsigned int program) noexcept
+	{
+		if (changed(m_program != program))
+		{
+			glUseProgram(program);
+			m_program = program;
+		}
+	}
+
+	void StateCache::bindProgramPipeline(unsigned int pipeline) noexcept
+	{
+		if (changed(m_programPipeline != pipeline))
+		{
+			glBindProgramPipeline(pipeline);
+			m_programPipeline = pipeline;
+		}
+	}
+
+	void StateCache::bindVertexArray(unsigned int vertex_array) noexcept
+	{
+		if (changed(m_vertexArray != vertex_array))
+		{
+			glBindVertexArray(vertex_array);
+			m_vertexArray = vertex_array;
+		}
+	}
+
+	void StateCache::bindBuffer(GLenum target, unsigned int buffer) noexcept
+	{
+		const auto slot = bufferSlot(target);
+		if (slot < 0)
+		{
+			changed(true);
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (changed(m_buffers[slot] != buffer))
+		{
+			glBindBuffer(target, buffer);
+			m_buffers[slot] = buffer;
+		}
+	}
+
+	void StateCache::bindBufferBase(GLenum target, unsigned int index, unsigned int buffer) noexcept
+	{
+		const auto slot = indexedSlot(target);
+		if (slot < 0 || index >= MAX_INDEXED_BINDINGS)
+		{
+			changed(true);
+			glBindBufferBase(target, index, buffer);
+			if (slot >= 0)
+				m_buffers[bufferSlot(target)] = buffer;
+			return;
+		}
+
+		// A whole buffer binding is recorded with a zero size
+		auto& binding = m_indexedBuffers[slot][index];
+		if (changed(binding.buffer != buffer || binding.offset != 0 || binding.size != 0))
+		{
+			glBindBufferBase(target, index, buffer);
+			binding = { buffer, 0, 0 };
+			m_buffers[bufferSlot(target)] = buffer;
+		}
+	}
+
+	void StateCache::bindBufferRange(GLenum target, unsigned int index, unsigned int buffer, size_t offset, size_t size) noexcept
+	{
+		const auto slot = indexedSlot(target);
+		if (slot < 0 || index >= MAX_INDEXED_BINDINGS)
+		{
+			changed(true);
+			glBindBufferRange(target, index, buffer, offset, size);
+			if (slot >= 0)
+				m_buffers[bufferSlot(target)] = buffer;
+			return;
+		}
+
+		auto& binding = m_indexedBuffers[slot][index];
+		if (changed(binding.buffer != buffer || binding.offset != offset || binding.size != size))
+		{
+			glBindBufferRange(target, index, buffer, offset, size);
+			binding = { buffer, offset, size };
+			m_buffers[bufferSlot(target)] = buffer;
+		}
+	}
+
+	void StateCache::bindTextureUnit(unsigned int unit, unsigned int texture) noexcept
+	{
+		if (unit >= MAX_UNITS)
+		{
+			changed(true);
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+
+		if (changed(m_textures[unit] != texture))
+		{
+			glBindTextureUnit(unit, texture);
+			m_textures[unit] = texture;
+		}
+	}
+
+	void StateCache::bindSampler(unsigned int unit, unsigned int sampler) noexcept
+	{
+		if (unit >= MAX_UNITS)
+		{
+			changed(true);
+			glBindSampler(unit, sampler);
+			return;
+		}
+
+		if (changed(m_samplers[unit] != sampler))
+		{
+			glBindSampler(unit, sampler);
+			m_samplers[unit] = sampler;
+		}
+	}
+
+	void StateCache::bindFramebuffer(GLenum target, unsigned int framebuffer) noexcept
+	{
+		const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+		const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+
+		if (changed((read && m_readFramebuffer != framebuffer) || (draw && m_drawFramebuffer != framebuffer)))
+		{
+			glBindFramebuffer(target, framebuffer);
+			if (read)
+				m_readFramebuffer = framebuffer;
+			if (draw)
+				m_drawFramebuffer = framebuffer;
+		}
+	}
+
+	void StateCache::setEnabled(GLenum capability, bool enabled) noexcept
+	{
+		for (auto& tracked : m_capabilities)
+		{
+			if (tracked.capability != capability)
+				continue;
+
+			if (changed(tracked.state != (int)enabled))
+			{
+				enabled ? glEnable(capability) : glDisable(capability);
+				tracked.state = enabled;
+			}
+			return;
+		}
+
+		changed(true);
+		enabled ? glEnable(capability) : glDisable(capability);
+	}
+
+	void StateCache::blendFunc(GLenum source, GLenum destination) noexcept
+	{
+		if (changed(m_blendSource != source || m_blendDestination != destination))
+		{
+			glBlendFunc(source, destination);
+			m_blendSource = source;
+			m_blendDestination = destination;
+		}
+	}
+
+	void StateCache::depthFunc(GLenum function) noexcept
+	{
+		if (changed(m_depthFunc != function))
+		{
+			glDepthFunc(function);
+			m_depthFunc = function;
+		}
+	}
+
+	void StateCache::depthMask(bool write) noexcept
+	{
+		if (changed(m_depthMask != (int)write))
+		{
+			glDepthMask(write ? GL_TRUE : GL_FALSE);
+			m_depthMask = write;
+		}
+	}
+
+	void StateCache::cullFace(GLenum mode) noexcept
+	{
+		if (changed(m_cullFace != mode))
+		{
+			glCullFace(mode);
+			m_cullFace = mode;
+		}
+	}
+
+	void StateCache::invalidate() noexcept
+	{
+		m_program = UNKNOWN;
+		m_programPipeline = UNKNOWN;
+		m_vertexArray = UNKNOWN;
+		m_readFramebuffer = UNKNOWN;
+		m_drawFramebuffer = UNKNOWN;
+		m_buffers.fill(UNKNOWN);
+		for (auto& bindings : m_indexedBuffers)
+			bindings.fill(IndexedBinding{});
+		m_textures.fill(UNKNOWN);
+		m_samplers.fill(UNKNOWN);
+
+		for (size_t i = 0; i < m_capabilities.size(); ++i)
+			m_capabilities[i] = { CAPABILITIES[i], -1 };
+
+		m_blendSource = m_blendDestination = UNKNOWN;
+		m_depthFunc = UNKNOWN;
+		m_depthMask = -1;
+		m_cullFace = UNKNOWN;
+	}
+
+	void StateCache::forgetProgram(unsigned int program) noexcept
+	{
+		if (m_program == program)
+			m_program = UNKNOWN;
+	}
+
+	void StateCache::forgetProgramPipeline(unsigned int pipeline) noexcept
+	{
+		if (m_programPipeline == pipeline)
+			m_programPipeline = UNKNOWN;
+	}
+
+	void StateCache::forgetVertexArray(unsigned int vertex_array) noexcept
+	{
+		if (m_vertexArray == vertex_array)
+			m_vertexArray = UNKNOWN;
+	}
+
+	void StateCache::forgetBuffer(unsigned int buffer) noexcept
+	{
+		for (auto& bound : m_buffers)
+		{
+			if (bound == buffer)
+				bound = UNKNOWN;
+		}
+
+		for (auto& bindings : m_indexedBuffers)
+		{
+			for (auto& binding : bindings)
+			{
+				if (binding.buffer == buffer)
+					binding = IndexedBinding{};
+			}
+		}
+	}
+
+	void StateCache::forgetTexture(unsigned int texture) noexcept
+	{
+		for (auto& bound : m_textures)
+		{
+			if (bound == texture)
+				bound = UNKNOWN;
+		}
+	}
+
+	void StateCache::forgetTextureUnits() noexcept
+	{
+		m_textures.fill(UNKNOWN);
+	}
+
+	void StateCache::forgetSampler(unsigned int sampler) noexcept
+	{
+		for (auto& bound : m_samplers)
+		{
+			if (bound == sampler)
+				bound = UNKNOWN;
+		}
+	}
+
+	void StateCache::forgetFramebuffer(unsigned int framebuffer) noexcept
+	{
+		if (m_readFramebuffer == framebuffer)
+			m_readFramebuffer = UNKNOWN;
+		if (m_drawFramebuffer == framebuffer)
+			m_drawFramebuffer = UNKNOWN;
+	}
+
+	void StateCache::endFrame() noexcept
+	{
+		m_lastFrame = m_frame;
+		m_frame = {};
+	}
+
+	const StateCache::Stats& StateCache::frameStats() const noexcept
+	{
+		return m_lastFrame;
+	}
+
+	bool StateCache::changed(bool changed) noexcept
+	{
+		++m_frame.calls;
+		if (!changed)
+			++m_frame.skipped;
+		return changed;
+	}
+
+	int StateCache::bufferSlot(GLenum target) const noexcept
+	{
+		for (int i = 0; i < (int)std::size(BUFFER_TARGETS); ++i)
+		{
+			if (BUFFER_TARGETS[i] == target)
+				return i;
+		}
+		return -1;
+	}
+
+	int StateCache::indexedSlot(GLenum target) const noexcept
+	{
+		for (int i = 0; i < (int)std::size(INDEXED_TARGETS); ++i)
+		{
+			if (INDEXED_TARGETS[i] == target)
+				return i;
+		}
+		return -1;
+	}
+}
\ No newline at end of file
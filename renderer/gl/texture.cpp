@@ -1,12 +1,17 @@
 #include <renderer/gl/texture.hpp>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/utility/profiler.hpp>
+
 #include <utility>
 
 namespace gfx::gl
 {
 	Texture::Texture(Target target) noexcept
 	{
-		glCreateTextures((GLenum)target, 1, &m_id);
+		m_id = NamePool::current().createTexture((GLenum)target);
 	}
 
 	Texture::Texture(Texture&& other) noexcept
@@ -23,24 +28,42 @@ namespace gfx::gl
 		return *this;
 	}
 
+	Texture::~Texture() noexcept
+	{
+		DeletionQueue::instance().post(DeletionQueue::Type::eTexture, m_id);
+	}
+
 	void Texture::bind(Target target) const noexcept
 	{
+		// Binds on the active unit, which the cache does not track
 		glBindTexture((GLenum) target, m_id);
+		StateCache::current().forgetTextureUnits();
 	}
 
 	void Texture::unbind(Target target) const noexcept
 	{
 		glBindTexture((GLenum) target, 0);
+		StateCache::current().forgetTextureUnits();
 	}
 
 	void Texture::bindUnit(int unit) const noexcept
 	{
-		glBindTextureUnit(unit, m_id);
+		StateCache::current().bindTextureUnit(unit, m_id);
 	}
 
 	void Texture::unbindUnit(int unit) const noexcept
 	{
-		glBindTextureUnit(unit, 0);
+		StateCache::current().bindTextureUnit(unit, 0);
+	}
+
+	void Texture::bindImage(unsigned int unit, int level, Access access, DataFormat format) const noexcept
+	{
+		glBindImageTexture(unit, m_id, level, GL_TRUE, 0, (GLenum)access, (GLenum)format);
+	}
+
+	void Texture::bindImageLayer(unsigned int unit, int level, int layer, Access access, DataFormat format) const noexcept
+	{
+		glBindImageTexture(unit, m_id, level, GL_FALSE, layer, (GLenum)access, (GLenum)format);
 	}
 
 	void Texture::parameter(Parameter pname, float param) noexcept
@@ -105,11 +128,13 @@ namespace gfx::gl
 
 	void Texture::subImage2D(int level, int xoffset, int yoffset, ssize_t width, ssize_t height, DataFormat format, Type type, const void* pixels) noexcept
 	{
+		RENDERER_PROFILE_SCOPE("Texture::subImage2D");
 		glTextureSubImage2D(m_id, level, xoffset, yoffset, width, height, (GLenum)format, (GLenum)type, pixels);
 	}
 
 	void Texture::subImage3D(int level, int xoffset, int yoffset, int zoffset, ssize_t width, ssize_t height, ssize_t depth, DataFormat format, Type type, const void* pixels) noexcept
 	{
+		RENDERER_PROFILE_SCOPE("Texture::subImage3D");
 		glTextureSubImage3D(m_id, level, xoffset, yoffset, zoffset, width, height, depth, (GLenum)format, (GLenum)type, pixels);
 	}
 
@@ -143,6 +168,11 @@ namespace gfx::gl
 		glCopyTextureSubImage3D(m_id, level, xoffset, yoffset, zoffset, x, y, width, height);
 	}
 
+	void Texture::copyImageSubData(Target target, int level, int x, int y, int z, Texture& dst, Target dst_target, int dst_level, int dst_x, int dst_y, int dst_z, ssize_t width, ssize_t height, ssize_t depth) const noexcept
+	{
+		glCopyImageSubData(m_id, (GLenum)target, level, x, y, z, dst.m_id, (GLenum)dst_target, dst_level, dst_x, dst_y, dst_z, width, height, depth);
+	}
+
 	void Texture::getTextureImage(int level, DataFormat format, Type type, ssize_t buf_size, void* pixels) noexcept
 	{
 		glGetTextureImage(m_id, level, (GLenum)format, (GLenum)type, buf_size, pixels);
@@ -150,9 +180,25 @@ namespace gfx::gl
 
 	void Texture::generateMipmap() noexcept
 	{
+		RENDERER_PROFILE_SCOPE("Texture::generateMipmap");
 		glGenerateTextureMipmap(m_id);
 	}
 
+	uint64_t Texture::handle() const noexcept
+	{
+		return glGetTextureHandleARB(m_id);
+	}
+
+	void Texture::makeResident(uint64_t handle) noexcept
+	{
+		glMakeTextureHandleResidentARB(handle);
+	}
+
+	void Texture::makeNonResident(uint64_t handle) noexcept
+	{
+		glMakeTextureHandleNonResidentARB(handle);
+	}
+
 	unsigned int Texture::id() const noexcept
 	{
 		return m_id;
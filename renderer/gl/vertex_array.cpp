@@ -1,13 +1,17 @@
 
 #include <renderer/gl/vertex_array.hpp>
 
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/gl/state_cache.hpp>
+
 #include <utility>
 
 namespace gfx::gl
 {
 	VertexArray::VertexArray() noexcept
 	{
-		glCreateVertexArrays(1, &m_id);
+		m_id = NamePool::current().createVertexArray();
 	}
 
 	VertexArray::VertexArray(VertexArray&& other) noexcept
@@ -24,17 +28,17 @@ namespace gfx::gl
 
 	VertexArray::~VertexArray() noexcept
 	{
-		glDeleteVertexArrays(1, &m_id);
+		DeletionQueue::instance().post(DeletionQueue::Type::eVertexArray, m_id);
 	}
 
 	void VertexArray::bind() const noexcept
 	{
-		glBindVertexArray(m_id);
+		StateCache::current().bindVertexArray(m_id);
 	}
 
 	void VertexArray::unbind() const noexcept
 	{
-		glBindVertexArray(0);
+		StateCache::current().bindVertexArray(0);
 	}
 
 	void VertexArray::bindVertexBuffer(const Buffer& buf, ptrdiff_t offset, ssize_t stride, unsigned int binding_index) noexcept
@@ -47,6 +51,11 @@ namespace gfx::gl
 		glVertexArrayElementBuffer(m_id, buf.id());
 	}
 
+	void VertexArray::bindingDivisor(unsigned int binding_index, unsigned int divisor) noexcept
+	{
+		glVertexArrayBindingDivisor(m_id, binding_index, divisor);
+	}
+
 	void VertexArray::enableAttribute(unsigned int attrib_index) noexcept
 	{
 		glEnableVertexArrayAttrib(m_id, attrib_index);
@@ -7,6 +7,12 @@
 #include <functional>
 
 #include <renderer/renderer.hpp>
+#include <renderer/core/upload_thread.hpp>
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/gpu_timer.hpp>
+#include <renderer/gl/name_pool.hpp>
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/utility/profiler.hpp>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -71,13 +77,23 @@ public:
 		ImGui_ImplGlfw_InitForOpenGL(m_window, true);
 		ImGui_ImplOpenGL3_Init("#version 460 core");
 
-		// Prepare renderer
+		// Prepare renderer, assets are created on the upload context and handed over between frames
+		m_uploads.reset(new gfx::core::UploadThread(m_window));
 		glfwGetFramebufferSize(m_window, &m_bufferWidth, &m_bufferHeight);
-		m_renderer.reset(new gfx::Renderer(m_bufferWidth, m_bufferHeight));
+		m_renderer.reset(new gfx::Renderer(m_bufferWidth, m_bufferHeight, *m_uploads));
+
+		gfx::util::Profiler::instance().registerThread("Render");
 	}
 
 	~Application()
 	{
+		// GL objects go while the context is still alive
+		m_renderer.reset();
+		m_uploads.reset();
+		gfx::gl::GpuTimer::instance().release();
+		gfx::gl::DeletionQueue::instance().flush();
+		gfx::gl::NamePool::current().release();
+
 		// Destroy ImGui
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
@@ -92,6 +108,8 @@ public:
 		while (!glfwWindowShouldClose(m_window))
 		{
 			glfwPollEvents();
+			m_uploads->poll();
+			gfx::gl::GpuTimer::instance().beginFrame();
 
 			// ImGui Frame Init
 			ImGui_ImplOpenGL3_NewFrame();
@@ -104,7 +122,10 @@ public:
 
 			// ImGui Rendering
 			ImGui::Render(); 
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			{
+				RENDERER_PROFILE_GPU_SCOPE("ImGui::Render");
+				ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			}
 
 			ImGuiIO& io = ImGui::GetIO();
 			io.DisplaySize = ImVec2((float)m_bufferWidth, (float)m_bufferHeight);
@@ -114,6 +135,15 @@ public:
 				ImGui::RenderPlatformWindowsDefault();
 			}
 
+			// ImGui binds through raw GL calls and other contexts
+			auto& state = gfx::gl::StateCache::current();
+			state.invalidate();
+			state.endFrame();
+
+			gfx::gl::GpuTimer::instance().endFrame();
+			gfx::gl::DeletionQueue::instance().endFrame();
+			gfx::util::Profiler::instance().endFrame();
+
 			// Swap out buffer
 			glfwSwapBuffers(m_window);
 		}
@@ -124,7 +154,8 @@ private:
 	// Update state
 	void update()
 	{
-		
+		RENDERER_PROFILE_SCOPE("Application::update");
+
 		// Don't update scene when ImGui is focused
 		if (ImGui::IsWindowFocused())
 			return;
@@ -221,13 +252,15 @@ private:
 	// Rendering 
 	void render()
 	{
+		RENDERER_PROFILE_SCOPE("Application::render");
 		m_renderer->render((float)m_bufferWidth, (float)m_bufferHeight);
 	}
 
 	// GUI Drawing
 	void draw()
 	{
-		
+		RENDERER_PROFILE_SCOPE("Application::draw");
+
 		ImGui::Begin("Renderer");
 		if (ImGui::CollapsingHeader("Camera Control"))
 		{
@@ -265,6 +298,83 @@ private:
 			ImGui::ColorEdit3("Light Color", (float*)&m_renderer->lightColor());
 			ImGui::InputFloat("Light Power", &m_renderer->lightPower());
 			ImGui::InputFloat("Model Alpha", &m_renderer->modelAlpha());
+			ImGui::InputInt("Object Count", &m_renderer->objectCount());
+			ImGui::InputFloat("Object Spacing", &m_renderer->objectSpacing());
+			ImGui::Checkbox("Instancing", &m_renderer->instancing());
+			ImGui::Checkbox("GPU Culling", &m_renderer->gpuCulling());
+			ImGui::Checkbox("Occlusion Culling", &m_renderer->occlusionCulling());
+		}
+
+		if (ImGui::CollapsingHeader("Statistics"))
+		{
+			const auto& state_stats = gfx::gl::StateCache::current().frameStats();
+			ImGui::Text("State calls: %zu", state_stats.calls);
+			ImGui::Text("Redundant state calls skipped: %zu", state_stats.skipped);
+
+			const auto& deletion_stats = gfx::gl::DeletionQueue::instance().stats();
+			ImGui::Text("GL names pending deletion: %zu", deletion_stats.pending);
+			ImGui::Text("Pending uploads: %zu", m_uploads->pendingCount());
+
+			const auto& command_stats = m_renderer->commandStats();
+			ImGui::Text("Draws: %zu (%zu translucent)", command_stats.draws, command_stats.translucent_draws);
+			ImGui::Text("Program changes: %zu", command_stats.program_changes);
+			ImGui::Text("Vertex array changes: %zu", command_stats.vertex_array_changes);
+
+			const auto& batch_stats = m_renderer->batchStats();
+			ImGui::Text("Indirect draws: %zu in %zu multi draws", batch_stats.draws, batch_stats.batches);
+
+			const auto& instance_stats = m_renderer->instanceStats();
+			ImGui::Text("Instances: %zu in %zu draws", instance_stats.instances, instance_stats.draws);
+
+			const auto& program_stats = m_renderer->programCacheStats();
+			ImGui::Text("Program binaries: %zu loaded, %zu compiled, %zu rejected", program_stats.hits, program_stats.misses, program_stats.rejected);
+
+			const auto& compiler_stats = m_renderer->compilerStats();
+			ImGui::Text("Programs compiling: %zu (%zu failed)", compiler_stats.pending, compiler_stats.failed);
+			ImGui::Text("Shader variants: %zu", m_renderer->shaderVariantCount());
+
+			ImGui::Text("Hot reload: %s", m_renderer->hotReloadEnabled() ? "watching" : "off");
+			const auto reload_error = m_renderer->hotReloadError();
+			if (!reload_error.empty())
+				ImGui::TextWrapped("Reload failed: %s", reload_error.c_str());
+
+			const auto& shader_error = m_renderer->shaderError();
+			if (!shader_error.empty())
+				ImGui::TextWrapped("Shader failed: %s", shader_error.c_str());
+		}
+
+		if (ImGui::CollapsingHeader("Profiler"))
+		{
+			auto& profiler = gfx::util::Profiler::instance();
+			bool enabled = profiler.enabled();
+			if (ImGui::Checkbox("Record Zones", &enabled))
+				profiler.setEnabled(enabled);
+
+			ImGui::SameLine();
+			if (ImGui::Button("Write Trace"))
+				profiler.writeChromeTrace("renderer_trace.json");
+
+			ImGui::SameLine();
+			if (ImGui::Button("Clear"))
+				profiler.clear();
+
+			ImGui::Text("Dropped events: %zu", profiler.droppedEvents());
+			ImGui::Separator();
+
+			const auto& frame = profiler.lastFrame();
+			ImGui::Text("CPU frame: %.3f ms", (double)(frame.end - frame.begin) / 1e6);
+			for (const auto& event : frame.events)
+			{
+				if (event.thread != gfx::util::Profiler::GPU_THREAD)
+					ImGui::Text("%s: %.3f ms", event.name, (double)(event.end - event.begin) / 1e6);
+			}
+			ImGui::Separator();
+
+			const auto& timer = gfx::gl::GpuTimer::instance();
+			const auto& gpu_frame = timer.lastFrame();
+			ImGui::Text("GPU frame: %.3f ms (%zu frames skipped)", (double)(gpu_frame.end - gpu_frame.begin) / 1e6, timer.skippedFrames());
+			for (const auto& zone : gpu_frame.zones)
+				ImGui::Text("%*s%s: %.3f ms", (int)zone.depth * 2, "", zone.name, (double)(zone.end - zone.begin) / 1e6);
 		}
 		ImGui::End();
 
@@ -288,6 +398,7 @@ private:
 	// Window State
 	int m_bufferWidth, m_bufferHeight;
 	GLFWwindow* m_window;
+	std::unique_ptr<gfx::core::UploadThread> m_uploads;
 	std::unique_ptr<gfx::Renderer> m_renderer;
 
 	// IO State
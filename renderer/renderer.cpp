@@ -1,9 +1,17 @@
 #include <renderer/renderer.hpp>
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-#include <glm/gtc/type_ptr.hpp>
+#include <glm/geometric.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
@@ -11,29 +19,169 @@
 #include <renderer/core/obj_loader.hpp>
 #include <renderer/core/tex_loader.hpp>
 #include <renderer/core/shader_loader.hpp>
+#include <renderer/gl/block_layout.hpp>
+#include <renderer/gl/gpu_timer.hpp>
+#include <renderer/gl/state_cache.hpp>
+#include <renderer/shaders/indirect_frag.hpp>
+#include <renderer/shaders/indirect_vert.hpp>
+#include <renderer/shaders/simple_frag.hpp>
+#include <renderer/shaders/simple_vert.hpp>
 
 using namespace gfx::core;
 using namespace gfx::gl;
 
 namespace gfx
 {
-	Renderer::Renderer(int initial_width, int initial_height) 
+	namespace
+	{
+		// Bindings shared by the scene shaders, the blocks come from shaders/include
+		constexpr unsigned int FRAME_BLOCK_BINDING = shaders::simple_vert::uniform_blocks::Frame.binding;
+		constexpr unsigned int MATERIAL_BLOCK_BINDING = shaders::simple_frag::uniform_blocks::Material.binding;
+		constexpr unsigned int OBJECT_BLOCK_BINDING = shaders::simple_vert::uniform_blocks::Object.binding;
+		constexpr unsigned int DRAW_STORAGE_BINDING = shaders::indirect_vert::storage_blocks::DrawData.binding;
+
+		// Bytes of geometry each pool may move per frame to undo the holes left by replaced models
+		constexpr size_t COMPACT_BYTES_PER_FRAME = 1024 * 1024;
+
+		// Matches the std140 block `Frame`, the view and lighting of the frame
+		struct FrameBlock
+		{
+			glm::mat4 view;
+			glm::mat4 projection;
+			glm::vec3 light_position;
+			float light_power;
+			glm::vec3 light_color;
+			float padding;
+		};
+
+		static_assert(blockMember<BlockLayout::eStd140, glm::mat4>(offsetof(FrameBlock, view)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::mat4>(offsetof(FrameBlock, projection)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec3>(offsetof(FrameBlock, light_position)));
+		static_assert(blockMember<BlockLayout::eStd140, float>(offsetof(FrameBlock, light_power)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec3>(offsetof(FrameBlock, light_color)));
+		static_assert(blockSize<BlockLayout::eStd140, FrameBlock, glm::mat4, glm::vec3, float>());
+
+		// Matches the std140 block `Material`, colors in rgb
+		struct MaterialBlock
+		{
+			glm::vec4 diffuse;
+			glm::vec4 ambient;
+			glm::vec4 specular;
+		};
+
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec4>(offsetof(MaterialBlock, diffuse)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec4>(offsetof(MaterialBlock, ambient)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec4>(offsetof(MaterialBlock, specular)));
+		static_assert(blockSize<BlockLayout::eStd140, MaterialBlock, glm::vec4>());
+
+		const MaterialBlock DEFAULT_MATERIAL = {
+			glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+			glm::vec4(0.1f, 0.0f, 0.0f, 0.0f),
+			glm::vec4(0.3f, 0.3f, 0.3f, 0.0f)
+		};
+
+		// Matches the std140 block `Object` of the simple shader, one per translucent draw
+		struct ObjectBlock
+		{
+			glm::mat4 mvp;
+			glm::mat4 model;
+			glm::vec4 params; // x: alpha
+		};
+
+		static_assert(blockMember<BlockLayout::eStd140, glm::mat4>(offsetof(ObjectBlock, mvp)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::mat4>(offsetof(ObjectBlock, model)));
+		static_assert(blockMember<BlockLayout::eStd140, glm::vec4>(offsetof(ObjectBlock, params)));
+		static_assert(blockSize<BlockLayout::eStd140, ObjectBlock, glm::mat4, glm::vec4>());
+
+		// Matches the std430 layout of `Draw` in shaders/indirect.vert
+		struct IndirectDraw
+		{
+			glm::mat4 model;
+			glm::vec4 params;
+		};
+
+		static_assert(blockMember<BlockLayout::eStd430, glm::mat4>(offsetof(IndirectDraw, model)));
+		static_assert(blockMember<BlockLayout::eStd430, glm::vec4>(offsetof(IndirectDraw, params)));
+		static_assert(blockSize<BlockLayout::eStd430, IndirectDraw, glm::mat4, glm::vec4>());
+
+		struct ObjectDraw
+		{
+			const RingBuffer* ring;
+			RingBuffer::Allocation block;
+		};
+
+		void applyObjectBlock(const ShaderProgram&, const void* data)
+		{
+			const auto& draw = *static_cast<const ObjectDraw*>(data);
+			draw.ring->bindRange(Buffer::Target::eUniform, OBJECT_BLOCK_BINDING, draw.block);
+		}
+
+		// Bounding sphere around the center of the model's box
+		glm::vec4 boundingSphere(const std::vector<Vertex>& vertices)
+		{
+			glm::vec3 bounds_min(std::numeric_limits<float>::max());
+			glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+			for (const auto& vertex : vertices)
+			{
+				bounds_min = glm::min(bounds_min, vertex.position);
+				bounds_max = glm::max(bounds_max, vertex.position);
+			}
+
+			const auto bounds_center = (bounds_min + bounds_max) * 0.5f;
+			float bounds_radius = 0.0f;
+			for (const auto& vertex : vertices)
+				bounds_radius = std::max(bounds_radius, glm::length(vertex.position - bounds_center));
+
+			return glm::vec4(bounds_center, bounds_radius);
+		}
+	}
+
+	// Geometry filled on the upload thread, copied into the pools on the render thread
+	struct Renderer::LoadedModel
+	{
+		Buffer vertices;
+		Buffer indices;
+		size_t vertex_count = 0;
+		size_t index_count = 0;
+		glm::vec4 bounds;
+	};
+
+	Renderer::Renderer(int initial_width, int initial_height, UploadThread& uploads) :
+		m_uploads(&uploads),
+		m_programs("shader_cache"),
+		m_compiler(&m_programs),
+		m_variants(m_compiler),
+		m_batch(sizeof(IndirectDraw)),
+		m_culling(100000),
+		m_instances(m_instancedVao, 1),
+		m_sceneFramebuffer(m_resources.create<Framebuffer>()),
+		m_vertexPool(16 * 1024 * 1024),
+		m_indexPool(16 * 1024 * 1024),
+		m_frameData(16 * 1024 * 1024)
 	{
 		// Setup viewport
-		setViewport(initial_height, initial_height);
+		setViewport(initial_width, initial_height);
 
-		// Setup shaders
+		// Setup shaders, linked from the binary cache when a previous run left a matching binary. The simple
+		// program is needed right away and draws everything until the specialized ones have compiled.
+		const auto source = [](Shader::Target target, std::string_view resource) {
+			return ProgramCache::Source{ target, sourceFromResource(std::string(resource)) };
+		};
 
-		Shader vertex = shaderFromResource(Shader::Target::eVertex, "shaders/simple.vert");
-		Shader fragment = shaderFromResource(Shader::Target::eFragment, "shaders/simple.frag");
+		const auto simple_vertex = source(Shader::Target::eVertex, shaders::simple_vert::RESOURCE);
+		const auto simple_fragment = source(Shader::Target::eFragment, shaders::simple_frag::RESOURCE);
+		const auto indirect_vertex = source(Shader::Target::eVertex, shaders::indirect_vert::RESOURCE);
+		const auto indirect_fragment = source(Shader::Target::eFragment, shaders::indirect_frag::RESOURCE);
 
-		m_shader.attachShader(vertex);
-		m_shader.attachShader(fragment);
-		m_shader.link();
-		m_shader.detachShader(vertex);
-		m_shader.detachShader(fragment);
+		m_shader = m_programs.link({ simple_vertex, simple_fragment });
 		m_shader.bind();
 
+		// Scene variants are selected by feature flags, the manifest lists the ones to compile up front
+		m_sceneProgram = m_variants.add("scene", { indirect_vertex, indirect_fragment }, ShaderFeatures::eInstancing);
+
+		std::istringstream manifest(sourceFromResource("shaders/variants.manifest"));
+		m_variants.prewarm(manifest);
+
 		// Setup Camera
 		m_camera.setPosition(glm::vec3(0.0f, 0.0f, -5.0f));
 		m_camera.lookAt(glm::vec3(0.0f, 0.0f, 0.0f));
@@ -42,72 +190,313 @@ namespace gfx
 		m_camera.setFov(glm::radians(60.0f));
 
 		// Context setup
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_LESS);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		//glEnable(GL_CULL_FACE);
 		glClearColor(0.15f, 0.15f, 0.15f, 1.0f);
 
 
-		// Geometry setup
-		std::vector<Vertex> vertices;
-		std::vector<unsigned int> indices;
+		// Geometry setup, the model is parsed and uploaded off the render thread and drawn once it has arrived
+		m_vao.enableAttributes<Vertex>({ Attribute::ePosition , Attribute::eTexCoords, Attribute::eNormal});
 
-		gfx::core::objFromResource("models/cow.obj", vertices, indices);
+		// Same geometry with per instance attributes on binding 1
+		m_instancedVao.enableAttributes<Vertex>({ Attribute::ePosition , Attribute::eTexCoords, Attribute::eNormal});
+		Instance::enableAttributes(m_instancedVao, 1);
 
-		Buffer vbo;
-		m_vao.bindVertexBuffer(vbo, 0, sizeof(Vertex));
-		vbo.bufferData(vertices, Buffer::Usage::eStreamDraw);
+		uploads.upload(
+			[]() {
+				std::vector<Vertex> vertices;
+				std::vector<unsigned int> indices;
+				gfx::core::objFromResource("models/cow.obj", vertices, indices);
+				return createModel(vertices, indices);
+			},
+			[this](LoadedModel&& model) { setModel(model); }
+		);
 
-		Buffer ibo;
-		m_vao.bindElementBuffer(ibo);
-		ibo.bufferData(indices, Buffer::Usage::eStreamDraw);
-		m_vaoElements = indices.size();
+#ifdef RENDERER_HOT_RELOAD
+		// Edits to the loose files of the source tree replace the embedded versions
+		m_hotReload = std::make_unique<HotReload>(RENDERER_RESOURCE_DIR, uploads);
+		m_hotReload->onShaders([this](const HotReload::ShaderSources& sources) { reloadShaders(sources); });
+		m_hotReload->onFile("models/cow.obj", [this](const std::filesystem::path& path) { reloadModel(path); });
+#endif
+	}
 
-		m_vao.enableAttributes<Vertex>({ Attribute::ePosition , Attribute::eTexCoords, Attribute::eNormal});
+	Renderer::LoadedModel Renderer::createModel(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		LoadedModel model;
+		model.vertices.bufferStorage(vertices, (Buffer::StorageFlags)0);
+		model.indices.bufferStorage(indices, (Buffer::StorageFlags)0);
+		model.vertex_count = vertices.size();
+		model.index_count = indices.size();
+		model.bounds = boundingSphere(vertices);
+		return model;
+	}
+
+	void Renderer::setModel(const LoadedModel& model)
+	{
+		// A reloaded model replaces the ranges of the previous one, copies into them are ordered after its draws
+		if (m_vertices != BufferPool::INVALID_HANDLE)
+			m_vertexPool.free(m_vertices);
+		if (m_indices != BufferPool::INVALID_HANDLE)
+			m_indexPool.free(m_indices);
+
+		// Vertex ranges are aligned to the vertex size so their offset is a base vertex
+		m_vertices = m_vertexPool.allocate(sizeof(Vertex) * model.vertex_count, sizeof(Vertex));
+		m_vertexPool.copy(m_vertices, 0, model.vertices, 0, sizeof(Vertex) * model.vertex_count);
+
+		m_indices = m_indexPool.allocate(sizeof(unsigned int) * model.index_count, sizeof(unsigned int));
+		m_indexPool.copy(m_indices, 0, model.indices, 0, sizeof(unsigned int) * model.index_count);
+		m_vaoElements = model.index_count;
+		m_modelBounds = model.bounds;
+
+		bindGeometry();
+	}
+
+	void Renderer::bindGeometry() noexcept
+	{
+		m_vao.bindVertexBuffer(m_vertexPool.buffer(m_vertices), 0, sizeof(Vertex));
+		m_vao.bindElementBuffer(m_indexPool.buffer(m_indices));
+
+		m_instancedVao.bindVertexBuffer(m_vertexPool.buffer(m_vertices), 0, sizeof(Vertex));
+		m_instancedVao.bindElementBuffer(m_indexPool.buffer(m_indices));
+
+		// Objects uploaded for culling refer to the old geometry
+		m_culledObjectCount = 0;
+	}
+
+	void Renderer::compactGeometry()
+	{
+		// Moved ranges may change page and offset, draws of this frame query them afterwards
+		const auto moved = m_vertexPool.compact(COMPACT_BYTES_PER_FRAME) + m_indexPool.compact(COMPACT_BYTES_PER_FRAME);
+		if (moved > 0)
+			bindGeometry();
+	}
+
+	void Renderer::reloadModel(const std::filesystem::path& path)
+	{
+		// Imported on the upload thread, a model that fails to load keeps the previous one
+		m_uploads->upload(
+			[path]() {
+				std::pair<std::optional<LoadedModel>, std::string> result;
+				try
+				{
+					std::vector<Vertex> vertices;
+					std::vector<unsigned int> indices;
+					gfx::core::objFromFile(path.string(), vertices, indices);
+					if (vertices.empty() || indices.empty())
+						throw std::runtime_error("model has no geometry");
+
+					result.first = createModel(vertices, indices);
+				}
+				catch (const std::exception& e)
+				{
+					result.second = path.string() + ": " + e.what();
+				}
+				return result;
+			},
+			[this, path](std::pair<std::optional<LoadedModel>, std::string>&& result) {
+				if (result.first)
+					setModel(*result.first);
+				m_hotReload->report(path.string(), std::move(result.second));
+			}
+		);
+	}
+
+	void Renderer::reloadShaders(const HotReload::ShaderSources& sources)
+	{
+		// Only the scene variants are reloaded, the simple and culling programs keep their startup version
+		const auto vertex = sources.find(std::string(shaders::indirect_vert::RESOURCE));
+		const auto fragment = sources.find(std::string(shaders::indirect_frag::RESOURCE));
+		if (vertex == sources.end() || fragment == sources.end())
+		{
+			m_hotReload->report(HotReload::SHADER_SOURCE, "scene shaders are missing from the shader directory");
+			return;
+		}
+
+		m_variants.reload(m_sceneProgram, {
+			{ Shader::Target::eVertex, vertex->second },
+			{ Shader::Target::eFragment, fragment->second }
+		});
 	}
 
 	void Renderer::setViewport(int width, int height) noexcept
 	{
 		glViewport(0, 0, width, height);
 		m_camera.setAspect((float)width / (float)height);
+
+		if (width <= 0 || height <= 0 || (width == m_viewportWidth && height == m_viewportHeight))
+			return;
+
+		m_viewportWidth = width;
+		m_viewportHeight = height;
+
+		// Handles to the previous textures go stale
+		m_resources.destroy(m_sceneColor);
+		m_resources.destroy(m_sceneDepth);
+		m_sceneColor = m_resources.create<Texture>(Texture::Target::eTexture2D);
+		m_sceneDepth = m_resources.create<Texture>(Texture::Target::eTexture2D);
+
+		auto& color = *m_resources.get(m_sceneColor);
+		color.storage2D(1, DataFormat::eRGBA8, width, height);
+
+		auto& depth = *m_resources.get(m_sceneDepth);
+		depth.storage2D(1, DataFormat::eDepthComponent32F, width, height);
+		depth.parameter(Texture::Parameter::eMinFilter, (int)MinificationFunction::eNearest);
+		depth.parameter(Texture::Parameter::eMagFilter, (int)MagnificationFunction::eNearest);
+
+		auto& framebuffer = *m_resources.get(m_sceneFramebuffer);
+		framebuffer.attach(color, Framebuffer::Attachment::eColor0, 0);
+		framebuffer.attach(depth, Framebuffer::Attachment::eDepth, 0);
 	}
 
 	void Renderer::render(float view_width, float view_height)
 	{
+		RENDERER_PROFILE_GPU_SCOPE("Renderer::render");
 
-		m_shader.bind();
+		if (m_hotReload)
+			m_hotReload->update();
+
+		// Pipeline state, only the changes reach the driver
+		auto& state = StateCache::current();
+		state.setEnabled(GL_DEPTH_TEST, true);
+		state.depthFunc(GL_LESS);
+		state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		//state.setEnabled(GL_CULL_FACE, true);
+
+		m_resources.get(m_sceneFramebuffer)->bind();
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		const auto matrix_id = m_shader.getUniform("MVP");
-		const auto view_matrix_id = m_shader.getUniform("V");
-		const auto model_matrix_id = m_shader.getUniform("M");
-		const auto light_position_id = m_shader.getUniform("LightPosition_worldspace");
-		const auto light_color_id = m_shader.getUniform("LightColor");
-		const auto light_power_id = m_shader.getUniform("LightPower");
-		const auto alpha_id = m_shader.getUniform("Alpha");
-	
+		// The model is still on its way from the upload thread
+		if (m_vaoElements == 0)
+		{
+			present();
+			return;
+		}
+
+		compactGeometry();
+		m_frameData.beginFrame();
+		m_compiler.poll();
+		for (auto& error : m_variants.update())
+		{
+			if (m_hotReload)
+				m_hotReload->report(HotReload::SHADER_SOURCE, std::move(error));
+			else
+				m_shaderError = std::move(error);
+		}
+
 		glm::mat4 view_matrix = m_camera.viewMatrix();
 		glm::mat4 perspective_matrix = m_camera.projectionMatrix();
-		glm::mat4 translation = glm::mat4(1.0f);
-		glm::mat4 rotation = glm::mat4(1.0f);
-		glm::mat4 scale = glm::mat4(1.0f);
-		glm::mat4 model_matrix = translation * scale * rotation;   
-		glm::mat4 MVP = perspective_matrix * view_matrix * model_matrix;
 
-		glUniformMatrix4fv(matrix_id, 1, GL_FALSE, glm::value_ptr(MVP));
-		glUniformMatrix4fv(view_matrix_id, 1, GL_FALSE, glm::value_ptr(view_matrix));	
-		glUniformMatrix4fv(model_matrix_id, 1, GL_FALSE, glm::value_ptr(model_matrix));
+		// Per frame blocks, shared by every scene shader
+		const FrameBlock frame{ view_matrix, perspective_matrix, m_lightPosition, m_lightPower, m_lightColor, 0.0f };
+		m_frameData.bindRange(Buffer::Target::eUniform, FRAME_BLOCK_BINDING, m_frameData.pushUniform(frame));
+		m_frameData.bindRange(Buffer::Target::eUniform, MATERIAL_BLOCK_BINDING, m_frameData.pushUniform(DEFAULT_MATERIAL));
+
+		// Objects on a grid centered on the origin. Opaque ones are culled on the GPU, instanced or go through a
+		// multi draw per program and vertex array, translucent ones are recorded with their sort key and drawn
+		// back to front. Opaque objects whose program is still compiling are drawn like translucent ones with
+		// the simple program, front to back.
+		const auto* indirect_program = m_variants.program(m_sceneProgram, ShaderFeatures::eNone);
+		const auto* instanced_program = m_variants.program(m_sceneProgram, ShaderFeatures::eInstancing);
 
-		glUniform3f(light_position_id, m_lightPosition.x, m_lightPosition.y, m_lightPosition.z);
-		glUniform3f(light_color_id, m_lightColor.x, m_lightColor.y, m_lightColor.z);
-		glUniform1f(light_power_id, m_lightPower);
-		glUniform1f(alpha_id, m_modelAlpha);
+		const auto object_count = std::clamp(m_objectCount, 1, (int)m_culling.maxObjects());
+		const auto grid_size = (int)std::ceil(std::sqrt((float)object_count));
+		const auto grid_offset = (float)(grid_size - 1) * 0.5f;
+		const auto translucent = m_modelAlpha < 1.0f;
+		const auto gpu_culling = m_gpuCulling && !translucent && indirect_program;
+		const auto instancing = m_instancing && !translucent && !gpu_culling && instanced_program;
 
-		m_vao.bind();
-		glDrawElements(GL_TRIANGLES, m_vaoElements, GL_UNSIGNED_INT, 0);
+		const auto first_index = (uint32_t)(m_indexPool.offset(m_indices) / sizeof(unsigned int));
+		const auto base_vertex = (int)(m_vertexPool.offset(m_vertices) / sizeof(Vertex));
 
+		const auto object_position = [&](int i) {
+			return glm::vec3((float)(i % grid_size) - grid_offset, 0.0f, (float)(i / grid_size) - grid_offset) * m_objectSpacing;
+		};
+
+		if (gpu_culling)
+		{
+			// Objects are static, so they only reach the GPU when the layout changes
+			if (object_count != m_culledObjectCount || m_objectSpacing != m_culledObjectSpacing)
+			{
+				std::vector<GpuCulling::Object> objects;
+				objects.reserve(object_count);
+				for (int i = 0; i < object_count; i++)
+					objects.push_back({ glm::translate(glm::mat4(1.0f), object_position(i)), m_modelBounds, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f), m_vaoElements, first_index, base_vertex });
+
+				m_culling.setObjects(objects);
+				m_culledObjectCount = object_count;
+				m_culledObjectSpacing = m_objectSpacing;
+			}
+
+			m_culling.setOcclusionCulling(m_occlusionCulling);
+			m_culling.cull(perspective_matrix * view_matrix);
+		}
+
+		for (int i = 0; i < object_count && !gpu_culling; i++)
+		{
+			const auto model_position = object_position(i);
+			glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), model_position);
+
+			if (instancing)
+			{
+				m_instanceData.push_back({ model_matrix, glm::vec4(m_modelAlpha, 0.0f, 0.0f, 0.0f) });
+				continue;
+			}
+
+			if (!translucent && indirect_program)
+			{
+				m_batch.add(*indirect_program, m_vao, m_vaoElements, first_index, base_vertex, IndirectDraw{ model_matrix, glm::vec4(m_modelAlpha, 0.0f, 0.0f, 0.0f) });
+				continue;
+			}
+
+			const auto depth = (glm::length(model_position - m_camera.position()) - m_camera.near()) / (m_camera.far() - m_camera.near());
+			const auto key = translucent ?
+				SortKey::translucent(0, 0, m_shader.id(), 0, m_vao.id(), depth) :
+				SortKey::opaque(0, 0, m_shader.id(), 0, m_vao.id(), depth);
+
+			auto& draw = m_commands.add(key);
+			draw.program = &m_shader;
+			draw.vertex_array = &m_vao;
+			draw.count = m_vaoElements;
+			draw.index_offset = m_indexPool.offset(m_indices);
+			draw.base_vertex = base_vertex;
+			draw.apply = applyObjectBlock;
+
+			const ObjectBlock object{ perspective_matrix * view_matrix * model_matrix, model_matrix, glm::vec4(m_modelAlpha, 0.0f, 0.0f, 0.0f) };
+			draw.data = m_commands.pushData(ObjectDraw{ &m_frameData, m_frameData.pushUniform(object) });
+		}
+
+		state.setEnabled(GL_BLEND, false);
+		state.depthMask(true);
+		if (gpu_culling)
+			m_culling.draw(*indirect_program, m_vao, DRAW_STORAGE_BINDING);
+
+		if (instancing)
+		{
+			m_instances.add(m_vaoElements, first_index, base_vertex, m_instanceData);
+			m_instances.submit(m_frameData, *instanced_program);
+		}
+		m_instances.clear();
+		m_instanceData.clear();
+
+		m_batch.submit(m_frameData, DRAW_STORAGE_BINDING);
+		m_batch.clear();
+
+		m_commands.submit();
+		m_commands.clear();
+
+		// No depth texture exists before the viewport had a size
+		const auto* scene_depth = m_resources.get(m_sceneDepth);
+		if (gpu_culling && scene_depth)
+			m_culling.buildDepthPyramid(*scene_depth, m_viewportWidth, m_viewportHeight);
+
+		m_frameData.endFrame();
+
+		present();
+	}
+
+	void Renderer::present() noexcept
+	{
+		const auto& framebuffer = *m_resources.get(m_sceneFramebuffer);
+		framebuffer.blit(nullptr, 0, 0, m_viewportWidth, m_viewportHeight, 0, 0, m_viewportWidth, m_viewportHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		framebuffer.unbind();
 	}
 
 	PerspectiveCamera& Renderer::camera() noexcept
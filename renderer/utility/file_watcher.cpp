@@ -0,0 +1,132 @@
+#include <renderer/utility/file_watcher.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace gfx::util
+{
+#ifdef __linux__
+	FileWatcher::FileWatcher()
+	{
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		m_stop = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (m_inotify < 0 || m_stop < 0)
+			return;
+
+		m_thread = std::thread(&FileWatcher::watchLoop, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		if (m_thread.joinable())
+		{
+			const uint64_t value = 1;
+			[[maybe_unused]] const auto written = write(m_stop, &value, sizeof(value));
+			m_thread.join();
+		}
+
+		if (m_inotify >= 0)
+			close(m_inotify);
+		if (m_stop >= 0)
+			close(m_stop);
+	}
+
+	bool FileWatcher::watch(const std::filesystem::path& directory)
+	{
+		if (!supported())
+			return false;
+
+		const auto descriptor = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (descriptor < 0)
+			return false;
+
+		std::lock_guard lock(m_mutex);
+		m_directories[descriptor] = directory;
+		return true;
+	}
+
+	void FileWatcher::watchLoop()
+	{
+		// Large enough for many events with names up to NAME_MAX
+		alignas(inotify_event) char buffer[16 * 1024];
+
+		pollfd descriptors[2] = { { m_inotify, POLLIN, 0 }, { m_stop, POLLIN, 0 } };
+		while (true)
+		{
+			if (poll(descriptors, 2, -1) < 0)
+				continue;
+
+			if (descriptors[1].revents & POLLIN)
+				return;
+
+			if (!(descriptors[0].revents & POLLIN))
+				continue;
+
+			const auto length = read(m_inotify, buffer, sizeof(buffer));
+			if (length <= 0)
+				continue;
+
+			std::lock_guard lock(m_mutex);
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += (ssize_t)(sizeof(inotify_event) + event->len);
+
+				if (event->len == 0 || (event->mask & IN_ISDIR))
+					continue;
+
+				const auto directory = m_directories.find(event->wd);
+				if (directory == m_directories.end())
+					continue;
+
+				auto path = directory->second / event->name;
+				if (std::find(m_changes.begin(), m_changes.end(), path) == m_changes.end())
+					m_changes.push_back(std::move(path));
+			}
+		}
+	}
+
+	bool FileWatcher::supported() const noexcept
+	{
+		return m_thread.joinable();
+	}
+#else
+	FileWatcher::FileWatcher()
+	{
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+	}
+
+	bool FileWatcher::watch(const std::filesystem::path&)
+	{
+		return false;
+	}
+
+	void FileWatcher::watchLoop()
+	{
+	}
+
+	bool FileWatcher::supported() const noexcept
+	{
+		return false;
+	}
+#endif
+
+	std::vector<std::filesystem::path> FileWatcher::changes()
+	{
+		std::vector<std::filesystem::path> changes;
+		std::lock_guard lock(m_mutex);
+		std::swap(changes, m_changes);
+		return changes;
+	}
+}
\ No newline at end of file
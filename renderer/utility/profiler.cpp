@@ -0,0 +1,199 @@
+#include <renderer/utility/profiler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace gfx::util
+{
+	namespace
+	{
+		// Thread 0 is the track of the frames
+		constexpr uint32_t FRAME_THREAD = 0;
+
+		void writeString(std::ostream& os, std::string_view value)
+		{
+			os << '"';
+			for (const auto c : value)
+			{
+				if (c == '"' || c == '\\')
+					os << '\\' << c;
+				else if ((unsigned char)c < 0x20)
+					os << ' ';
+				else
+					os << c;
+			}
+			os << '"';
+		}
+
+		// Chrome traces are in microseconds
+		void writeMicroseconds(std::ostream& os, uint64_t nanoseconds)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%llu.%03llu", (unsigned long long)(nanoseconds / 1000), (unsigned long long)(nanoseconds % 1000));
+			os << buffer;
+		}
+
+		void writeZone(std::ostream& os, std::string_view name, uint32_t thread, uint64_t begin, uint64_t end, uint64_t origin)
+		{
+			os << ",\n{\"name\":";
+			writeString(os, name);
+			os << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread << ",\"ts\":";
+			writeMicroseconds(os, begin - origin);
+			os << ",\"dur\":";
+			writeMicroseconds(os, end - begin);
+			os << '}';
+		}
+	}
+
+	Profiler& Profiler::instance() noexcept
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	void Profiler::registerThread(std::string name)
+	{
+		// Rings belong to the profiler and outlive their thread, which may exit with events still queued
+		auto& slot = threadSlot();
+
+		std::lock_guard lock(m_mutex);
+		if (slot.owner != this)
+		{
+			slot.ring = m_rings.emplace_back(std::make_unique<ThreadRing>((uint32_t)m_rings.size() + 1)).get();
+			slot.owner = this;
+		}
+		slot.ring->name = std::move(name);
+	}
+
+	void Profiler::record(const char* name, uint64_t begin, uint64_t end) noexcept
+	{
+		const auto& slot = threadSlot();
+		if (slot.owner != this)
+		{
+			m_unregistered.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		if (!slot.ring->events.tryPush({ name, begin, end, slot.ring->id }))
+			slot.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void Profiler::recordGpu(const char* name, uint64_t begin, uint64_t end)
+	{
+		m_gpuEvents.push_back({ name, begin, end, GPU_THREAD });
+	}
+
+	void Profiler::endFrame()
+	{
+		Frame frame;
+		frame.end = now();
+		frame.begin = m_frameBegin;
+		m_frameBegin = frame.end;
+
+		{
+			std::lock_guard lock(m_mutex);
+			for (auto& ring : m_rings)
+			{
+				while (auto* event = ring->events.front())
+				{
+					frame.events.push_back(*event);
+					ring->events.pop();
+				}
+
+				m_dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+			}
+		}
+		m_dropped += m_unregistered.exchange(0, std::memory_order_relaxed);
+
+		frame.events.insert(frame.events.end(), m_gpuEvents.begin(), m_gpuEvents.end());
+		m_gpuEvents.clear();
+
+		// Frames without events while disabled would only push recorded ones out of the history
+		if (frame.events.empty() && !enabled())
+			return;
+
+		// The first frame begins with its first event
+		if (frame.begin == 0)
+		{
+			frame.begin = frame.end;
+			for (const auto& event : frame.events)
+				frame.begin = std::min(frame.begin, event.begin);
+		}
+
+		std::sort(frame.events.begin(), frame.events.end(), [](const Event& lhs, const Event& rhs) { return lhs.begin < rhs.begin; });
+
+		m_lastFrame = frame;
+		m_frames.push_back(std::move(frame));
+		if (m_frames.size() > MAX_FRAMES)
+			m_frames.pop_front();
+	}
+
+	void Profiler::clear()
+	{
+		m_gpuEvents.clear();
+		m_frames.clear();
+		m_lastFrame = {};
+		m_dropped = 0;
+	}
+
+	void Profiler::writeChromeTrace(std::ostream& os) const
+	{
+		// Zones on other threads can begin before the frame they end in
+		uint64_t origin = m_frames.empty() ? 0 : m_frames.front().begin;
+		for (const auto& frame : m_frames)
+		{
+			for (const auto& event : frame.events)
+				origin = std::min(origin, event.begin);
+		}
+
+		os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << FRAME_THREAD << ",\"args\":{\"name\":\"Frames\"}}";
+		os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << GPU_THREAD << ",\"args\":{\"name\":\"GPU\"}}";
+		{
+			std::lock_guard lock(m_mutex);
+			for (const auto& ring : m_rings)
+			{
+				os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << ring->id << ",\"args\":{\"name\":";
+				writeString(os, ring->name.empty() ? "Thread " + std::to_string(ring->id) : ring->name);
+				os << "}}";
+			}
+		}
+
+		for (const auto& frame : m_frames)
+		{
+			writeZone(os, "Frame", FRAME_THREAD, frame.begin, frame.end, origin);
+			for (const auto& event : frame.events)
+				writeZone(os, event.name, event.thread, event.begin, event.end, origin);
+		}
+
+		os << "\n]}\n";
+	}
+
+	bool Profiler::writeChromeTrace(const std::filesystem::path& path) const
+	{
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		if (!os)
+			return false;
+
+		writeChromeTrace(os);
+		return (bool)os;
+	}
+
+	const Profiler::Frame& Profiler::lastFrame() const noexcept
+	{
+		return m_lastFrame;
+	}
+
+	size_t Profiler::droppedEvents() const noexcept
+	{
+		return m_dropped;
+	}
+
+	Profiler::ThreadSlot& Profiler::threadSlot() noexcept
+	{
+		thread_local ThreadSlot slot;
+		return slot;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <renderer/utility/thread_pool.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include <renderer/utility/profiler.hpp>
+
+namespace gfx::util
+{
+	ThreadPool::ThreadPool(size_t thread_count)
+	{
+		thread_count = std::max<size_t>(thread_count, 1);
+		m_workers.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; ++i)
+			m_workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskAvailable.notify_all();
+
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	void ThreadPool::post(std::function<void()> task)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_tasks.push_back(std::move(task));
+		}
+		m_taskAvailable.notify_one();
+	}
+
+	void ThreadPool::waitIdle()
+	{
+		std::unique_lock lock(m_mutex);
+		m_idle.wait(lock, [this]() { return m_tasks.empty() && m_active == 0; });
+	}
+
+	size_t ThreadPool::threadCount() const noexcept
+	{
+		return m_workers.size();
+	}
+
+	size_t ThreadPool::pendingCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_tasks.size();
+	}
+
+	void ThreadPool::workerLoop()
+	{
+		Profiler::instance().registerThread("Thread pool");
+
+		for (;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock lock(m_mutex);
+				m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+				// Drain the queue before shutting down so futures are always satisfied
+				if (m_tasks.empty())
+					return;
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop_front();
+				++m_active;
+			}
+
+			{
+				RENDERER_PROFILE_SCOPE("ThreadPool::task");
+				task();
+			}
+
+			{
+				std::lock_guard lock(m_mutex);
+				--m_active;
+				if (m_tasks.empty() && m_active == 0)
+					m_idle.notify_all();
+			}
+		}
+	}
+}
\ No newline at end of file
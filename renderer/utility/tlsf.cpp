@@ -0,0 +1,322 @@
+#include <renderer/utility/tlsf.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace gfx::util
+{
+	namespace
+	{
+		// The first level covers [0, 256) in 16 byte steps, level n covers [2^(n+7), 2^(n+8))
+		constexpr uint32_t SMALL_SHIFT = 8;
+		constexpr size_t SMALL_SIZE = (size_t)1 << SMALL_SHIFT;
+		constexpr size_t SMALL_STEP = SMALL_SIZE / 16;
+
+		// Remainders below this stay part of the allocation instead of becoming a free block
+		constexpr size_t MIN_SPLIT = 16;
+
+		void mapping(size_t size, uint32_t& fl, uint32_t& sl) noexcept
+		{
+			if (size < SMALL_SIZE)
+			{
+				fl = 0;
+				sl = (uint32_t)(size / SMALL_STEP);
+			}
+			else
+			{
+				const auto f = (uint32_t)std::bit_width(size) - 1;
+				fl = f - (SMALL_SHIFT - 1);
+				sl = (uint32_t)(size >> (f - 4)) & 15u;
+			}
+		}
+
+		// Rounds up to the next subclass, so every block in the class of the result fits
+		size_t roundSearch(size_t size) noexcept
+		{
+			if (size < SMALL_SIZE)
+				return (size + SMALL_STEP - 1) / SMALL_STEP * SMALL_STEP;
+
+			return size + ((size_t)1 << (std::bit_width(size) - 1 - 4)) - 1;
+		}
+
+		void mappingSearch(size_t size, uint32_t& fl, uint32_t& sl) noexcept
+		{
+			mapping(roundSearch(size), fl, sl);
+		}
+	}
+
+	TlsfAllocator::TlsfAllocator(size_t capacity) :
+		m_capacity(capacity)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("allocator capacity must be positive");
+
+		for (auto& heads : m_heads)
+			heads.fill(INVALID_BLOCK);
+
+		m_last = createBlock();
+		m_blocks[m_last].size = capacity;
+		insertFree(m_last);
+	}
+
+	size_t TlsfAllocator::requiredCapacity(size_t size, size_t alignment) noexcept
+	{
+		// Same padding as allocate()
+		return roundSearch(std::max<size_t>(size, 1) + std::max<size_t>(alignment, 1) - 1);
+	}
+
+	uint32_t TlsfAllocator::allocate(size_t size, size_t alignment, uint32_t user_data) noexcept
+	{
+		size = std::max<size_t>(size, 1);
+		alignment = std::max<size_t>(alignment, 1);
+
+		// Room for the worst case padding in front of an aligned offset
+		auto block = findFree(size + alignment - 1);
+		if (block == INVALID_BLOCK)
+			return INVALID_BLOCK;
+
+		removeFree(block);
+
+		const auto offset = m_blocks[block].offset;
+		const auto aligned = (offset + alignment - 1) / alignment * alignment;
+		if (aligned != offset)
+		{
+			// The block in front stays free, it cannot have a free physical neighbour
+			const auto front = splitFront(block, aligned - offset);
+			insertFree(front);
+		}
+
+		if (m_blocks[block].size - size >= MIN_SPLIT)
+		{
+			const auto back = createBlock();
+			auto& current = m_blocks[block];
+			auto& remainder = m_blocks[back];
+
+			remainder.offset = current.offset + size;
+			remainder.size = current.size - size;
+			remainder.prev_physical = block;
+			remainder.next_physical = current.next_physical;
+			current.size = size;
+			current.next_physical = back;
+
+			if (remainder.next_physical != INVALID_BLOCK)
+				m_blocks[remainder.next_physical].prev_physical = back;
+			else
+				m_last = back;
+
+			insertFree(back);
+		}
+
+		auto& allocated = m_blocks[block];
+		allocated.free = false;
+		allocated.user_data = user_data;
+		m_used += allocated.size;
+		++m_allocations;
+		return block;
+	}
+
+	void TlsfAllocator::free(uint32_t block) noexcept
+	{
+		m_used -= m_blocks[block].size;
+		--m_allocations;
+
+		// Coalesce with both physical neighbours
+		const auto previous = m_blocks[block].prev_physical;
+		if (previous != INVALID_BLOCK && m_blocks[previous].free)
+		{
+			removeFree(previous);
+			m_blocks[previous].size += m_blocks[block].size;
+			m_blocks[previous].next_physical = m_blocks[block].next_physical;
+			if (m_blocks[block].next_physical != INVALID_BLOCK)
+				m_blocks[m_blocks[block].next_physical].prev_physical = previous;
+			else
+				m_last = previous;
+
+			destroyBlock(block);
+			block = previous;
+		}
+
+		const auto next = m_blocks[block].next_physical;
+		if (next != INVALID_BLOCK && m_blocks[next].free)
+		{
+			removeFree(next);
+			m_blocks[block].size += m_blocks[next].size;
+			m_blocks[block].next_physical = m_blocks[next].next_physical;
+			if (m_blocks[next].next_physical != INVALID_BLOCK)
+				m_blocks[m_blocks[next].next_physical].prev_physical = block;
+			else
+				m_last = block;
+
+			destroyBlock(next);
+		}
+
+		insertFree(block);
+	}
+
+	size_t TlsfAllocator::offset(uint32_t block) const noexcept
+	{
+		return m_blocks[block].offset;
+	}
+
+	size_t TlsfAllocator::size(uint32_t block) const noexcept
+	{
+		return m_blocks[block].size;
+	}
+
+	uint32_t TlsfAllocator::userData(uint32_t block) const noexcept
+	{
+		return m_blocks[block].user_data;
+	}
+
+	bool TlsfAllocator::isFree(uint32_t block) const noexcept
+	{
+		return m_blocks[block].free;
+	}
+
+	uint32_t TlsfAllocator::lastBlock() const noexcept
+	{
+		return m_last;
+	}
+
+	uint32_t TlsfAllocator::previousBlock(uint32_t block) const noexcept
+	{
+		return m_blocks[block].prev_physical;
+	}
+
+	size_t TlsfAllocator::capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	size_t TlsfAllocator::used() const noexcept
+	{
+		return m_used;
+	}
+
+	TlsfAllocator::Stats TlsfAllocator::stats() const noexcept
+	{
+		Stats stats;
+		stats.capacity = m_capacity;
+		stats.used = m_used;
+		stats.allocations = m_allocations;
+
+		for (uint32_t fl = 0; fl < FL_COUNT; ++fl)
+		{
+			for (uint32_t sl = 0; sl < SL_COUNT; ++sl)
+			{
+				for (auto block = m_heads[fl][sl]; block != INVALID_BLOCK; block = m_blocks[block].next_free)
+				{
+					stats.largest_free = std::max(stats.largest_free, m_blocks[block].size);
+					++stats.free_blocks;
+				}
+			}
+		}
+
+		return stats;
+	}
+
+	uint32_t TlsfAllocator::createBlock() noexcept
+	{
+		if (!m_unusedBlocks.empty())
+		{
+			const auto block = m_unusedBlocks.back();
+			m_unusedBlocks.pop_back();
+			m_blocks[block] = Block{};
+			return block;
+		}
+
+		m_blocks.emplace_back();
+		return (uint32_t)(m_blocks.size() - 1);
+	}
+
+	void TlsfAllocator::destroyBlock(uint32_t block) noexcept
+	{
+		m_unusedBlocks.push_back(block);
+	}
+
+	void TlsfAllocator::insertFree(uint32_t block) noexcept
+	{
+		uint32_t fl, sl;
+		mapping(m_blocks[block].size, fl, sl);
+
+		auto& head = m_heads[fl][sl];
+		m_blocks[block].free = true;
+		m_blocks[block].prev_free = INVALID_BLOCK;
+		m_blocks[block].next_free = head;
+		if (head != INVALID_BLOCK)
+			m_blocks[head].prev_free = block;
+		head = block;
+
+		m_flBitmap |= 1ull << fl;
+		m_slBitmaps[fl] |= 1u << sl;
+	}
+
+	void TlsfAllocator::removeFree(uint32_t block) noexcept
+	{
+		uint32_t fl, sl;
+		mapping(m_blocks[block].size, fl, sl);
+
+		auto& current = m_blocks[block];
+		if (current.prev_free != INVALID_BLOCK)
+			m_blocks[current.prev_free].next_free = current.next_free;
+		else
+			m_heads[fl][sl] = current.next_free;
+
+		if (current.next_free != INVALID_BLOCK)
+			m_blocks[current.next_free].prev_free = current.prev_free;
+
+		current.free = false;
+		current.prev_free = current.next_free = INVALID_BLOCK;
+
+		if (m_heads[fl][sl] == INVALID_BLOCK)
+		{
+			m_slBitmaps[fl] &= ~(1u << sl);
+			if (m_slBitmaps[fl] == 0)
+				m_flBitmap &= ~(1ull << fl);
+		}
+	}
+
+	uint32_t TlsfAllocator::splitFront(uint32_t block, size_t size) noexcept
+	{
+		const auto front = createBlock();
+		auto& current = m_blocks[block];
+		auto& split = m_blocks[front];
+
+		split.offset = current.offset;
+		split.size = size;
+		split.prev_physical = current.prev_physical;
+		split.next_physical = block;
+		if (split.prev_physical != INVALID_BLOCK)
+			m_blocks[split.prev_physical].next_physical = front;
+
+		current.offset += size;
+		current.size -= size;
+		current.prev_physical = front;
+		return front;
+	}
+
+	uint32_t TlsfAllocator::findFree(size_t size) const noexcept
+	{
+		if (size > m_capacity)
+			return INVALID_BLOCK;
+
+		uint32_t fl, sl;
+		mappingSearch(size, fl, sl);
+		if (fl >= FL_COUNT)
+			return INVALID_BLOCK;
+
+		uint32_t sl_map = m_slBitmaps[fl] & (~0u << sl);
+		if (sl_map == 0)
+		{
+			const uint64_t fl_map = fl + 1 < 64 ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+			if (fl_map == 0)
+				return INVALID_BLOCK;
+
+			fl = (uint32_t)std::countr_zero(fl_map);
+			sl_map = m_slBitmaps[fl];
+		}
+
+		return m_heads[fl][std::countr_zero(sl_map)];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+// Per frame camera and light, laid out like FrameBlock in renderer.cpp
+layout(std140, binding = 0) uniform Frame
+{
+	mat4 V;
+	mat4 P;
+	vec3 LightPosition_worldspace;
+	float LightPower;
+	vec3 LightColor;
+};
\ No newline at end of file
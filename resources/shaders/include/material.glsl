@@ -0,0 +1,9 @@
+#pragma once
+
+// Constant material colors, laid out like MaterialBlock in renderer.cpp
+layout(std140, binding = 1) uniform Material
+{
+	vec4 MaterialDiffuse;
+	vec4 MaterialAmbient;
+	vec4 MaterialSpecular;
+};
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+// Per draw transforms, laid out like ObjectBlock in renderer.cpp
+layout(std140, binding = 2) uniform Object
+{
+	mat4 MVP;
+	mat4 M;
+	vec4 Params; // x: alpha
+};
\ No newline at end of file
@@ -0,0 +1,70 @@
+#version 460 core
+
+// Inputs
+layout(location = 0) in vec3 VertexPosition_modelspace;
+layout(location = 1) in vec2 VertexUV;
+layout(location = 2) in vec3 VertexNormal_modelspace;
+
+#ifdef FEATURE_INSTANCING
+// Per instance inputs
+layout(location = 3) in mat4 InstanceModel;
+layout(location = 7) in vec4 InstanceParams; // x: alpha
+#endif
+
+// Outputs
+out vec2 UV;
+flat out float DrawAlpha;
+out vec3 Position_worldspace;
+out vec3 Normal_cameraspace;
+out vec3 EyeDirection_cameraspace;
+out vec3 LightDirection_cameraspace;
+
+#ifndef FEATURE_INSTANCING
+// Per draw data, indexed by the draw within the multi draw
+struct Draw
+{
+	mat4 M;
+	vec4 Params; // x: alpha
+};
+
+layout(std430, binding = 0) readonly buffer DrawData
+{
+	Draw Draws[];
+};
+#endif
+
+// Uniform blocks
+#include "frame.glsl"
+
+void main()
+{
+#ifdef FEATURE_INSTANCING
+	mat4 M = InstanceModel;
+	DrawAlpha = InstanceParams.x;
+#else
+	mat4 M = Draws[gl_DrawID].M;
+	DrawAlpha = Draws[gl_DrawID].Params.x;
+#endif
+	mat4 MVP = P * V * M;
+
+	// Output position of the vertex in clipspace
+	gl_Position = MVP * vec4(VertexPosition_modelspace, 1.0);
+
+	// Position of the vertex in worldspace
+	Position_worldspace = (M * vec4(VertexPosition_modelspace,1.0)).xyz;
+
+	// Vector that goes from vertex to camera in cameraspace
+	vec3 vertexPosition_cameraspace = ( V * M * vec4(VertexPosition_modelspace, 1.0)).xyz;
+	EyeDirection_cameraspace = vec3(0.0, 0.0, 0.0) - vertexPosition_cameraspace;
+
+	// Vector that goes from vertex to the light in cameraspace.
+	vec3 LightPosition_cameraspace = (V * vec4(LightPosition_worldspace, 1.0)).xyz;
+	LightDirection_cameraspace = LightPosition_cameraspace + EyeDirection_cameraspace;
+
+	// Normal of vertex in cameraspace
+	Normal_cameraspace = ( V * M * vec4(VertexNormal_modelspace, 0.0)).xyz;
+
+
+	// UV of the vertex
+	UV = VertexUV;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#version 460 core
+#extension GL_ARB_bindless_texture : enable
+
+// Inputs
+in vec2 UV;
+in vec3 Position_worldspace;
+in vec3 Normal_cameraspace;
+in vec3 EyeDirection_cameraspace;
+in vec3 LightDirection_cameraspace;
+
+// Outputs
+out vec4 Color;
+
+// Material table, two words per slot holding a texture handle or the array layer + 1
+layout(std430, binding = 0) readonly buffer Materials
+{
+	uvec2 MaterialTextures[];
+};
+
+// Uniforms
+uniform uint MaterialID = 0;
+uniform int MaterialTexturesPerMaterial = 4;
+uniform bool MaterialBindless = false;
+uniform sampler2DArray MaterialArray;
+
+uniform vec3 LightPosition_worldspace = vec3(0.0, 3.0, 1.0);
+uniform vec3 LightColor = vec3(1.0, 1.0, 1.0);
+uniform float LightPower = 0.5;
+uniform float Alpha = 1.0;
+
+vec4 sampleMaterial(int slot, vec2 uv, vec4 fallback)
+{
+	uvec2 entry = MaterialTextures[MaterialID * uint(MaterialTexturesPerMaterial) + uint(slot)];
+	if (entry == uvec2(0))
+		return fallback;
+
+#ifdef GL_ARB_bindless_texture
+	if (MaterialBindless)
+		return texture(sampler2D(entry), uv);
+#endif
+
+	return texture(MaterialArray, vec3(uv, float(entry.x - 1u)));
+}
+
+void main()
+{
+	// Material properties, slot 0 is the diffuse texture
+	vec4 diffuse = sampleMaterial(0, UV, vec4(1.0, 0.0, 0.0, 1.0));
+	vec3 material_diffuse_color = diffuse.rgb;
+	vec3 material_ambient_color = vec3(0.1, 0.1, 0.1) * material_diffuse_color;
+	vec3 material_specular_color = vec3(0.3, 0.3, 0.3);
+
+	float distance = length(LightPosition_worldspace - Position_worldspace);
+
+	vec3 n = normalize(Normal_cameraspace);
+	vec3 l = normalize(LightDirection_cameraspace);
+	float cos_theta = clamp(dot(n, l), 0.0, 1.0);
+
+	vec3 E = normalize(EyeDirection_cameraspace);
+	vec3 R = reflect(-l, n);
+	float cos_alpha = clamp(dot(E, R), 0.0, 1.0);
+
+	Color.rgb =
+		material_ambient_color +
+		material_diffuse_color * LightColor * LightPower * cos_theta / (distance * distance) +
+		material_specular_color * LightColor * LightPower * pow(cos_alpha, 5) / (distance * distance);
+	Color.a = diffuse.a * Alpha;
+}
\ No newline at end of file
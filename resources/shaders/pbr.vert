@@ -2,7 +2,7 @@
 
 // Inputs
 layout(location = 0) in vec3 Position_modelspace;
-layout(location = 1) in vec3 VertexUV;
+layout(location = 1) in vec2 VertexUV;
 layout(location = 2) in vec3 Normal_modelspace;
 
 // Outputs
@@ -17,8 +17,8 @@ uniform mat4 M;
 void main()
 {
 	UV = VertexUV;
-	Position_worldspace = vec3(Model * vec4(Position_modelspace, 1.0));
-	Normal_modelspace = mat3(Model) * Normal_modelspace;
+	Position_worldspace = vec3(M * vec4(Position_modelspace, 1.0));
+	Normal_worldspace = mat3(M) * Normal_modelspace;
 
 	gl_Position = MVP * vec4(Position_modelspace, 1.0);
 }
\ No newline at end of file
@@ -10,18 +10,17 @@ in vec3 LightDirection_cameraspace;
 // Outputs
 out vec4 Color;
 
-// Uniforms
-uniform vec3 LightPosition_worldspace = vec3(0.0, 3.0, 1.0);
-uniform vec3 LightColor = vec3(1.0, 1.0, 1.0);
-uniform float LightPower = 0.5;
-uniform float Alpha = 1.0;
+// Uniform blocks
+#include "frame.glsl"
+#include "material.glsl"
+#include "object.glsl"
 
 void main()
 {
     // Material properties
-    vec3 material_diffuse_color = vec3(1.0, 0.0, 0.0);
-    vec3 material_ambient_color = vec3(0.1, 0.1, 0.1) * material_diffuse_color;
-    vec3 material_specular_color = vec3(0.3, 0.3, 0.3);
+    vec3 material_diffuse_color = MaterialDiffuse.rgb;
+    vec3 material_ambient_color = MaterialAmbient.rgb;
+    vec3 material_specular_color = MaterialSpecular.rgb;
 
     // Distance to light
     float distance = length(LightPosition_worldspace - Position_worldspace);
@@ -48,6 +47,6 @@ void main()
         // Specular : reflecting highlight
         material_specular_color * LightColor * LightPower * pow(cos_alpha, 5) / (distance * distance);
     // Basic transparency
-    Color.a = Alpha;
+    Color.a = Params.x;
 
 }
\ No newline at end of file
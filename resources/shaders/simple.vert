@@ -12,11 +12,9 @@ out vec3 Normal_cameraspace;
 out vec3 EyeDirection_cameraspace;
 out vec3 LightDirection_cameraspace;
 
-// Uniforms
-uniform mat4 MVP = mat4(1.0);
-uniform mat4 M = mat4(1.0);
-uniform mat4 V = mat4(1.0);
-uniform vec3 LightPosition_worldspace = vec3(0.0, 3.0, 1.0);
+// Uniform blocks
+#include "frame.glsl"
+#include "object.glsl"
 
 void main()
 {
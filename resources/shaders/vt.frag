@@ -0,0 +1,40 @@
+#version 460 core
+
+// Inputs
+in vec2 UV;
+
+// Outputs
+out vec4 Color;
+
+// Uniforms
+uniform sampler2D VTPageTable;
+uniform sampler2D VTCache;
+uniform vec2 VTVirtualSize;
+uniform vec2 VTCacheSize;
+uniform float VTPageSize;
+uniform float VTBorder;
+uniform int VTMaxMip;
+
+vec4 sampleVirtual(vec2 uv)
+{
+	vec2 texel_coords = uv * VTVirtualSize;
+	vec2 dx = dFdx(texel_coords);
+	vec2 dy = dFdy(texel_coords);
+	int mip = int(clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy)))), 0.0, float(VTMaxMip)));
+
+	ivec2 pages = textureSize(VTPageTable, mip);
+	ivec2 page = min(ivec2(uv * vec2(pages)), pages - 1);
+
+	// (slot x, slot y, resident mip), the resident page may be coarser than the requested one
+	vec3 entry = texelFetch(VTPageTable, page, mip).rgb * 255.0;
+	vec2 resident_pages = max(floor(VTVirtualSize / (VTPageSize * exp2(entry.b))), vec2(1.0));
+	vec2 in_page = fract(uv * resident_pages);
+
+	vec2 texel = entry.rg * (VTPageSize + 2.0 * VTBorder) + VTBorder + in_page * VTPageSize;
+	return textureLod(VTCache, texel / VTCacheSize, 0.0);
+}
+
+void main()
+{
+	Color = sampleVirtual(clamp(UV, vec2(0.0), vec2(0.99999)));
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#version 460 core
+
+// Inputs
+in vec2 UV;
+
+// Outputs
+layout(location = 0) out uint PageRequest;
+
+// Uniforms
+uniform vec2 VTVirtualSize;
+uniform float VTPageSize;
+uniform int VTMaxMip;
+uniform float VTFeedbackBias = 0.0;
+
+void main()
+{
+	vec2 uv = clamp(UV, vec2(0.0), vec2(1.0));
+
+	// Derivatives are taken at feedback resolution, bias back to the mip the full resolution pass will sample
+	vec2 texel_coords = uv * VTVirtualSize;
+	vec2 dx = dFdx(texel_coords);
+	vec2 dy = dFdy(texel_coords);
+	float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) - VTFeedbackBias;
+	uint mip = uint(clamp(floor(lod), 0.0, float(VTMaxMip)));
+
+	uvec2 pages = max(uvec2(VTVirtualSize / VTPageSize) >> mip, uvec2(1u));
+	uvec2 page = min(uvec2(uv * vec2(pages)), pages - 1u);
+
+	// x:12 | y:12 | mip:4
+	PageRequest = (page.x & 0xFFFu) | ((page.y & 0xFFFu) << 12) | ((mip & 0xFu) << 24);
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <shader_preprocessor/header_writer.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace shpp
+{
+	namespace
+	{
+		// GLSL names that are C++ keywords get a trailing underscore
+		constexpr std::string_view CPP_KEYWORDS[] = {
+			"alignas", "alignof", "and", "asm", "auto", "bitand", "bitor", "catch", "char", "class", "compl", "concept",
+			"consteval", "constexpr", "constinit", "const_cast", "decltype", "default", "delete", "dynamic_cast",
+			"enum", "explicit", "export", "extern", "friend", "goto", "inline", "long", "mutable", "namespace", "new",
+			"noexcept", "not", "nullptr", "operator", "or", "private", "protected", "public", "register",
+			"reinterpret_cast", "requires", "short", "signed", "sizeof", "static", "static_assert", "static_cast",
+			"template", "this", "thread_local", "throw", "try", "typedef", "typeid", "typename", "union", "using",
+			"virtual", "wchar_t", "xor"
+		};
+
+		std::string identifier(const std::string& name)
+		{
+			if (std::find(std::begin(CPP_KEYWORDS), std::end(CPP_KEYWORDS), name) != std::end(CPP_KEYWORDS))
+				return name + "_";
+			return name;
+		}
+
+		void writeGroup(std::ostringstream& os, const Declarations& declarations, const char* group, const char* type)
+		{
+			if (declarations.empty())
+				return;
+
+			std::vector<std::tuple<int, std::string, int>> entries;
+			for (const auto& [name, declaration] : declarations)
+				entries.emplace_back(declaration.slot, name, declaration.count);
+			std::sort(entries.begin(), entries.end());
+
+			os << "\n\tnamespace " << group << "\n\t{\n";
+			for (const auto& [slot, name, count] : entries)
+				os << "\t\tinline constexpr shpp::" << type << ' ' << identifier(name) << "{ \"" << name << "\", " << slot << ", " << count << " };\n";
+			os << "\t}\n";
+		}
+	}
+
+	std::string headerName(const std::filesystem::path& path)
+	{
+		auto name = path.filename().string();
+		std::replace_if(name.begin(), name.end(), [](char c) { return !std::isalnum((unsigned char)c) && c != '_'; }, '_');
+		return name;
+	}
+
+	std::string generateHeader(const ShaderFile& file, const std::string& name_space, const std::string& resource)
+	{
+		std::ostringstream os;
+		os << "// Generated by the shader preprocessor from " << file.path.filename().string() << ", do not edit\n";
+		os << "#pragma once\n\n";
+		os << "#include <string_view>\n\n";
+		os << "#include <shader_preprocessor/reflection.hpp>\n\n";
+		os << "namespace " << name_space << "::" << headerName(file.path) << "\n{\n";
+		os << "\tinline constexpr std::string_view RESOURCE = \"" << resource << "\";\n";
+
+		writeGroup(os, file.attributes, "attributes", "Location");
+		writeGroup(os, file.outputs, "outputs", "Location");
+		writeGroup(os, file.uniforms, "uniforms", "Location");
+		writeGroup(os, file.textures, "textures", "Binding");
+		writeGroup(os, file.images, "images", "Binding");
+		writeGroup(os, file.atomic_counters, "atomic_counters", "Binding");
+		writeGroup(os, file.uniform_blocks, "uniform_blocks", "Binding");
+		writeGroup(os, file.storage_blocks, "storage_blocks", "Binding");
+
+		os << "}\n";
+		return os.str();
+	}
+}
\ No newline at end of file
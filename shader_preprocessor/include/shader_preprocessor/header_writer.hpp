@@ -0,0 +1,16 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include <shader_preprocessor/shader_file.hpp>
+
+namespace shpp
+{
+	// Identifier of a shader in generated code, e.g. cull_comp for cull.comp
+	std::string headerName(const std::filesystem::path& path);
+
+	// C++ header with the slots of one shader as shpp::Location and shpp::Binding constants, in a namespace
+	// named after the shader inside `name_space`. `resource` is the path the processed source is loaded from.
+	std::string generateHeader(const ShaderFile& file, const std::string& name_space, const std::string& resource);
+}
\ No newline at end of file
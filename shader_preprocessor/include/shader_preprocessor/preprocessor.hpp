@@ -0,0 +1,36 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <shader_preprocessor/shader_file.hpp>
+
+namespace shpp
+{
+	// Resolves #include and injects defines, errors are thrown as std::runtime_error("file:line: message").
+	//
+	// Includes are searched next to the including file first and then in the include directories. Files with
+	// #pragma once are only included once per shader, and #line directives keep compiler messages pointing at
+	// the original files. Includes are resolved regardless of #if, there is no conditional evaluation.
+	class Preprocessor
+	{
+	public:
+		void addIncludeDirectory(std::filesystem::path directory);
+
+		// Injected right after #version, so they apply to includes as well
+		void define(std::string name, std::string value = {});
+
+		ShaderFile process(const std::filesystem::path& path) const;
+
+	private:
+		struct Context;
+
+		void expand(const std::filesystem::path& path, Context& context) const;
+		std::filesystem::path resolve(const std::string& include, const std::filesystem::path& from) const;
+
+		std::vector<std::filesystem::path> m_includeDirectories;
+		std::vector<std::pair<std::string, std::string>> m_defines;
+	};
+}
\ No newline at end of file
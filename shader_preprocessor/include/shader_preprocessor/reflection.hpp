@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string_view>
+
+// Types used by the headers the shader preprocessor generates, so they only depend on the standard library
+namespace shpp
+{
+	// Vertex input, fragment output or default block uniform, arrays take `count` consecutive locations
+	struct Location
+	{
+		std::string_view name;
+		int location;
+		int count;
+	};
+
+	// Uniform or storage block, texture unit, image unit or atomic counter buffer
+	struct Binding
+	{
+		std::string_view name;
+		int binding;
+		int count;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include <shader_preprocessor/shader_file.hpp>
+
+namespace shpp
+{
+	// Scans the global declarations of a preprocessed file, errors are thrown as
+	// std::runtime_error("file:line: message"). Vertex inputs need explicit locations, since vertex arrays are set
+	// up by number, and only one variable with a slot may be declared per statement.
+	void reflect(ShaderFile& file);
+
+	// Assigns slots to uniforms, textures, images and blocks declared without one and injects them into the
+	// sources as layout qualifiers. One allocator is shared by every file of a run, so a name gets the same slot
+	// in every stage and assigned slots never collide with explicit ones.
+	class SlotAllocator
+	{
+	public:
+		// Call for every file before the first assign()
+		void reserve(const ShaderFile& file);
+		void assign(ShaderFile& file);
+
+	private:
+		struct Space
+		{
+			std::vector<bool> used;
+			tsl::robin_map<std::string, int> slots;
+			tsl::robin_map<std::string, int> counts;
+		};
+
+		static void reserve(Space& space, const Declarations& declarations);
+		static int allocate(Space& space, const std::string& name);
+
+		Space m_uniforms;
+		Space m_textures;
+		Space m_images;
+		Space m_uniformBlocks;
+		Space m_storageBlocks;
+	};
+}
\ No newline at end of file
@@ -1,12 +1,66 @@
 #pragma once
 
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
 #include <tsl/robin_map.h>
 
 namespace shpp
 {
+	enum class Stage
+	{
+		eVertex,
+		eFragment,
+		eGeometry,
+		eTessControl,
+		eTessEvaluation,
+		eCompute
+	};
+
+	// Global declaration with a location or binding slot
+	struct Declaration
+	{
+		std::string type;
+
+		// Position in the original files, `file` indexes ShaderFile::files
+		size_t file = 0;
+		size_t line = 0;
+
+		// Locations or bindings taken, array elements and matrix columns of vertex inputs take one each
+		int slot = -1;
+		int count = 1;
+		bool explicit_slot = false;
+
+		// Offsets into the processed source, where an assigned slot is injected
+		size_t statement_begin = 0;
+		size_t layout_end = std::string::npos;
+	};
+
+	using Declarations = tsl::robin_map<std::string, Declaration>;
+
+	// One stage after preprocessing, with the slots of everything the renderer binds by number
 	struct ShaderFile
 	{
-		tsl::robin_map<std::string, int> uniforms;
-		tsl::robin_map<std::string, int> attributes;
+		std::filesystem::path path;
+		Stage stage = Stage::eVertex;
+		int version = 0;
+
+		// Includes resolved and defines injected, files are the source string numbers of #line directives
+		std::string source;
+		std::vector<std::filesystem::path> files;
+
+		Declarations attributes;
+		Declarations outputs;
+		Declarations uniforms;
+		Declarations textures;
+		Declarations images;
+		Declarations atomic_counters;
+		Declarations uniform_blocks;
+		Declarations storage_blocks;
 	};
+
+	// Throws std::invalid_argument for unknown extensions
+	Stage stageFromPath(const std::filesystem::path& path);
 }
\ No newline at end of file
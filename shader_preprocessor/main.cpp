@@ -1,6 +1,213 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include <cxxopts.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
 
-int main()
+#include <shader_preprocessor/header_writer.hpp>
+#include <shader_preprocessor/preprocessor.hpp>
+#include <shader_preprocessor/reflector.hpp>
+
+namespace
 {
+	GLenum glStage(shpp::Stage stage) noexcept
+	{
+		switch (stage)
+		{
+		case shpp::Stage::eVertex: return GL_VERTEX_SHADER;
+		case shpp::Stage::eFragment: return GL_FRAGMENT_SHADER;
+		case shpp::Stage::eGeometry: return GL_GEOMETRY_SHADER;
+		case shpp::Stage::eTessControl: return GL_TESS_CONTROL_SHADER;
+		case shpp::Stage::eTessEvaluation: return GL_TESS_EVALUATION_SHADER;
+		case shpp::Stage::eCompute: return GL_COMPUTE_SHADER;
+		}
+
+		return GL_VERTEX_SHADER;
+	}
+
+	void writeFile(const std::filesystem::path& path, const std::string& data)
+	{
+		std::filesystem::create_directories(path.parent_path());
+
+		std::ofstream os(path, std::ios::binary);
+		if (!os.write(data.data(), (std::streamsize)data.size()))
+			throw std::runtime_error("Unable to write file '" + path.string() + "'");
+	}
+
+	// Compiles every stage with the driver of a hidden window, compiler messages refer to the source string
+	// numbers of the #line directives, which are listed after the log
+	bool validate(const std::vector<shpp::ShaderFile>& files)
+	{
+		if (!glfwInit())
+		{
+			std::cerr << "error: unable to initialize GLFW for validation\n";
+			return false;
+		}
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		auto* window = glfwCreateWindow(1, 1, "shader validation", nullptr, nullptr);
+		if (!window)
+		{
+			std::cerr << "error: unable to create an OpenGL 4.6 context for validation\n";
+			glfwTerminate();
+			return false;
+		}
+
+		glfwMakeContextCurrent(window);
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		{
+			std::cerr << "error: unable to load OpenGL for validation\n";
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return false;
+		}
+
+		bool valid = true;
+		for (const auto& file : files)
+		{
+			const auto shader = glCreateShader(glStage(file.stage));
+			const char* source = file.source.c_str();
+			glShaderSource(shader, 1, &source, nullptr);
+			glCompileShader(shader);
+
+			int status;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+			if (!status)
+			{
+				int length = 0;
+				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+				std::string log(length, '\0');
+				glGetShaderInfoLog(shader, length, nullptr, log.data());
+
+				std::cerr << file.path.string() << ": error: compilation failed\n" << log.c_str() << '\n';
+				for (size_t i = 0; i < file.files.size() && file.files.size() > 1; ++i)
+					std::cerr << "  source string " << i << ": " << file.files[i].string() << '\n';
+				valid = false;
+			}
+
+			glDeleteShader(shader);
+		}
+
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return valid;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	cxxopts::Options options("renderer-shader-preprocessor", "Resolves includes, assigns slots and generates C++ headers for GLSL shaders");
+	options.add_options()
+		("o,output", "Directory for the processed shaders", cxxopts::value<std::string>())
+		("header-output", "Directory for the generated headers", cxxopts::value<std::string>())
+		("I,include", "Include directory", cxxopts::value<std::vector<std::string>>())
+		("D,define", "Define injected after #version, NAME or NAME=VALUE", cxxopts::value<std::vector<std::string>>())
+		("namespace", "Namespace of the generated headers", cxxopts::value<std::string>()->default_value("shaders"))
+		("resource-prefix", "Prefix of the resource paths in the generated headers", cxxopts::value<std::string>()->default_value(""))
+		("validate", "Compile every shader with the OpenGL driver")
+		("h,help", "Print usage")
+		("shaders", "Shader files, the stage follows from the extension", cxxopts::value<std::vector<std::string>>());
+	options.parse_positional({ "shaders" });
+	options.positional_help("shaders...");
+
+	try
+	{
+		const auto result = options.parse(argc, argv);
+		if (result.count("help") || !result.count("shaders"))
+		{
+			std::cout << options.help() << '\n';
+			return result.count("help") ? 0 : 1;
+		}
+
+		shpp::Preprocessor preprocessor;
+		if (result.count("include"))
+		{
+			for (const auto& directory : result["include"].as<std::vector<std::string>>())
+				preprocessor.addIncludeDirectory(directory);
+		}
+
+		if (result.count("define"))
+		{
+			for (const auto& define : result["define"].as<std::vector<std::string>>())
+			{
+				const auto equals = define.find('=');
+				if (equals == std::string::npos)
+					preprocessor.define(define);
+				else
+					preprocessor.define(define.substr(0, equals), define.substr(equals + 1));
+			}
+		}
+
+		// Every file is reflected before slots are assigned, so assigned slots avoid all explicit ones
+		std::vector<shpp::ShaderFile> files;
+		bool failed = false;
+		for (const auto& path : result["shaders"].as<std::vector<std::string>>())
+		{
+			try
+			{
+				auto file = preprocessor.process(path);
+				shpp::reflect(file);
+				files.push_back(std::move(file));
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << e.what() << '\n';
+				failed = true;
+			}
+		}
+
+		if (failed)
+			return 1;
+
+		shpp::SlotAllocator allocator;
+		for (const auto& file : files)
+			allocator.reserve(file);
+
+		for (auto& file : files)
+		{
+			try
+			{
+				allocator.assign(file);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << e.what() << '\n';
+				failed = true;
+			}
+		}
+
+		if (failed || (result.count("validate") && !validate(files)))
+			return 1;
+
+		const auto name_space = result["namespace"].as<std::string>();
+		const auto resource_prefix = result["resource-prefix"].as<std::string>();
+		for (const auto& file : files)
+		{
+			const auto filename = file.path.filename();
+			if (result.count("output"))
+				writeFile(std::filesystem::path(result["output"].as<std::string>()) / filename, file.source);
+
+			if (result.count("header-output"))
+			{
+				const auto header = shpp::generateHeader(file, name_space, resource_prefix + filename.string());
+				writeFile(std::filesystem::path(result["header-output"].as<std::string>()) / (shpp::headerName(filename) + ".hpp"), header);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "error: " << e.what() << '\n';
+		return 1;
+	}
 
+	return 0;
 }
\ No newline at end of file
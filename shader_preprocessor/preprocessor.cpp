@@ -0,0 +1,196 @@
+#include <shader_preprocessor/preprocessor.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace shpp
+{
+	namespace
+	{
+		std::string readFile(const std::filesystem::path& path)
+		{
+			std::ifstream is(path, std::ios::binary);
+			if (!is)
+				throw std::runtime_error("Unable to open file '" + path.string() + "'");
+
+			return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+		}
+
+		std::runtime_error error(const std::filesystem::path& path, size_t line, const std::string& message)
+		{
+			return std::runtime_error(path.string() + ":" + std::to_string(line) + ": " + message);
+		}
+
+		size_t skipSpaces(const std::string& line, size_t pos) noexcept
+		{
+			while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+				++pos;
+			return pos;
+		}
+
+		// Name of the directive on the line, empty for anything else
+		std::string directive(const std::string& line, size_t& pos)
+		{
+			pos = skipSpaces(line, 0);
+			if (pos == line.size() || line[pos] != '#')
+				return {};
+
+			pos = skipSpaces(line, pos + 1);
+			const auto begin = pos;
+			while (pos < line.size() && (std::isalnum((unsigned char)line[pos]) || line[pos] == '_'))
+				++pos;
+
+			return line.substr(begin, pos - begin);
+		}
+	}
+
+	struct Preprocessor::Context
+	{
+		ShaderFile& file;
+		std::vector<std::filesystem::path> stack;
+		std::vector<std::filesystem::path> once;
+	};
+
+	void Preprocessor::addIncludeDirectory(std::filesystem::path directory)
+	{
+		m_includeDirectories.push_back(std::move(directory));
+	}
+
+	void Preprocessor::define(std::string name, std::string value)
+	{
+		m_defines.emplace_back(std::move(name), std::move(value));
+	}
+
+	ShaderFile Preprocessor::process(const std::filesystem::path& path) const
+	{
+		ShaderFile file;
+		file.path = path;
+		file.stage = stageFromPath(path);
+
+		Context context{ file, {}, {} };
+		expand(path, context);
+
+		if (file.version == 0)
+			throw error(path, 1, "missing #version");
+
+		return file;
+	}
+
+	void Preprocessor::expand(const std::filesystem::path& path, Context& context) const
+	{
+		const auto canonical = std::filesystem::weakly_canonical(path);
+		if (std::find(context.stack.begin(), context.stack.end(), canonical) != context.stack.end())
+			throw error(path, 1, "include cycle");
+
+		auto& file = context.file;
+		const auto index = file.files.size();
+		const auto data = readFile(path);
+		file.files.push_back(path);
+		context.stack.push_back(canonical);
+
+		if (index > 0)
+			file.source += "#line 1 " + std::to_string(index) + "\n";
+
+		size_t line_number = 0;
+		size_t begin = 0;
+		while (begin < data.size())
+		{
+			auto end = data.find('\n', begin);
+			if (end == std::string::npos)
+				end = data.size();
+
+			auto line = data.substr(begin, end - begin);
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			begin = end + 1;
+			++line_number;
+
+			size_t pos;
+			const auto name = directive(line, pos);
+			if (name == "include")
+			{
+				pos = skipSpaces(line, pos);
+				const auto close = pos < line.size() ? (line[pos] == '"' ? '"' : line[pos] == '<' ? '>' : '\0') : '\0';
+				const auto last = close ? line.find(close, pos + 1) : std::string::npos;
+				if (last == std::string::npos)
+					throw error(path, line_number, "expected \"file\" or <file> after #include");
+
+				const auto include = line.substr(pos + 1, last - pos - 1);
+				const auto resolved = resolve(include, path);
+				if (resolved.empty())
+					throw error(path, line_number, "unable to find include '" + include + "'");
+
+				if (std::find(context.once.begin(), context.once.end(), std::filesystem::weakly_canonical(resolved)) != context.once.end())
+				{
+					file.source += '\n';
+					continue;
+				}
+
+				expand(resolved, context);
+				file.source += "#line " + std::to_string(line_number + 1) + " " + std::to_string(index) + "\n";
+			}
+			else if (name == "pragma" && line.compare(skipSpaces(line, pos), 4, "once") == 0)
+			{
+				context.once.push_back(canonical);
+				file.source += '\n';
+			}
+			else if (name == "version")
+			{
+				if (index > 0)
+					throw error(path, line_number, "#version in an included file");
+
+				file.version = std::atoi(line.c_str() + pos);
+				if (file.version == 0)
+					throw error(path, line_number, "invalid #version");
+
+				file.source += line + '\n';
+				for (const auto& [define, value] : m_defines)
+					file.source += "#define " + define + (value.empty() ? "" : " " + value) + '\n';
+
+				if (!m_defines.empty())
+					file.source += "#line " + std::to_string(line_number + 1) + " 0\n";
+			}
+			else
+			{
+				file.source += line + '\n';
+			}
+		}
+
+		context.stack.pop_back();
+	}
+
+	std::filesystem::path Preprocessor::resolve(const std::string& include, const std::filesystem::path& from) const
+	{
+		const auto local = from.parent_path() / include;
+		if (std::filesystem::is_regular_file(local))
+			return local;
+
+		for (const auto& directory : m_includeDirectories)
+		{
+			const auto candidate = directory / include;
+			if (std::filesystem::is_regular_file(candidate))
+				return candidate;
+		}
+
+		return {};
+	}
+
+	Stage stageFromPath(const std::filesystem::path& path)
+	{
+		const auto extension = path.extension().string();
+		if (extension == ".vert") return Stage::eVertex;
+		if (extension == ".frag") return Stage::eFragment;
+		if (extension == ".geom") return Stage::eGeometry;
+		if (extension == ".tesc") return Stage::eTessControl;
+		if (extension == ".tese") return Stage::eTessEvaluation;
+		if (extension == ".comp") return Stage::eCompute;
+
+		throw std::invalid_argument("Unknown shader stage for '" + path.string() + "'");
+	}
+}
\ No newline at end of file
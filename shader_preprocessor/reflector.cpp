@@ -0,0 +1,580 @@
+#include <shader_preprocessor/reflector.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace shpp
+{
+	namespace
+	{
+		struct Token
+		{
+			std::string_view text;
+			size_t offset;
+			size_t file;
+			size_t line;
+		};
+
+		using Statement = std::vector<Token>;
+
+		struct LayoutQualifier
+		{
+			std::string_view name;
+			int value;
+			bool literal;
+		};
+
+		constexpr std::string_view QUALIFIERS[] = {
+			"const", "in", "out", "inout", "uniform", "buffer", "shared", "attribute", "varying",
+			"flat", "smooth", "noperspective", "centroid", "sample", "patch", "invariant", "precise",
+			"coherent", "volatile", "restrict", "readonly", "writeonly", "highp", "mediump", "lowp"
+		};
+
+		std::runtime_error error(const ShaderFile& file, size_t source, size_t line, const std::string& message)
+		{
+			return std::runtime_error(file.files[source].string() + ":" + std::to_string(line) + ": " + message);
+		}
+
+		std::runtime_error error(const ShaderFile& file, const Token& token, const std::string& message)
+		{
+			return error(file, token.file, token.line, message);
+		}
+
+		bool isIdentifier(char c) noexcept
+		{
+			return std::isalnum((unsigned char)c) || c == '_';
+		}
+
+		bool isName(std::string_view text) noexcept
+		{
+			return !text.empty() && (std::isalpha((unsigned char)text.front()) || text.front() == '_');
+		}
+
+		bool startsWithAny(std::string_view type, std::initializer_list<std::string_view> prefixes) noexcept
+		{
+			return std::any_of(prefixes.begin(), prefixes.end(), [type](auto prefix) { return type.starts_with(prefix); });
+		}
+
+		// Vertex inputs take one location per matrix column
+		int columns(std::string_view type) noexcept
+		{
+			if (type.starts_with("dmat"))
+				type.remove_prefix(1);
+
+			if (type.starts_with("mat") && type.size() > 3)
+				return type[3] - '0';
+
+			return 1;
+		}
+
+		// Comments and preprocessor lines are skipped, #line directives move the position
+		std::vector<Token> tokenize(const ShaderFile& file)
+		{
+			const std::string_view source = file.source;
+			std::vector<Token> tokens;
+			size_t current_file = 0;
+			size_t line = 1;
+			bool line_start = true;
+
+			size_t i = 0;
+			while (i < source.size())
+			{
+				const char c = source[i];
+				if (c == '\n')
+				{
+					++line;
+					line_start = true;
+					++i;
+				}
+				else if (c == ' ' || c == '\t' || c == '\r')
+				{
+					++i;
+				}
+				else if (c == '#' && line_start)
+				{
+					auto end = i;
+					size_t continuations = 0;
+					while (end < source.size() && source[end] != '\n')
+					{
+						if (source[end] == '\\' && end + 1 < source.size() && source[end + 1] == '\n')
+						{
+							++continuations;
+							++end;
+						}
+						++end;
+					}
+
+					std::istringstream directive(std::string(source.substr(i + 1, end - i - 1)));
+					std::string name;
+					size_t number, index;
+					if (directive >> name && name == "line" && directive >> number)
+					{
+						line = number - 1;
+						if (directive >> index)
+							current_file = std::min(index, file.files.size() - 1);
+					}
+					else
+					{
+						line += continuations;
+					}
+
+					i = end;
+				}
+				else if (c == '/' && i + 1 < source.size() && source[i + 1] == '/')
+				{
+					while (i < source.size() && source[i] != '\n')
+						++i;
+				}
+				else if (c == '/' && i + 1 < source.size() && source[i + 1] == '*')
+				{
+					const auto end = source.find("*/", i + 2);
+					if (end == std::string_view::npos)
+						throw error(file, current_file, line, "unterminated comment");
+
+					line += (size_t)std::count(source.begin() + i, source.begin() + end, '\n');
+					i = end + 2;
+				}
+				else
+				{
+					line_start = false;
+
+					auto end = i + 1;
+					if (isIdentifier(c))
+					{
+						while (end < source.size() && (isIdentifier(source[end]) || (std::isdigit((unsigned char)c) && source[end] == '.')))
+							++end;
+					}
+
+					tokens.push_back({ source.substr(i, end - i), i, current_file, line });
+					i = end;
+				}
+			}
+
+			return tokens;
+		}
+
+		// Index past the brace matching the one at `begin`
+		size_t skipBraces(const ShaderFile& file, const std::vector<Token>& tokens, size_t begin)
+		{
+			int depth = 0;
+			for (auto i = begin; i < tokens.size(); ++i)
+			{
+				if (tokens[i].text == "{")
+					++depth;
+				else if (tokens[i].text == "}" && --depth == 0)
+					return i + 1;
+			}
+
+			throw error(file, tokens[begin], "unbalanced braces");
+		}
+
+		// A parenthesis that does not belong to a layout qualifier or an initializer starts a parameter list
+		bool isFunction(const Statement& statement) noexcept
+		{
+			for (size_t i = 1; i < statement.size(); ++i)
+			{
+				if (statement[i].text == "=")
+					return false;
+
+				if (statement[i].text == "(" && statement[i - 1].text != "layout")
+					return true;
+			}
+
+			return false;
+		}
+
+		const Token& at(const ShaderFile& file, const Statement& statement, size_t p)
+		{
+			if (p >= statement.size())
+				throw error(file, statement.back(), "unexpected end of declaration");
+
+			return statement[p];
+		}
+
+		size_t parseLayout(const ShaderFile& file, const Statement& statement, size_t p, std::vector<LayoutQualifier>& layout, size_t& layout_end)
+		{
+			if (at(file, statement, ++p).text != "(")
+				throw error(file, statement[p], "expected '(' after layout");
+
+			while (at(file, statement, ++p).text != ")")
+			{
+				if (statement[p].text == ",")
+					continue;
+
+				LayoutQualifier qualifier{ statement[p].text, 0, false };
+				if (at(file, statement, p + 1).text == "=")
+				{
+					p += 2;
+					const auto value = std::string(at(file, statement, p).text);
+					try
+					{
+						size_t used = 0;
+						qualifier.value = std::stoi(value, &used, 0);
+						qualifier.literal = used == value.size();
+					}
+					catch (const std::exception&)
+					{
+						qualifier.literal = false;
+					}
+
+					// Constant expressions are left to the compiler
+					while (at(file, statement, p + 1).text != "," && statement[p + 1].text != ")")
+					{
+						qualifier.literal = false;
+						++p;
+					}
+				}
+
+				layout.push_back(qualifier);
+			}
+
+			layout_end = statement[p].offset;
+			return p + 1;
+		}
+
+		int parseArray(const ShaderFile& file, const Statement& statement, size_t& p)
+		{
+			int count = 1;
+			while (p < statement.size() && statement[p].text == "[")
+			{
+				const auto& size = at(file, statement, ++p);
+				int value = 0;
+				try
+				{
+					value = std::stoi(std::string(size.text), nullptr, 0);
+				}
+				catch (const std::exception&)
+				{
+				}
+
+				if (value <= 0 || at(file, statement, ++p).text != "]")
+					throw error(file, size, "array sizes must be positive integer literals");
+
+				count *= value;
+				++p;
+			}
+
+			return count;
+		}
+
+		void add(const ShaderFile& file, Declarations& declarations, const Token& name, Declaration declaration)
+		{
+			if (declarations.count(std::string(name.text)))
+				throw error(file, name, "'" + std::string(name.text) + "' is declared twice");
+
+			declarations.emplace(std::string(name.text), std::move(declaration));
+		}
+
+		void declare(ShaderFile& file, const Statement& statement)
+		{
+			if (statement.empty())
+				return;
+
+			std::vector<LayoutQualifier> layout;
+			std::string_view storage;
+			Declaration declaration;
+			declaration.file = statement.front().file;
+			declaration.line = statement.front().line;
+			declaration.statement_begin = statement.front().offset;
+
+			size_t p = 0;
+			while (p < statement.size())
+			{
+				const auto text = statement[p].text;
+				if (text == "layout")
+				{
+					p = parseLayout(file, statement, p, layout, declaration.layout_end);
+				}
+				else if (std::find(std::begin(QUALIFIERS), std::end(QUALIFIERS), text) != std::end(QUALIFIERS))
+				{
+					if (text == "in" || text == "out" || text == "uniform" || text == "buffer")
+						storage = text;
+					++p;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			// Globals without storage, structs and qualifier only statements like the compute work group size
+			if (storage.empty() || p == statement.size() || statement[p].text == "struct")
+				return;
+
+			const auto qualifier = [&](std::string_view key) {
+				const auto it = std::find_if(layout.rbegin(), layout.rend(), [key](const auto& entry) { return entry.name == key; });
+				if (it == layout.rend())
+					return;
+
+				if (!it->literal)
+					throw error(file, statement.front(), std::string(key) + " must be an integer literal");
+
+				declaration.slot = it->value;
+				declaration.explicit_slot = true;
+			};
+
+			// Interface blocks, the body was replaced by a single {} token
+			if (at(file, statement, p + 1).text == "{}")
+			{
+				auto* blocks = storage == "uniform" ? &file.uniform_blocks : storage == "buffer" ? &file.storage_blocks : nullptr;
+				if (!blocks)
+					return;
+
+				const auto& name = statement[p];
+				declaration.type = std::string(storage);
+
+				p += 2;
+				if (p < statement.size() && isName(statement[p].text))
+					++p;
+				declaration.count = parseArray(file, statement, p);
+
+				qualifier("binding");
+				add(file, *blocks, name, std::move(declaration));
+				return;
+			}
+
+			declaration.type = std::string(statement[p++].text);
+			const auto type_count = parseArray(file, statement, p);
+
+			std::vector<std::pair<Token, int>> names;
+			while (p < statement.size())
+			{
+				const auto& name = statement[p++];
+				if (!isName(name.text))
+					throw error(file, name, "expected a name, got '" + std::string(name.text) + "'");
+
+				const auto count = type_count * parseArray(file, statement, p);
+				names.emplace_back(name, count);
+
+				// Skip the initializer up to the next declarator
+				int depth = 0;
+				while (p < statement.size() && (depth > 0 || statement[p].text != ","))
+				{
+					const auto text = statement[p++].text;
+					if (text == "(" || text == "[")
+						++depth;
+					else if (text == ")" || text == "]")
+						--depth;
+				}
+
+				if (p < statement.size())
+					++p;
+			}
+
+			Declarations* declarations = nullptr;
+			std::string_view key = "binding";
+			const std::string_view type = declaration.type;
+			if (storage == "in" && file.stage == Stage::eVertex)
+			{
+				declarations = &file.attributes;
+				key = "location";
+			}
+			else if (storage == "out" && file.stage == Stage::eFragment)
+			{
+				declarations = &file.outputs;
+				key = "location";
+			}
+			else if (storage == "uniform")
+			{
+				if (type == "atomic_uint")
+					declarations = &file.atomic_counters;
+				else if (startsWithAny(type, { "image", "iimage", "uimage" }))
+					declarations = &file.images;
+				else if (startsWithAny(type, { "sampler", "isampler", "usampler" }))
+					declarations = &file.textures;
+				else
+				{
+					declarations = &file.uniforms;
+					key = "location";
+				}
+			}
+
+			if (!declarations || names.empty())
+				return;
+
+			if (names.size() > 1)
+				throw error(file, names[1].first, "declare '" + std::string(names[1].first.text) + "' in its own statement so it can get its own slot");
+
+			const auto& [name, count] = names.front();
+			declaration.count = declarations == &file.attributes ? count * columns(type) : count;
+			qualifier(key);
+
+			if (declarations == &file.attributes && !declaration.explicit_slot)
+				throw error(file, name, "vertex input '" + std::string(name.text) + "' needs an explicit location");
+
+			if (declarations == &file.atomic_counters && !declaration.explicit_slot)
+				throw error(file, name, "atomic counter '" + std::string(name.text) + "' needs an explicit binding");
+
+			add(file, *declarations, name, std::move(declaration));
+		}
+
+		// Names ordered like their declarations, so slots are assigned in source order
+		std::vector<std::string> ordered(const Declarations& declarations)
+		{
+			std::vector<std::pair<size_t, std::string>> entries;
+			for (const auto& [name, declaration] : declarations)
+				entries.emplace_back(declaration.statement_begin, name);
+			std::sort(entries.begin(), entries.end());
+
+			std::vector<std::string> names;
+			for (auto& entry : entries)
+				names.push_back(std::move(entry.second));
+			return names;
+		}
+
+		void checkOverlaps(const ShaderFile& file, const Declarations& declarations, const std::string& what)
+		{
+			const auto names = ordered(declarations);
+			for (size_t i = 0; i < names.size(); ++i)
+			{
+				const auto& a = declarations.find(names[i])->second;
+				for (size_t j = 0; j < i; ++j)
+				{
+					const auto& b = declarations.find(names[j])->second;
+					if (a.slot < b.slot + b.count && b.slot < a.slot + a.count)
+						throw error(file, a.file, a.line, "'" + names[i] + "' overlaps the " + what + " of '" + names[j] + "'");
+				}
+			}
+		}
+	}
+
+	void reflect(ShaderFile& file)
+	{
+		const auto tokens = tokenize(file);
+
+		Statement statement;
+		for (size_t i = 0; i < tokens.size();)
+		{
+			const auto& token = tokens[i];
+			if (token.text == ";")
+			{
+				declare(file, statement);
+				statement.clear();
+				++i;
+			}
+			else if (token.text == "{")
+			{
+				// Function bodies end the statement, block bodies and initializer lists are collapsed
+				const auto end = skipBraces(file, tokens, i);
+				if (isFunction(statement))
+					statement.clear();
+				else
+					statement.push_back({ "{}", token.offset, token.file, token.line });
+				i = end;
+			}
+			else
+			{
+				statement.push_back(token);
+				++i;
+			}
+		}
+
+		// A single fragment output defaults to location 0, several need explicit ones
+		for (const auto& name : ordered(file.outputs))
+		{
+			auto& output = file.outputs[name];
+			if (output.explicit_slot)
+				continue;
+
+			if (file.outputs.size() > 1)
+				throw error(file, output.file, output.line, "fragment output '" + name + "' needs an explicit location");
+			output.slot = 0;
+		}
+
+		checkOverlaps(file, file.attributes, "location");
+		checkOverlaps(file, file.outputs, "location");
+	}
+
+	void SlotAllocator::reserve(const ShaderFile& file)
+	{
+		reserve(m_uniforms, file.uniforms);
+		reserve(m_textures, file.textures);
+		reserve(m_images, file.images);
+		reserve(m_uniformBlocks, file.uniform_blocks);
+		reserve(m_storageBlocks, file.storage_blocks);
+	}
+
+	void SlotAllocator::assign(ShaderFile& file)
+	{
+		std::vector<std::pair<size_t, std::string>> insertions;
+		const auto assign = [&](Space& space, Declarations& declarations, const std::string& key) {
+			for (const auto& name : ordered(declarations))
+			{
+				auto& declaration = declarations[name];
+				if (declaration.explicit_slot)
+					continue;
+
+				declaration.slot = allocate(space, name);
+
+				const auto value = key + " = " + std::to_string(declaration.slot);
+				if (declaration.layout_end != std::string::npos)
+					insertions.emplace_back(declaration.layout_end, ", " + value);
+				else
+					insertions.emplace_back(declaration.statement_begin, "layout(" + value + ") ");
+			}
+		};
+
+		assign(m_uniforms, file.uniforms, "location");
+		assign(m_textures, file.textures, "binding");
+		assign(m_images, file.images, "binding");
+		assign(m_uniformBlocks, file.uniform_blocks, "binding");
+		assign(m_storageBlocks, file.storage_blocks, "binding");
+
+		// Explicit uniform locations are core since 4.3
+		if (!insertions.empty() && file.version < 430)
+			throw error(file, 0, 1, "assigning slots needs #version 430 or later, declare them explicitly instead");
+
+		std::sort(insertions.begin(), insertions.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		for (const auto& [offset, text] : insertions)
+			file.source.insert(offset, text);
+
+		checkOverlaps(file, file.uniforms, "location");
+		checkOverlaps(file, file.textures, "texture unit");
+		checkOverlaps(file, file.images, "image unit");
+		checkOverlaps(file, file.uniform_blocks, "binding");
+		checkOverlaps(file, file.storage_blocks, "binding");
+	}
+
+	void SlotAllocator::reserve(Space& space, const Declarations& declarations)
+	{
+		for (const auto& [name, declaration] : declarations)
+		{
+			auto& count = space.counts[name];
+			count = std::max(count, declaration.count);
+
+			if (!declaration.explicit_slot)
+				continue;
+
+			const auto end = (size_t)(declaration.slot + declaration.count);
+			if (space.used.size() < end)
+				space.used.resize(end);
+			std::fill(space.used.begin() + declaration.slot, space.used.begin() + end, true);
+
+			space.slots.emplace(name, declaration.slot);
+		}
+	}
+
+	int SlotAllocator::allocate(Space& space, const std::string& name)
+	{
+		const auto it = space.slots.find(name);
+		if (it != space.slots.end())
+			return it->second;
+
+		const auto count = (size_t)std::max(space.counts[name], 1);
+		size_t slot = 0;
+		while (slot < space.used.size() && std::any_of(space.used.begin() + slot, space.used.begin() + std::min(slot + count, space.used.size()), [](bool used) { return used; }))
+			++slot;
+
+		if (space.used.size() < slot + count)
+			space.used.resize(slot + count);
+		std::fill(space.used.begin() + slot, space.used.begin() + slot + count, true);
+
+		space.slots.emplace(name, (int)slot);
+		return (int)slot;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <renderer/core/gpu_culling.hpp>
+#include <renderer/gl/deletion_queue.hpp>
+#include <renderer/gl/name_pool.hpp>
+
+using namespace gfx::core;
+using namespace gfx::gl;
+
+namespace
+{
+	// Tells ctest the test could not run
+	constexpr int SKIPPED = 77;
+
+	using DrawElementsIndirectCommand = IndirectBatch::DrawElementsIndirectCommand;
+
+	// Unit spheres, the first index tells the objects apart in the compacted commands
+	GpuCulling::Object object(const glm::vec3& position, uint32_t id)
+	{
+		return { glm::translate(glm::mat4(1.0f), position), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(1.0f), 36 + id, id * 100, (int32_t)id * 10 };
+	}
+
+	glm::mat4 viewProjection(const glm::vec3& direction)
+	{
+		const auto projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+		return projection * glm::lookAt(glm::vec3(0.0f), direction, glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	// Compares the survivors of the last cull with the objects expected to be visible, in any order
+	bool expectVisible(const GpuCulling& culling, const std::vector<GpuCulling::Object>& objects, std::vector<uint32_t> expected, const char* name)
+	{
+		bool passed = true;
+		const auto fail = [&](const auto&... message) {
+			std::cerr << name << ": ";
+			(std::cerr << ... << message) << '\n';
+			passed = false;
+		};
+
+		const auto count = culling.readVisibleCount();
+		if (count != expected.size())
+			fail("visible count is ", count, ", expected ", expected.size());
+
+		auto commands = culling.readCommands();
+		std::sort(commands.begin(), commands.end(), [](const auto& lhs, const auto& rhs) { return lhs.first_index < rhs.first_index; });
+		std::sort(expected.begin(), expected.end());
+
+		for (size_t i = 0; i < std::min(commands.size(), expected.size()); ++i)
+		{
+			const auto& command = commands[i];
+			const auto& source = objects[expected[i]];
+			if (command.count != source.count || command.instance_count != 1 || command.first_index != source.first_index || command.base_vertex != source.base_vertex || command.base_instance != 0)
+				fail("command ", i, " does not draw object ", expected[i]);
+		}
+
+		return passed;
+	}
+
+	bool run()
+	{
+		GpuCulling culling(16);
+		culling.setOcclusionCulling(false);
+
+		const std::vector<GpuCulling::Object> objects = {
+			object(glm::vec3(0.0f, 0.0f, -5.0f), 0),    // ahead
+			object(glm::vec3(-2.0f, 1.0f, -8.0f), 1),   // ahead, off center
+			object(glm::vec3(0.0f, 0.0f, 5.0f), 2),     // behind
+			object(glm::vec3(50.0f, 0.0f, -5.0f), 3),   // right of the frustum
+			object(glm::vec3(0.0f, 0.0f, -150.0f), 4),  // beyond the far plane
+			object(glm::vec3(3.2f, 0.0f, -5.0f), 5)     // center outside, sphere crossing the right plane
+		};
+		culling.setObjects(objects);
+
+		bool passed = true;
+
+		culling.cull(viewProjection(glm::vec3(0.0f, 0.0f, -1.0f)));
+		passed &= expectVisible(culling, objects, { 0, 1, 5 }, "looking ahead");
+
+		// The count restarts with every cull
+		culling.cull(viewProjection(glm::vec3(0.0f, 0.0f, 1.0f)));
+		passed &= expectVisible(culling, objects, { 2 }, "looking back");
+
+		culling.setObjects({});
+		culling.cull(viewProjection(glm::vec3(0.0f, 0.0f, -1.0f)));
+		passed &= expectVisible(culling, {}, {}, "no objects");
+
+		return passed;
+	}
+}
+
+int main()
+{
+	if (!glfwInit())
+	{
+		std::cerr << "GLFW is not available, skipping\n";
+		return SKIPPED;
+	}
+
+	// Never shown, it only carries the context
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	auto* window = glfwCreateWindow(64, 64, "gpu culling test", nullptr, nullptr);
+	if (window == nullptr)
+	{
+		std::cerr << "No OpenGL 4.6 context, skipping\n";
+		glfwTerminate();
+		return SKIPPED;
+	}
+
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cerr << "Unable to load OpenGL\n";
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return 1;
+	}
+
+	bool passed = false;
+	try
+	{
+		passed = run();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+	}
+
+	// GL objects go while the context is still alive
+	DeletionQueue::instance().flush();
+	NamePool::current().release();
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	return passed ? 0 : 1;
+}
\ No newline at end of file